@@ -46,6 +46,11 @@ class SSD1306:
         self.text = fb.text
         self.scroll = fb.scroll
         self.blit = fb.blit
+        # track changes in 16-column chunks of each 8-row page, so show() only
+        # needs to send the parts of the display RAM that have been drawn to
+        self.partial = hasattr(fb, 'track_dirty')
+        if self.partial:
+            fb.track_dirty(16, 8)
         self.init_display()
 
     def init_display(self):
@@ -88,9 +93,35 @@ class SSD1306:
     def invert(self, invert):
         self.write_cmd(SET_NORM_INV | (invert & 1))
 
+    def mark_dirty(self, x, y, w, h):
+        if self.partial:
+            self.framebuf.mark_dirty(x, y, w, h)
+
     def show(self):
-        x0 = 0
-        x1 = self.width - 1
+        """Send the parts of the buffer that changed since the last show().
+
+        Drawing methods record what they change, but writes to self.buffer
+        don't: call mark_dirty(x, y, w, h) after them.  If nothing at all is
+        marked, the whole buffer is sent.
+        """
+        if not self.partial:
+            self.show_window(0, 0, self.width, self.pages)
+            return
+        buf = memoryview(self.buffer)
+        sent = False
+        for x, y, w, h in self.framebuf.dirty():
+            # tiles are one page high, so each window is contiguous in buffer
+            page = y // 8
+            self.show_window(x, page, w, 1, buf[page * self.width + x:page * self.width + x + w])
+            sent = True
+        if not sent:
+            # the buffer may have been written to directly
+            self.show_window(0, 0, self.width, self.pages)
+        self.framebuf.clear_dirty()
+
+    def show_window(self, x, page, w, pages, data=None):
+        x0 = x
+        x1 = x + w - 1
         if self.width == 64:
             # displays with width of 64 pixels are shifted by 32
             x0 += 32
@@ -99,9 +130,9 @@ class SSD1306:
         self.write_cmd(x0)
         self.write_cmd(x1)
         self.write_cmd(SET_PAGE_ADDR)
-        self.write_cmd(0)
-        self.write_cmd(self.pages - 1)
-        self.write_data(self.buffer)
+        self.write_cmd(page)
+        self.write_cmd(page + pages - 1)
+        self.write_data(self.buffer if data is None else data)
 
 
 class SSD1306_I2C(SSD1306):
@@ -0,0 +1,222 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Paul Sokolovsky
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/stream.h"
+#include "extmod/btree_pagecache.h"
+
+#if MICROPY_PY_BTREE_PAGECACHE
+
+// The database's own cache (mpool) reads each page it misses with a separate
+// seek and read of the stream, which is slow for storage like SPI flash.  This
+// cache keeps recently used pages, pins pages chosen by the caller (internal
+// nodes of the tree) so lookups don't have to read them again, and when pages
+// are missed in sequence (as in a range scan) it reads the following pages
+// with the same stream read.
+
+#define SLOT_VALID (1)
+#define SLOT_PINNED (2)
+
+mp_btree_page_cache_t *mp_btree_page_cache_new(mp_obj_t stream, size_t n_slots, size_t readahead, bool (*pin)(const byte *page)) {
+    mp_btree_page_cache_t *c = m_new0(mp_btree_page_cache_t, 1);
+    c->stream = stream;
+    c->n_slots = n_slots;
+    c->readahead = readahead;
+    c->last_miss = (uint32_t)-2;
+    c->pin = pin;
+    c->slots = m_new0(mp_btree_page_cache_slot_t, n_slots);
+    return c;
+}
+
+// Start caching, once the page size is known
+void mp_btree_page_cache_start(mp_btree_page_cache_t *c, size_t psize) {
+    c->data = m_new(byte, c->n_slots * psize);
+    if (c->readahead > 1) {
+        c->readahead_buf = m_new(byte, c->readahead * psize);
+    }
+    c->psize = psize;
+}
+
+STATIC int page_cache_find(mp_btree_page_cache_t *c, uint32_t pgno) {
+    for (int i = 0; i < c->n_slots; i++) {
+        if ((c->slots[i].flags & SLOT_VALID) && c->slots[i].pgno == pgno) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Store a page that was read from the stream, evicting the least recently
+// used page that is not pinned if there's no free slot.
+STATIC void page_cache_insert(mp_btree_page_cache_t *c, uint32_t pgno, const byte *page) {
+    int slot = -1;
+    for (int i = 0; i < c->n_slots; i++) {
+        if (!(c->slots[i].flags & SLOT_VALID)) {
+            slot = i;
+            break;
+        }
+        if (!(c->slots[i].flags & SLOT_PINNED)
+            && (slot == -1 || c->slots[i].last_used < c->slots[slot].last_used)) {
+            slot = i;
+        }
+    }
+    if (slot == -1) {
+        // all pages are pinned, which is only possible with a single slot
+        return;
+    }
+    mp_btree_page_cache_slot_t *s = &c->slots[slot];
+    if (s->flags & SLOT_VALID) {
+        c->evictions++;
+    }
+    s->pgno = pgno;
+    s->last_used = ++c->clock;
+    s->flags = SLOT_VALID;
+    if (c->pin != NULL && c->n_pinned < c->n_slots / 2 && c->pin(page)) {
+        s->flags |= SLOT_PINNED;
+        c->n_pinned++;
+    }
+    memcpy(c->data + slot * c->psize, page, c->psize);
+}
+
+STATIC void page_cache_invalidate(mp_btree_page_cache_t *c, int slot) {
+    if (c->slots[slot].flags & SLOT_PINNED) {
+        c->n_pinned--;
+    }
+    c->slots[slot].flags = 0;
+}
+
+STATIC ssize_t page_cache_stream_read(mp_btree_page_cache_t *c, void *buf, size_t len) {
+    if (mp_stream_posix_lseek(c->stream, c->pos, SEEK_SET) == -1) {
+        return -1;
+    }
+    return mp_stream_posix_read(c->stream, buf, len);
+}
+
+ssize_t mp_btree_page_cache_read(void *cache, void *buf, size_t len) {
+    mp_btree_page_cache_t *c = cache;
+    if (c->psize == 0 || len != c->psize || c->pos % c->psize != 0) {
+        ssize_t ret = page_cache_stream_read(c, buf, len);
+        if (ret > 0) {
+            c->pos += ret;
+        }
+        return ret;
+    }
+
+    uint32_t pgno = c->pos / c->psize;
+    int slot = page_cache_find(c, pgno);
+    if (slot >= 0) {
+        c->hits++;
+        c->slots[slot].last_used = ++c->clock;
+        memcpy(buf, c->data + slot * c->psize, len);
+        c->pos += len;
+        return len;
+    }
+
+    c->misses++;
+    ssize_t ret;
+    if (c->readahead_buf != NULL && pgno == c->last_miss + 1) {
+        // a sequential read, so read the following pages at the same time
+        ret = page_cache_stream_read(c, c->readahead_buf, c->readahead * c->psize);
+        if (ret >= (ssize_t)len) {
+            memcpy(buf, c->readahead_buf, len);
+            size_t n_read = ret / c->psize;
+            for (size_t i = 0; i < n_read; i++) {
+                if (i == 0 || page_cache_find(c, pgno + i) < 0) {
+                    page_cache_insert(c, pgno + i, c->readahead_buf + i * c->psize);
+                }
+            }
+            // the next sequential miss is after the pages read ahead
+            pgno += n_read - 1;
+            ret = len;
+        } else if (ret > 0) {
+            memcpy(buf, c->readahead_buf, ret);
+        }
+    } else {
+        ret = page_cache_stream_read(c, buf, len);
+        if (ret == (ssize_t)len) {
+            page_cache_insert(c, pgno, buf);
+        }
+    }
+    c->last_miss = pgno;
+    if (ret > 0) {
+        c->pos += ret;
+    }
+    return ret;
+}
+
+ssize_t mp_btree_page_cache_write(void *cache, const void *buf, size_t len) {
+    mp_btree_page_cache_t *c = cache;
+    if (mp_stream_posix_lseek(c->stream, c->pos, SEEK_SET) == -1) {
+        return -1;
+    }
+    ssize_t ret = mp_stream_posix_write(c->stream, buf, len);
+    if (ret > 0 && c->psize != 0) {
+        // update the cached copies of the pages that were written
+        for (int i = 0; i < c->n_slots; i++) {
+            if (!(c->slots[i].flags & SLOT_VALID)) {
+                continue;
+            }
+            off_t start = (off_t)c->slots[i].pgno * c->psize;
+            if (start + (off_t)c->psize <= c->pos || start >= c->pos + ret) {
+                continue;
+            }
+            if (start == c->pos && ret == (ssize_t)c->psize) {
+                memcpy(c->data + i * c->psize, buf, c->psize);
+            } else {
+                page_cache_invalidate(c, i);
+            }
+        }
+    }
+    if (ret > 0) {
+        c->pos += ret;
+    }
+    return ret;
+}
+
+off_t mp_btree_page_cache_lseek(void *cache, off_t offset, int whence) {
+    mp_btree_page_cache_t *c = cache;
+    if (whence == SEEK_SET) {
+        c->pos = offset;
+    } else if (whence == SEEK_CUR) {
+        c->pos += offset;
+    } else {
+        off_t pos = mp_stream_posix_lseek(c->stream, offset, whence);
+        if (pos == -1) {
+            return -1;
+        }
+        c->pos = pos;
+    }
+    return c->pos;
+}
+
+int mp_btree_page_cache_fsync(void *cache) {
+    mp_btree_page_cache_t *c = cache;
+    return mp_stream_posix_fsync(c->stream);
+}
+
+#endif // MICROPY_PY_BTREE_PAGECACHE
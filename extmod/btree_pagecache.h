@@ -0,0 +1,73 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Paul Sokolovsky
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MICROPY_INCLUDED_EXTMOD_BTREE_PAGECACHE_H
+#define MICROPY_INCLUDED_EXTMOD_BTREE_PAGECACHE_H
+
+#include <sys/types.h>
+
+#include "py/obj.h"
+
+// A cache of fixed-size pages between a database and a stream.  It is used
+// through the read/write/lseek/fsync functions below, which have the same
+// signatures as the POSIX-like stream functions in py/stream.h, and so can
+// fill in a btree FILEVTABLE.  Reads of a whole aligned page are cached once
+// mp_btree_page_cache_start() has given the page size; all other I/O goes
+// straight to the stream.  Writes go through to the stream.
+
+typedef struct _mp_btree_page_cache_slot_t {
+    uint32_t pgno;
+    uint32_t last_used;
+    byte flags;
+} mp_btree_page_cache_slot_t;
+
+typedef struct _mp_btree_page_cache_t {
+    mp_obj_t stream;
+    off_t pos;
+    size_t psize;
+    uint16_t n_slots;
+    uint16_t n_pinned;
+    uint16_t readahead;
+    uint32_t last_miss;
+    uint32_t clock;
+    // returns true if a page should be kept in the cache (up to half of it)
+    bool (*pin)(const byte *page);
+    mp_btree_page_cache_slot_t *slots;
+    byte *data;
+    byte *readahead_buf;
+    mp_uint_t hits;
+    mp_uint_t misses;
+    mp_uint_t evictions;
+} mp_btree_page_cache_t;
+
+mp_btree_page_cache_t *mp_btree_page_cache_new(mp_obj_t stream, size_t n_slots, size_t readahead, bool (*pin)(const byte *page));
+void mp_btree_page_cache_start(mp_btree_page_cache_t *c, size_t psize);
+
+ssize_t mp_btree_page_cache_read(void *cache, void *buf, size_t len);
+ssize_t mp_btree_page_cache_write(void *cache, const void *buf, size_t len);
+off_t mp_btree_page_cache_lseek(void *cache, off_t offset, int whence);
+int mp_btree_page_cache_fsync(void *cache);
+
+#endif // MICROPY_INCLUDED_EXTMOD_BTREE_PAGECACHE_H
@@ -31,6 +31,9 @@
 
 #include "py/runtime.h"
 #include "py/stream.h"
+#include "py/mperrno.h"
+#include "py/objarray.h"
+#include "py/objlist.h"
 
 #if MICROPY_PY_BTREE
 
@@ -50,9 +53,31 @@ typedef struct _mp_obj_btree_t {
     #define FLAG_ITER_ITEMS  0xc0
     byte flags;
     byte next_flags;
+    // stream for the write-ahead log, or None
+    mp_obj_t wal;
+    // list of (key, value) operations of the current batch, a value of None
+    // means delete; MP_OBJ_NULL if no batch is active
+    mp_obj_t batch;
 } mp_obj_btree_t;
 
+// A cursor over a key range which copies keys and values into buffers that
+// it owns, and returns them as memoryviews which are reused by each step.
+typedef struct _mp_obj_btree_cursor_t {
+    mp_obj_base_t base;
+    mp_obj_btree_t *btree;
+    mp_obj_t start_key;
+    mp_obj_t end_key;
+    mp_obj_t prefix;
+    byte flags;
+    size_t key_alloc;
+    size_t val_alloc;
+    byte *key_buf;
+    byte *val_buf;
+    mp_obj_tuple_t *item;
+} mp_obj_btree_cursor_t;
+
 STATIC const mp_obj_type_t btree_type;
+STATIC const mp_obj_type_t btree_cursor_type;
 
 #define CHECK_ERROR(res) \
         if (res == RET_ERROR) { \
@@ -70,6 +95,8 @@ STATIC mp_obj_btree_t *btree_new(DB *db) {
     o->start_key = mp_const_none;
     o->end_key = mp_const_none;
     o->next_flags = 0;
+    o->wal = mp_const_none;
+    o->batch = MP_OBJ_NULL;
     return o;
 }
 
@@ -91,9 +118,282 @@ STATIC mp_obj_t btree_close(mp_obj_t self_in) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(btree_close_obj, btree_close);
 
+/******************************************************************************/
+// Batches and the write-ahead log
+
+// The log holds at most one batch: a header followed by the operations, each
+// of which is the key length, the value length (WAL_DELETE for a delete), the
+// key and the value.  The header is written after the operations, so it's only
+// valid once the whole batch is in the log, and it's cleared once the batch is
+// applied to the database and the database is synced.
+#define WAL_MAGIC (0x4c415742) // "BWAL" in little endian
+#define WAL_DELETE (0xffffffff)
+#define WAL_CHECKSUM_INIT (2166136261)
+
+typedef struct _btree_wal_header_t {
+    uint32_t magic;
+    uint32_t n_ops;
+    uint32_t len;
+    uint32_t checksum;
+} btree_wal_header_t;
+
+// 32-bit FNV-1a hash, to detect a torn write of the operations
+STATIC uint32_t btree_wal_checksum(uint32_t h, const void *buf, size_t len) {
+    const byte *b = buf;
+    while (len--) {
+        h = (h ^ *b++) * 16777619;
+    }
+    return h;
+}
+
+STATIC off_t btree_wal_seek_whence(mp_obj_t wal, off_t offset, int whence) {
+    off_t res = mp_stream_posix_lseek(wal, offset, whence);
+    if (res == -1) {
+        mp_raise_OSError(errno);
+    }
+    return res;
+}
+
+STATIC void btree_wal_seek(mp_obj_t wal, off_t offset) {
+    btree_wal_seek_whence(wal, offset, SEEK_SET);
+}
+
+STATIC void btree_wal_write(mp_obj_t wal, const void *buf, size_t len, uint32_t *checksum) {
+    int errcode;
+    mp_stream_write_exactly(wal, buf, len, &errcode);
+    if (errcode != 0) {
+        mp_raise_OSError(errcode);
+    }
+    if (checksum != NULL) {
+        *checksum = btree_wal_checksum(*checksum, buf, len);
+    }
+}
+
+STATIC void btree_wal_sync(mp_obj_t wal) {
+    if (mp_stream_posix_fsync(wal) == -1) {
+        mp_raise_OSError(errno);
+    }
+}
+
+STATIC void btree_wal_write_header(mp_obj_t wal, const btree_wal_header_t *hdr) {
+    btree_wal_seek(wal, 0);
+    btree_wal_write(wal, hdr, sizeof(*hdr), NULL);
+    btree_wal_sync(wal);
+}
+
+STATIC void btree_apply(DB *db, DBT *key, DBT *val) {
+    int res;
+    if (val == NULL) {
+        // deleting a key which doesn't exist is not an error in a batch
+        res = __bt_delete(db, key, 0);
+    } else {
+        res = __bt_put(db, key, val, 0);
+    }
+    CHECK_ERROR(res);
+}
+
+// Check that the operations in the log fill exactly len bytes, so that
+// applying them never reads past the end of the buffer.
+STATIC bool btree_wal_check_ops(const byte *p, const byte *end, uint32_t n_ops) {
+    for (uint32_t i = 0; i < n_ops; i++) {
+        uint32_t lens[2];
+        if ((size_t)(end - p) < sizeof(lens)) {
+            return false;
+        }
+        memcpy(lens, p, sizeof(lens));
+        p += sizeof(lens);
+        size_t val_len = lens[1] == WAL_DELETE ? 0 : lens[1];
+        if (lens[0] > (size_t)(end - p) || val_len > (size_t)(end - p) - lens[0]) {
+            return false;
+        }
+        p += lens[0] + val_len;
+    }
+    return p == end;
+}
+
+// Apply operations that were checked by btree_wal_check_ops.
+STATIC void btree_wal_apply_ops(DB *db, const byte *p, uint32_t n_ops) {
+    for (uint32_t i = 0; i < n_ops; i++) {
+        uint32_t lens[2];
+        memcpy(lens, p, sizeof(lens));
+        p += sizeof(lens);
+        DBT key, val;
+        key.data = (void*)p;
+        key.size = lens[0];
+        p += lens[0];
+        if (lens[1] == WAL_DELETE) {
+            btree_apply(db, &key, NULL);
+        } else {
+            val.data = (void*)p;
+            val.size = lens[1];
+            p += lens[1];
+            btree_apply(db, &key, &val);
+        }
+    }
+}
+
+// If the log holds a complete batch then apply it to the database, which is
+// needed if a commit was interrupted after the batch was written to the log.
+STATIC void btree_wal_recover(mp_obj_btree_t *self) {
+    btree_wal_header_t hdr;
+    int errcode;
+    btree_wal_seek(self->wal, 0);
+    if (mp_stream_read_exactly(self->wal, &hdr, sizeof(hdr), &errcode) != sizeof(hdr)
+        || hdr.magic != WAL_MAGIC) {
+        return;
+    }
+    // the header is only written after the operations were synced, so if it
+    // claims more of them than the log holds then the log is corrupt (and the
+    // length mustn't be trusted to allocate the buffer)
+    off_t wal_size = btree_wal_seek_whence(self->wal, 0, SEEK_END);
+    if ((uint64_t)hdr.len > (uint64_t)wal_size - sizeof(hdr)) {
+        mp_raise_OSError(MP_EIO);
+    }
+    btree_wal_seek(self->wal, sizeof(hdr));
+    byte *buf = m_new(byte, hdr.len);
+    if (mp_stream_read_exactly(self->wal, buf, hdr.len, &errcode) != hdr.len
+        || btree_wal_checksum(WAL_CHECKSUM_INIT, buf, hdr.len) != hdr.checksum
+        || !btree_wal_check_ops(buf, buf + hdr.len, hdr.n_ops)) {
+        m_del(byte, buf, hdr.len);
+        mp_raise_OSError(MP_EIO);
+    }
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        btree_wal_apply_ops(self->db, buf, hdr.n_ops);
+        nlr_pop();
+    } else {
+        m_del(byte, buf, hdr.len);
+        nlr_jump(nlr.ret_val);
+    }
+    m_del(byte, buf, hdr.len);
+    CHECK_ERROR(__bt_sync(self->db, 0));
+    memset(&hdr, 0, sizeof(hdr));
+    btree_wal_write_header(self->wal, &hdr);
+}
+
+STATIC void btree_batch_add(mp_obj_btree_t *self, mp_obj_t key, mp_obj_t value) {
+    // check the types now, rather than when the batch is committed
+    size_t len;
+    mp_obj_str_get_data(key, &len);
+    if (value != mp_const_none) {
+        mp_obj_str_get_data(value, &len);
+    }
+    mp_obj_t op[2] = {key, value};
+    mp_obj_list_append(self->batch, mp_obj_new_tuple(2, op));
+}
+
+// Look up a key, seeing the stores and deletes queued in an active batch
+// (the latest one for the key wins).  Returns RET_SPECIAL if it's not found.
+STATIC int btree_lookup(mp_obj_btree_t *self, mp_obj_t key_in, DBT *val) {
+    DBT key;
+    key.data = (void*)mp_obj_str_get_data(key_in, &key.size);
+    if (self->batch != MP_OBJ_NULL) {
+        mp_obj_list_t *batch = MP_OBJ_TO_PTR(self->batch);
+        for (size_t i = batch->len; i > 0; i--) {
+            mp_obj_t *op = ((mp_obj_tuple_t*)MP_OBJ_TO_PTR(batch->items[i - 1]))->items;
+            size_t len;
+            const char *data = mp_obj_str_get_data(op[0], &len);
+            if (len == key.size && memcmp(data, key.data, len) == 0) {
+                if (op[1] == mp_const_none) {
+                    return RET_SPECIAL;
+                }
+                val->data = (void*)mp_obj_str_get_data(op[1], &val->size);
+                return RET_SUCCESS;
+            }
+        }
+    }
+    return __bt_get(self->db, &key, val, 0);
+}
+
+// Scans read the database directly, so they'd miss the queued changes
+STATIC void btree_check_no_batch(mp_obj_btree_t *self) {
+    if (self->batch != MP_OBJ_NULL) {
+        mp_raise_ValueError("can't scan during a batch");
+    }
+}
+
+STATIC void btree_batch_commit(mp_obj_btree_t *self) {
+    mp_obj_list_t *batch = MP_OBJ_TO_PTR(self->batch);
+    self->batch = MP_OBJ_NULL;
+
+    if (self->wal != mp_const_none) {
+        // write the operations, then the header which makes them valid
+        // the header in the log is not valid, so it's left as it is for now
+        btree_wal_header_t hdr = {0, batch->len, 0, WAL_CHECKSUM_INIT};
+        btree_wal_seek(self->wal, sizeof(hdr));
+        for (size_t i = 0; i < batch->len; i++) {
+            mp_obj_t *op = ((mp_obj_tuple_t*)MP_OBJ_TO_PTR(batch->items[i]))->items;
+            size_t key_len, val_len = 0;
+            const char *key = mp_obj_str_get_data(op[0], &key_len);
+            const char *val = NULL;
+            uint32_t lens[2] = {key_len, WAL_DELETE};
+            if (op[1] != mp_const_none) {
+                val = mp_obj_str_get_data(op[1], &val_len);
+                lens[1] = val_len;
+            }
+            btree_wal_write(self->wal, lens, sizeof(lens), &hdr.checksum);
+            btree_wal_write(self->wal, key, key_len, &hdr.checksum);
+            btree_wal_write(self->wal, val, val_len, &hdr.checksum);
+            hdr.len += sizeof(lens) + key_len + val_len;
+        }
+        btree_wal_sync(self->wal);
+        hdr.magic = WAL_MAGIC;
+        btree_wal_write_header(self->wal, &hdr);
+    }
+
+    for (size_t i = 0; i < batch->len; i++) {
+        mp_obj_t *op = ((mp_obj_tuple_t*)MP_OBJ_TO_PTR(batch->items[i]))->items;
+        DBT key, val;
+        key.data = (void*)mp_obj_str_get_data(op[0], &key.size);
+        if (op[1] == mp_const_none) {
+            btree_apply(self->db, &key, NULL);
+        } else {
+            val.data = (void*)mp_obj_str_get_data(op[1], &val.size);
+            btree_apply(self->db, &key, &val);
+        }
+    }
+    CHECK_ERROR(__bt_sync(self->db, 0));
+
+    if (self->wal != mp_const_none) {
+        btree_wal_header_t hdr = {0};
+        btree_wal_write_header(self->wal, &hdr);
+    }
+}
+
+// Start a batch: stores and deletes are queued until the end of the with
+// block, then applied together with a single sync of the database.
+STATIC mp_obj_t btree_batch(mp_obj_t self_in) {
+    mp_obj_btree_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->batch != MP_OBJ_NULL) {
+        mp_raise_ValueError("batch already active");
+    }
+    self->batch = mp_obj_new_list(0, NULL);
+    return self_in;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(btree_batch_obj, btree_batch);
+
+STATIC mp_obj_t btree___exit__(size_t n_args, const mp_obj_t *args) {
+    (void)n_args;
+    mp_obj_btree_t *self = MP_OBJ_TO_PTR(args[0]);
+    if (self->batch != MP_OBJ_NULL) {
+        if (args[1] == mp_const_none) {
+            btree_batch_commit(self);
+        } else {
+            // an exception was raised in the with block, discard the batch
+            self->batch = MP_OBJ_NULL;
+        }
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(btree___exit___obj, 4, 4, btree___exit__);
+
 STATIC mp_obj_t btree_put(size_t n_args, const mp_obj_t *args) {
     (void)n_args;
     mp_obj_btree_t *self = MP_OBJ_TO_PTR(args[0]);
+    if (self->batch != MP_OBJ_NULL) {
+        btree_batch_add(self, args[1], args[2]);
+        return MP_OBJ_NEW_SMALL_INT(RET_SUCCESS);
+    }
     DBT key, val;
     key.data = (void*)mp_obj_str_get_data(args[1], &key.size);
     val.data = (void*)mp_obj_str_get_data(args[2], &val.size);
@@ -103,9 +403,8 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(btree_put_obj, 3, 4, btree_put);
 
 STATIC mp_obj_t btree_get(size_t n_args, const mp_obj_t *args) {
     mp_obj_btree_t *self = MP_OBJ_TO_PTR(args[0]);
-    DBT key, val;
-    key.data = (void*)mp_obj_str_get_data(args[1], &key.size);
-    int res = __bt_get(self->db, &key, &val, 0);
+    DBT val;
+    int res = btree_lookup(self, args[1], &val);
     if (res == RET_SPECIAL) {
         if (n_args > 2) {
             return args[2];
@@ -118,8 +417,27 @@ STATIC mp_obj_t btree_get(size_t n_args, const mp_obj_t *args) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(btree_get_obj, 2, 3, btree_get);
 
+// Copy the value into a writable buffer instead of allocating a bytes object.
+// Returns the full length of the value, which is larger than the buffer if
+// the value was truncated, or None if the key is not found.
+STATIC mp_obj_t btree_get_into(mp_obj_t self_in, mp_obj_t key_in, mp_obj_t buf_in) {
+    mp_obj_btree_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+    DBT val;
+    int res = btree_lookup(self, key_in, &val);
+    if (res == RET_SPECIAL) {
+        return mp_const_none;
+    }
+    CHECK_ERROR(res);
+    memcpy(bufinfo.buf, val.data, MIN(val.size, bufinfo.len));
+    return MP_OBJ_NEW_SMALL_INT(val.size);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_3(btree_get_into_obj, btree_get_into);
+
 STATIC mp_obj_t btree_seq(size_t n_args, const mp_obj_t *args) {
     mp_obj_btree_t *self = MP_OBJ_TO_PTR(args[0]);
+    btree_check_no_batch(self);
     int flags = MP_OBJ_SMALL_INT_VALUE(args[1]);
     DBT key, val;
     if (n_args > 2) {
@@ -190,47 +508,59 @@ STATIC mp_obj_t btree_getiter(mp_obj_t self_in, mp_obj_iter_buf_t *iter_buf) {
     return self_in;
 }
 
-STATIC mp_obj_t btree_iternext(mp_obj_t self_in) {
-    mp_obj_btree_t *self = MP_OBJ_TO_PTR(self_in);
-    DBT key, val;
+// Step through a key range: the first call positions the cursor at
+// *start_key (and sets it to MP_OBJ_NULL), subsequent calls move to the next
+// key.  Returns false at the end of the range.
+STATIC bool btree_range_next(DB *db, mp_obj_t *start_key, mp_obj_t *end_key, byte flags, DBT *key, DBT *val) {
     int res;
-    bool desc = self->flags & FLAG_DESC;
-    if (self->start_key != MP_OBJ_NULL) {
-        int flags = R_FIRST;
-        if (self->start_key != mp_const_none) {
-            key.data = (void*)mp_obj_str_get_data(self->start_key, &key.size);
-            flags = R_CURSOR;
+    bool desc = flags & FLAG_DESC;
+    if (*start_key != MP_OBJ_NULL) {
+        int seq_flags = R_FIRST;
+        if (*start_key != mp_const_none) {
+            key->data = (void*)mp_obj_str_get_data(*start_key, &key->size);
+            seq_flags = R_CURSOR;
         } else if (desc) {
-            flags = R_LAST;
+            seq_flags = R_LAST;
         }
-        res = __bt_seq(self->db, &key, &val, flags);
-        self->start_key = MP_OBJ_NULL;
+        res = __bt_seq(db, key, val, seq_flags);
+        *start_key = MP_OBJ_NULL;
     } else {
-        res = __bt_seq(self->db, &key, &val, desc ? R_PREV : R_NEXT);
+        res = __bt_seq(db, key, val, desc ? R_PREV : R_NEXT);
     }
 
     if (res == RET_SPECIAL) {
-        return MP_OBJ_STOP_ITERATION;
+        return false;
     }
     CHECK_ERROR(res);
 
-    if (self->end_key != mp_const_none) {
-        DBT end_key;
-        end_key.data = (void*)mp_obj_str_get_data(self->end_key, &end_key.size);
-        BTREE *t = self->db->internal;
-        int cmp = t->bt_cmp(&key, &end_key);
+    if (*end_key != mp_const_none) {
+        DBT end;
+        end.data = (void*)mp_obj_str_get_data(*end_key, &end.size);
+        BTREE *t = db->internal;
+        int cmp = t->bt_cmp(key, &end);
         if (desc) {
             cmp = -cmp;
         }
-        if (self->flags & FLAG_END_KEY_INCL) {
+        if (flags & FLAG_END_KEY_INCL) {
             cmp--;
         }
         if (cmp >= 0) {
-            self->end_key = MP_OBJ_NULL;
-            return MP_OBJ_STOP_ITERATION;
+            *end_key = MP_OBJ_NULL;
+            return false;
         }
     }
 
+    return true;
+}
+
+STATIC mp_obj_t btree_iternext(mp_obj_t self_in) {
+    mp_obj_btree_t *self = MP_OBJ_TO_PTR(self_in);
+    btree_check_no_batch(self);
+    DBT key, val;
+    if (!btree_range_next(self->db, &self->start_key, &self->end_key, self->flags, &key, &val)) {
+        return MP_OBJ_STOP_ITERATION;
+    }
+
     switch (self->flags & FLAG_ITER_TYPE_MASK) {
         case FLAG_ITER_KEYS:
             return mp_obj_new_bytes(key.data, key.size);
@@ -248,7 +578,11 @@ STATIC mp_obj_t btree_iternext(mp_obj_t self_in) {
 
 STATIC mp_obj_t btree_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
     mp_obj_btree_t *self = MP_OBJ_TO_PTR(self_in);
-    if (value == MP_OBJ_NULL) {
+    if (self->batch != MP_OBJ_NULL && value != MP_OBJ_SENTINEL) {
+        // store or delete as part of a batch
+        btree_batch_add(self, index, value == MP_OBJ_NULL ? mp_const_none : value);
+        return mp_const_none;
+    } else if (value == MP_OBJ_NULL) {
         // delete
         DBT key;
         key.data = (void*)mp_obj_str_get_data(index, &key.size);
@@ -260,9 +594,8 @@ STATIC mp_obj_t btree_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
         return mp_const_none;
     } else if (value == MP_OBJ_SENTINEL) {
         // load
-        DBT key, val;
-        key.data = (void*)mp_obj_str_get_data(index, &key.size);
-        int res = __bt_get(self->db, &key, &val, 0);
+        DBT val;
+        int res = btree_lookup(self, index, &val);
         if (res == RET_SPECIAL) {
             nlr_raise(mp_obj_new_exception(&mp_type_KeyError));
         }
@@ -283,9 +616,8 @@ STATIC mp_obj_t btree_binary_op(mp_binary_op_t op, mp_obj_t lhs_in, mp_obj_t rhs
     mp_obj_btree_t *self = MP_OBJ_TO_PTR(lhs_in);
     switch (op) {
         case MP_BINARY_OP_IN: {
-            DBT key, val;
-            key.data = (void*)mp_obj_str_get_data(rhs_in, &key.size);
-            int res = __bt_get(self->db, &key, &val, 0);
+            DBT val;
+            int res = btree_lookup(self, rhs_in, &val);
             CHECK_ERROR(res);
             return mp_obj_new_bool(res != RET_SPECIAL);
         }
@@ -295,15 +627,103 @@ STATIC mp_obj_t btree_binary_op(mp_binary_op_t op, mp_obj_t lhs_in, mp_obj_t rhs
     }
 }
 
+/******************************************************************************/
+// Cursors
+
+STATIC mp_obj_t btree_cursor(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_start_key, ARG_end_key, ARG_flags, ARG_prefix };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_start_key, MP_ARG_OBJ, {.u_rom_obj = MP_ROM_PTR(&mp_const_none_obj)} },
+        { MP_QSTR_end_key, MP_ARG_OBJ, {.u_rom_obj = MP_ROM_PTR(&mp_const_none_obj)} },
+        { MP_QSTR_flags, MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_prefix, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_PTR(&mp_const_none_obj)} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_obj_btree_cursor_t *o = m_new_obj(mp_obj_btree_cursor_t);
+    o->base.type = &btree_cursor_type;
+    o->btree = MP_OBJ_TO_PTR(pos_args[0]);
+    o->start_key = args[ARG_start_key].u_obj;
+    o->end_key = args[ARG_end_key].u_obj;
+    o->prefix = args[ARG_prefix].u_obj;
+    o->flags = args[ARG_flags].u_int;
+    if (o->prefix != mp_const_none) {
+        // scan forwards from the prefix until a key doesn't start with it
+        if (o->start_key != mp_const_none || (o->flags & FLAG_DESC)) {
+            mp_raise_ValueError(NULL);
+        }
+        o->start_key = o->prefix;
+    }
+    o->key_alloc = 0;
+    o->val_alloc = 0;
+    o->key_buf = NULL;
+    o->val_buf = NULL;
+    mp_obj_t item[2] = {
+        mp_obj_new_memoryview('B', 0, NULL),
+        mp_obj_new_memoryview('B', 0, NULL),
+    };
+    o->item = MP_OBJ_TO_PTR(mp_obj_new_tuple(2, item));
+    return MP_OBJ_FROM_PTR(o);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(btree_cursor_obj, 1, btree_cursor);
+
+// Copy data into the buffer and point the memoryview at it, growing the
+// buffer if needed (it never shrinks, so a scan settles into no allocation).
+STATIC void btree_cursor_set(mp_obj_t mv_in, byte **buf, size_t *alloc, const DBT *data) {
+    if (data->size > *alloc) {
+        *buf = m_renew(byte, *buf, *alloc, data->size);
+        *alloc = data->size;
+    }
+    memcpy(*buf, data->data, data->size);
+    mp_obj_array_t *mv = MP_OBJ_TO_PTR(mv_in);
+    mv->items = *buf;
+    mv->len = data->size;
+}
+
+STATIC mp_obj_t btree_cursor_iternext(mp_obj_t self_in) {
+    mp_obj_btree_cursor_t *self = MP_OBJ_TO_PTR(self_in);
+    btree_check_no_batch(self->btree);
+    DBT key, val;
+    if (self->end_key == MP_OBJ_NULL
+        || !btree_range_next(self->btree->db, &self->start_key, &self->end_key, self->flags, &key, &val)) {
+        self->end_key = MP_OBJ_NULL;
+        return MP_OBJ_STOP_ITERATION;
+    }
+    if (self->prefix != mp_const_none) {
+        size_t len;
+        const char *prefix = mp_obj_str_get_data(self->prefix, &len);
+        if (key.size < len || memcmp(key.data, prefix, len) != 0) {
+            self->end_key = MP_OBJ_NULL;
+            return MP_OBJ_STOP_ITERATION;
+        }
+    }
+    btree_cursor_set(self->item->items[0], &self->key_buf, &self->key_alloc, &key);
+    btree_cursor_set(self->item->items[1], &self->val_buf, &self->val_alloc, &val);
+    return MP_OBJ_FROM_PTR(self->item);
+}
+
+STATIC const mp_obj_type_t btree_cursor_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_cursor,
+    .getiter = mp_identity_getiter,
+    .iternext = btree_cursor_iternext,
+};
+
 STATIC const mp_rom_map_elem_t btree_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&btree_close_obj) },
     { MP_ROM_QSTR(MP_QSTR_flush), MP_ROM_PTR(&btree_flush_obj) },
     { MP_ROM_QSTR(MP_QSTR_get), MP_ROM_PTR(&btree_get_obj) },
+    { MP_ROM_QSTR(MP_QSTR_get_into), MP_ROM_PTR(&btree_get_into_obj) },
     { MP_ROM_QSTR(MP_QSTR_put), MP_ROM_PTR(&btree_put_obj) },
     { MP_ROM_QSTR(MP_QSTR_seq), MP_ROM_PTR(&btree_seq_obj) },
     { MP_ROM_QSTR(MP_QSTR_keys), MP_ROM_PTR(&btree_keys_obj) },
     { MP_ROM_QSTR(MP_QSTR_values), MP_ROM_PTR(&btree_values_obj) },
     { MP_ROM_QSTR(MP_QSTR_items), MP_ROM_PTR(&btree_items_obj) },
+    { MP_ROM_QSTR(MP_QSTR_cursor), MP_ROM_PTR(&btree_cursor_obj) },
+    { MP_ROM_QSTR(MP_QSTR_batch), MP_ROM_PTR(&btree_batch_obj) },
+    { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&mp_identity_obj) },
+    { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&btree___exit___obj) },
 };
 
 STATIC MP_DEFINE_CONST_DICT(btree_locals_dict, btree_locals_dict_table);
@@ -333,6 +753,7 @@ STATIC mp_obj_t mod_btree_open(size_t n_args, const mp_obj_t *pos_args, mp_map_t
         { MP_QSTR_cachesize, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
         { MP_QSTR_pagesize, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
         { MP_QSTR_minkeypage, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_wal, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_PTR(&mp_const_none_obj)} },
     };
 
     // Make sure we got a stream object
@@ -343,6 +764,7 @@ STATIC mp_obj_t mod_btree_open(size_t n_args, const mp_obj_t *pos_args, mp_map_t
         mp_arg_val_t cachesize;
         mp_arg_val_t pagesize;
         mp_arg_val_t minkeypage;
+        mp_arg_val_t wal;
     } args;
     mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args,
         MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t*)&args);
@@ -352,11 +774,20 @@ STATIC mp_obj_t mod_btree_open(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     openinfo.psize = args.pagesize.u_int;
     openinfo.minkeypage = args.minkeypage.u_int;
 
+    if (args.wal.u_obj != mp_const_none) {
+        mp_get_stream_raise(args.wal.u_obj, MP_STREAM_OP_READ | MP_STREAM_OP_WRITE | MP_STREAM_OP_IOCTL);
+    }
+
     DB *db = __bt_open(pos_args[0], &btree_stream_fvtable, &openinfo, /*dflags*/0);
     if (db == NULL) {
         mp_raise_OSError(errno);
     }
-    return MP_OBJ_FROM_PTR(btree_new(db));
+    mp_obj_btree_t *o = btree_new(db);
+    o->wal = args.wal.u_obj;
+    if (o->wal != mp_const_none) {
+        btree_wal_recover(o);
+    }
+    return MP_OBJ_FROM_PTR(o);
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(mod_btree_open_obj, 1, mod_btree_open);
 
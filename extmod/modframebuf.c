@@ -39,16 +39,28 @@ typedef struct _mp_obj_framebuf_t {
     void *buf;
     uint16_t width, height, stride;
     uint8_t format;
+    #if MICROPY_PY_FRAMEBUF_DIRTY
+    uint16_t tile_w, tile_h, tiles_x, tiles_y;
+    uint8_t *dirty; // bitmap of tiles that have been drawn to, or NULL if not tracking
+    #endif
 } mp_obj_framebuf_t;
 
 typedef void (*setpixel_t)(const mp_obj_framebuf_t*, int, int, uint32_t);
 typedef uint32_t (*getpixel_t)(const mp_obj_framebuf_t*, int, int);
 typedef void (*fill_rect_t)(const mp_obj_framebuf_t *, int, int, int, int, uint32_t);
+typedef void (*get_span_t)(const mp_obj_framebuf_t*, int, int, int, uint32_t*);
+typedef void (*set_span_t)(const mp_obj_framebuf_t*, int, int, int, const uint32_t*, uint32_t);
 
+// get_span reads n pixels starting at x,y into an array, and set_span writes
+// n pixels from an array, skipping those equal to key; these are used for
+// blits that can't be done by copying bytes, so only one indirect call is
+// needed for a span of pixels rather than two per pixel
 typedef struct _mp_framebuf_p_t {
     setpixel_t setpixel;
     getpixel_t getpixel;
     fill_rect_t fill_rect;
+    get_span_t get_span;
+    set_span_t set_span;
 } mp_framebuf_p_t;
 
 // constants for formats
@@ -58,6 +70,33 @@ typedef struct _mp_framebuf_p_t {
 #define FRAMEBUF_MHLSB    (3)
 #define FRAMEBUF_MHMSB    (4)
 
+#if MICROPY_PY_FRAMEBUF_DIRTY
+
+// Mark the tiles covering the given rectangle as dirty, clipping it first
+STATIC void mark_dirty(const mp_obj_framebuf_t *fb, int x, int y, int w, int h) {
+    int xend = MIN(fb->width, x + w);
+    int yend = MIN(fb->height, y + h);
+    x = MAX(x, 0);
+    y = MAX(y, 0);
+    if (x >= xend || y >= yend) {
+        return;
+    }
+    int tx0 = x / fb->tile_w, tx1 = (xend - 1) / fb->tile_w;
+    for (int ty = y / fb->tile_h; ty <= (yend - 1) / fb->tile_h; ++ty) {
+        for (int i = ty * fb->tiles_x + tx0, iend = ty * fb->tiles_x + tx1; i <= iend; ++i) {
+            fb->dirty[i >> 3] |= 1 << (i & 7);
+        }
+    }
+}
+
+#define MARK_DIRTY(fb, x, y, w, h) do { if ((fb)->dirty != NULL) { mark_dirty((fb), (x), (y), (w), (h)); } } while (0)
+
+#else
+
+#define MARK_DIRTY(fb, x, y, w, h) (void)0
+
+#endif
+
 // Functions for MHLSB and MHMSB
 
 STATIC void mono_horiz_setpixel(const mp_obj_framebuf_t *fb, int x, int y, uint32_t col) {
@@ -72,17 +111,118 @@ STATIC uint32_t mono_horiz_getpixel(const mp_obj_framebuf_t *fb, int x, int y) {
     return (((uint8_t*)fb->buf)[index] >> (offset)) & 0x01;
 }
 
+// Mask of the bits holding pixels [a, b) of a byte that packs 8 / bpp pixels,
+// with the first pixel in either the least or most significant bits
+STATIC uint8_t packed_pixel_mask(int a, int b, int bpp, bool lsb_first) {
+    if (lsb_first) {
+        return ((1 << (b * bpp)) - 1) & ~((1 << (a * bpp)) - 1);
+    } else {
+        return (0xff >> (a * bpp)) & ~(0xff >> (b * bpp));
+    }
+}
+
+// Fill w pixels of a row of a horizontally packed format, starting at pixel
+// p0 of the byte at b, with the byte value fill (col repeated for each pixel)
+STATIC void packed_fill_row(uint8_t *b, int p0, int w, int bpp, bool lsb_first, uint8_t fill) {
+    int ppb = 8 / bpp;
+    if (p0 + w <= ppb) {
+        uint8_t mask = packed_pixel_mask(p0, p0 + w, bpp, lsb_first);
+        *b = (*b & ~mask) | (fill & mask);
+        return;
+    }
+    if (p0) {
+        uint8_t mask = packed_pixel_mask(p0, ppb, bpp, lsb_first);
+        *b = (*b & ~mask) | (fill & mask);
+        b++;
+        w -= ppb - p0;
+    }
+    memset(b, fill, w / ppb);
+    b += w / ppb;
+    w %= ppb;
+    if (w) {
+        uint8_t mask = packed_pixel_mask(0, w, bpp, lsb_first);
+        *b = (*b & ~mask) | (fill & mask);
+    }
+}
+
+// Copy w pixels of a row of a horizontally packed format, from the byte at s
+// to the byte at d, both starting at pixel p0 of their byte; rows may overlap
+STATIC void packed_copy_row(uint8_t *d, const uint8_t *s, int p0, int w, int bpp, bool lsb_first) {
+    int ppb = 8 / bpp;
+    if (p0 + w <= ppb) {
+        uint8_t mask = packed_pixel_mask(p0, p0 + w, bpp, lsb_first);
+        *d = (*d & ~mask) | (*s & mask);
+        return;
+    }
+    // read the partial bytes at each end first, in case memmove overwrites them
+    uint8_t lead_mask = 0, lead = 0, tail_mask = 0, tail = 0;
+    int off = 0;
+    if (p0) {
+        lead_mask = packed_pixel_mask(p0, ppb, bpp, lsb_first);
+        lead = *s;
+        off = 1;
+        w -= ppb - p0;
+    }
+    int n = w / ppb;
+    if (w % ppb) {
+        tail_mask = packed_pixel_mask(0, w % ppb, bpp, lsb_first);
+        tail = s[off + n];
+    }
+    memmove(d + off, s + off, n);
+    if (lead_mask) {
+        *d = (*d & ~lead_mask) | (lead & lead_mask);
+    }
+    if (tail_mask) {
+        d[off + n] = (d[off + n] & ~tail_mask) | (tail & tail_mask);
+    }
+}
+
 STATIC void mono_horiz_fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w, int h, uint32_t col) {
-    int reverse = fb->format == FRAMEBUF_MHMSB;
+    bool lsb_first = fb->format == FRAMEBUF_MHMSB;
     int advance = fb->stride >> 3;
-    while (w--) {
-        uint8_t *b = &((uint8_t*)fb->buf)[(x >> 3) + y * advance];
-        int offset = reverse ?  x & 7 : 7 - (x & 7);
-        for (int hh = h; hh; --hh) {
-            *b = (*b & ~(0x01 << offset)) | ((col != 0) << offset);
-            b += advance;
+    uint8_t *b = &((uint8_t*)fb->buf)[(x >> 3) + y * advance];
+    uint8_t fill = col ? 0xff : 0;
+    while (h--) {
+        packed_fill_row(b, x & 7, w, 1, lsb_first, fill);
+        b += advance;
+    }
+}
+
+STATIC void mono_horiz_get_span(const mp_obj_framebuf_t *fb, int x, int y, int n, uint32_t *out) {
+    const uint8_t *b = &((uint8_t*)fb->buf)[(x + y * fb->stride) >> 3];
+    bool lsb_first = fb->format == FRAMEBUF_MHMSB;
+    int bit = x & 7;
+    uint32_t v = *b;
+    while (n--) {
+        *out++ = (v >> (lsb_first ? bit : 7 - bit)) & 1;
+        if (++bit == 8 && n) {
+            bit = 0;
+            v = *++b;
         }
-        ++x;
+    }
+}
+
+STATIC void mono_horiz_set_span(const mp_obj_framebuf_t *fb, int x, int y, int n, const uint32_t *in, uint32_t key) {
+    uint8_t *b = &((uint8_t*)fb->buf)[(x + y * fb->stride) >> 3];
+    bool lsb_first = fb->format == FRAMEBUF_MHMSB;
+    int bit = x & 7;
+    uint32_t v = *b;
+    while (n--) {
+        uint32_t col = *in++;
+        if (col != key) {
+            uint8_t mask = lsb_first ? 1 << bit : 0x80 >> bit;
+            v = col ? (v | mask) : (v & ~mask);
+        }
+        if (++bit == 8) {
+            *b++ = v;
+            bit = 0;
+            if (n) {
+                v = *b;
+            }
+        }
+    }
+    if (bit) {
+        *b = v;
     }
 }
 
@@ -99,14 +239,40 @@ STATIC uint32_t mvlsb_getpixel(const mp_obj_framebuf_t *fb, int x, int y) {
 }
 
 STATIC void mvlsb_fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w, int h, uint32_t col) {
-    while (h--) {
+    // work on a row of 8-pixel-high pages at a time
+    uint8_t fill = col ? 0xff : 0;
+    for (int yend = y + h; y < yend;) {
+        int n = MIN(8 - (y & 7), yend - y);
         uint8_t *b = &((uint8_t*)fb->buf)[(y >> 3) * fb->stride + x];
-        uint8_t offset = y & 0x07;
-        for (int ww = w; ww; --ww) {
-            *b = (*b & ~(0x01 << offset)) | ((col != 0) << offset);
-            ++b;
+        uint8_t mask = ((1 << n) - 1) << (y & 7);
+        if (mask == 0xff) {
+            memset(b, fill, w);
+        } else {
+            for (int ww = w; ww; --ww) {
+                *b = (*b & ~mask) | (fill & mask);
+                ++b;
+            }
+        }
+        y += n;
+    }
+}
+
+STATIC void mvlsb_get_span(const mp_obj_framebuf_t *fb, int x, int y, int n, uint32_t *out) {
+    const uint8_t *b = &((uint8_t*)fb->buf)[(y >> 3) * fb->stride + x];
+    uint8_t offset = y & 0x07;
+    while (n--) {
+        *out++ = (*b++ >> offset) & 1;
+    }
+}
+
+STATIC void mvlsb_set_span(const mp_obj_framebuf_t *fb, int x, int y, int n, const uint32_t *in, uint32_t key) {
+    uint8_t *b = &((uint8_t*)fb->buf)[(y >> 3) * fb->stride + x];
+    uint8_t mask = 1 << (y & 0x07);
+    for (; n--; ++b) {
+        uint32_t col = *in++;
+        if (col != key) {
+            *b = col ? (*b | mask) : (*b & ~mask);
         }
-        ++y;
     }
 }
 
@@ -130,6 +296,23 @@ STATIC void rgb565_fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w, i
     }
 }
 
+STATIC void rgb565_get_span(const mp_obj_framebuf_t *fb, int x, int y, int n, uint32_t *out) {
+    const uint16_t *b = &((uint16_t*)fb->buf)[x + y * fb->stride];
+    while (n--) {
+        *out++ = *b++;
+    }
+}
+
+STATIC void rgb565_set_span(const mp_obj_framebuf_t *fb, int x, int y, int n, const uint32_t *in, uint32_t key) {
+    uint16_t *b = &((uint16_t*)fb->buf)[x + y * fb->stride];
+    for (; n--; ++b) {
+        uint32_t col = *in++;
+        if (col != key) {
+            *b = col;
+        }
+    }
+}
+
 // Functions for GS4_HMSB format
 
 STATIC void gs4_hmsb_setpixel(const mp_obj_framebuf_t *fb, int x, int y, uint32_t col) {
@@ -181,15 +364,49 @@ STATIC void gs4_hmsb_fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w,
     }
 }
 
+STATIC void gs4_hmsb_get_span(const mp_obj_framebuf_t *fb, int x, int y, int n, uint32_t *out) {
+    const uint8_t *b = &((uint8_t*)fb->buf)[(x + y * fb->stride) >> 1];
+    if (x & 1 && n) {
+        *out++ = *b++ & 0x0f;
+        n--;
+    }
+    for (; n >= 2; n -= 2) {
+        uint8_t v = *b++;
+        *out++ = v >> 4;
+        *out++ = v & 0x0f;
+    }
+    if (n) {
+        *out = *b >> 4;
+    }
+}
+
+STATIC void gs4_hmsb_set_span(const mp_obj_framebuf_t *fb, int x, int y, int n, const uint32_t *in, uint32_t key) {
+    uint8_t *b = &((uint8_t*)fb->buf)[(x + y * fb->stride) >> 1];
+    for (; n--; ++x) {
+        uint32_t col = *in++;
+        if (col != key) {
+            if (x & 1) {
+                *b = (col & 0x0f) | (*b & 0xf0);
+            } else {
+                *b = ((uint8_t)col << 4) | (*b & 0x0f);
+            }
+        }
+        if (x & 1) {
+            ++b;
+        }
+    }
+}
+
 STATIC mp_framebuf_p_t formats[] = {
-    [FRAMEBUF_MVLSB] = {mvlsb_setpixel, mvlsb_getpixel, mvlsb_fill_rect},
-    [FRAMEBUF_RGB565] = {rgb565_setpixel, rgb565_getpixel, rgb565_fill_rect},
-    [FRAMEBUF_GS4_HMSB] = {gs4_hmsb_setpixel, gs4_hmsb_getpixel, gs4_hmsb_fill_rect},
-    [FRAMEBUF_MHLSB] = {mono_horiz_setpixel, mono_horiz_getpixel, mono_horiz_fill_rect},
-    [FRAMEBUF_MHMSB] = {mono_horiz_setpixel, mono_horiz_getpixel, mono_horiz_fill_rect},
+    [FRAMEBUF_MVLSB] = {mvlsb_setpixel, mvlsb_getpixel, mvlsb_fill_rect, mvlsb_get_span, mvlsb_set_span},
+    [FRAMEBUF_RGB565] = {rgb565_setpixel, rgb565_getpixel, rgb565_fill_rect, rgb565_get_span, rgb565_set_span},
+    [FRAMEBUF_GS4_HMSB] = {gs4_hmsb_setpixel, gs4_hmsb_getpixel, gs4_hmsb_fill_rect, gs4_hmsb_get_span, gs4_hmsb_set_span},
+    [FRAMEBUF_MHLSB] = {mono_horiz_setpixel, mono_horiz_getpixel, mono_horiz_fill_rect, mono_horiz_get_span, mono_horiz_set_span},
+    [FRAMEBUF_MHMSB] = {mono_horiz_setpixel, mono_horiz_getpixel, mono_horiz_fill_rect, mono_horiz_get_span, mono_horiz_set_span},
 };
 
 static inline void setpixel(const mp_obj_framebuf_t *fb, int x, int y, uint32_t col) {
+    MARK_DIRTY(fb, x, y, 1, 1);
     formats[fb->format].setpixel(fb, x, y, col);
 }
 
@@ -209,9 +426,110 @@ STATIC void fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w, int h, u
     x = MAX(x, 0);
     y = MAX(y, 0);
 
+    MARK_DIRTY(fb, x, y, xend - x, yend - y);
     formats[fb->format].fill_rect(fb, x, y, xend - x, yend - y, col);
 }
 
+// Copy a w x h block between framebuffers of the same format by moving whole
+// bytes, which is possible if the pixels have the same position within their
+// bytes in the source and destination.  Returns false if they don't.
+STATIC bool copy_rect_bytes(const mp_obj_framebuf_t *dst, int dx, int dy, const mp_obj_framebuf_t *src, int sx, int sy, int w, int h) {
+    // when copying within a buffer, go bottom-up if the destination is lower
+    int rstart = 0, rend = h, rstep = 1;
+    if (dst->buf == src->buf && dy > sy) {
+        rstart = h - 1;
+        rend = -1;
+        rstep = -1;
+    }
+    uint8_t *dbuf = dst->buf;
+    const uint8_t *sbuf = src->buf;
+    switch (dst->format) {
+        case FRAMEBUF_RGB565:
+            for (int r = rstart; r != rend; r += rstep) {
+                memmove(dbuf + 2 * (dx + (dy + r) * dst->stride), sbuf + 2 * (sx + (sy + r) * src->stride), 2 * w);
+            }
+            return true;
+        case FRAMEBUF_GS4_HMSB:
+        case FRAMEBUF_MHLSB:
+        case FRAMEBUF_MHMSB: {
+            int bpp = dst->format == FRAMEBUF_GS4_HMSB ? 4 : 1;
+            int ppb = 8 / bpp;
+            if (dx % ppb != sx % ppb) {
+                return false;
+            }
+            for (int r = rstart; r != rend; r += rstep) {
+                packed_copy_row(dbuf + (dx + (dy + r) * dst->stride) / ppb, sbuf + (sx + (sy + r) * src->stride) / ppb,
+                    dx % ppb, w, bpp, dst->format == FRAMEBUF_MHMSB);
+            }
+            return true;
+        }
+        default: { // FRAMEBUF_MVLSB
+            if ((dy & 7) != (sy & 7)) {
+                return false;
+            }
+            // work on a row of 8-pixel-high pages at a time, first and last
+            // pages may be partial
+            int first = dy >> 3, last = (dy + h - 1) >> 3;
+            int pstart = first, pend = last + 1, pstep = 1;
+            if (rstep < 0) {
+                pstart = last;
+                pend = first - 1;
+                pstep = -1;
+            }
+            for (int p = pstart; p != pend; p += pstep) {
+                int y0 = MAX(dy, p * 8), y1 = MIN(dy + h, p * 8 + 8);
+                uint8_t mask = ((1 << (y1 - y0)) - 1) << (y0 & 7);
+                uint8_t *d = dbuf + p * dst->stride + dx;
+                const uint8_t *s = sbuf + ((sy + y0 - dy) >> 3) * src->stride + sx;
+                if (mask == 0xff) {
+                    memmove(d, s, w);
+                } else if (d <= s) {
+                    for (int i = 0; i < w; ++i) {
+                        d[i] = (d[i] & ~mask) | (s[i] & mask);
+                    }
+                } else {
+                    for (int i = w; i--;) {
+                        d[i] = (d[i] & ~mask) | (s[i] & mask);
+                    }
+                }
+            }
+            return true;
+        }
+    }
+}
+
+// Copy a w x h block of pixels from src to dst, skipping pixels of colour key
+// (pass -1 for no key); src and dst may be the same framebuffer
+STATIC void copy_rect(const mp_obj_framebuf_t *dst, int dx, int dy, const mp_obj_framebuf_t *src, int sx, int sy, int w, int h, mp_int_t key) {
+    MARK_DIRTY(dst, dx, dy, w, h);
+    if (key == -1 && dst->format == src->format && copy_rect_bytes(dst, dx, dy, src, sx, sy, w, h)) {
+        return;
+    }
+
+    // go through a small buffer a span of pixels at a time, converting between
+    // formats as needed; when copying within a buffer choose the direction so
+    // that source pixels are read before they're overwritten
+    bool same = dst->buf == src->buf;
+    int rstart = 0, rend = h, rstep = 1;
+    if (same && dy > sy) {
+        rstart = h - 1;
+        rend = -1;
+        rstep = -1;
+    }
+    bool backwards = same && dy == sy && dx > sx;
+    get_span_t get_span = formats[src->format].get_span;
+    set_span_t set_span = formats[dst->format].set_span;
+    uint32_t span[32];
+    for (int r = rstart; r != rend; r += rstep) {
+        for (int i = 0; i < w; i += MP_ARRAY_SIZE(span)) {
+            int n = MIN(w - i, (int)MP_ARRAY_SIZE(span));
+            int c = backwards ? w - i - n : i;
+            get_span(src, sx + c, sy + r, n, span);
+            set_span(dst, dx + c, dy + r, n, span, key);
+        }
+    }
+}
+
 STATIC mp_obj_t framebuf_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     mp_arg_check_num(n_args, n_kw, 4, 5, false);
 
@@ -226,6 +544,9 @@ STATIC mp_obj_t framebuf_make_new(const mp_obj_type_t *type, size_t n_args, size
     o->width = mp_obj_get_int(args[1]);
     o->height = mp_obj_get_int(args[2]);
     o->format = mp_obj_get_int(args[3]);
+    #if MICROPY_PY_FRAMEBUF_DIRTY
+    o->dirty = NULL;
+    #endif
     if (n_args >= 5) {
         o->stride = mp_obj_get_int(args[4]);
     } else {
@@ -262,6 +583,7 @@ STATIC mp_int_t framebuf_get_buffer(mp_obj_t self_in, mp_buffer_info_t *bufinfo,
 STATIC mp_obj_t framebuf_fill(mp_obj_t self_in, mp_obj_t col_in) {
     mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(self_in);
     mp_int_t col = mp_obj_get_int(col_in);
+    MARK_DIRTY(self, 0, 0, self->width, self->height);
     formats[self->format].fill_rect(self, 0, 0, self->width, self->height, col);
     return mp_const_none;
 }
@@ -443,17 +765,7 @@ STATIC mp_obj_t framebuf_blit(size_t n_args, const mp_obj_t *args) {
     int x0end = MIN(self->width, x + source->width);
     int y0end = MIN(self->height, y + source->height);
 
-    for (; y0 < y0end; ++y0) {
-        int cx1 = x1;
-        for (int cx0 = x0; cx0 < x0end; ++cx0) {
-            uint32_t col = getpixel(source, cx1, y1);
-            if (col != (uint32_t)key) {
-                setpixel(self, cx0, y0, col);
-            }
-            ++cx1;
-        }
-        ++y1;
-    }
+    copy_rect(self, x0, y0, source, x1, y1, x0end - x0, y0end - y0, key);
     return mp_const_none;
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_blit_obj, 4, 5, framebuf_blit);
@@ -462,29 +774,10 @@ STATIC mp_obj_t framebuf_scroll(mp_obj_t self_in, mp_obj_t xstep_in, mp_obj_t ys
     mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(self_in);
     mp_int_t xstep = mp_obj_get_int(xstep_in);
     mp_int_t ystep = mp_obj_get_int(ystep_in);
-    int sx, y, xend, yend, dx, dy;
-    if (xstep < 0) {
-        sx = 0;
-        xend = self->width + xstep;
-        dx = 1;
-    } else {
-        sx = self->width - 1;
-        xend = xstep - 1;
-        dx = -1;
-    }
-    if (ystep < 0) {
-        y = 0;
-        yend = self->height + ystep;
-        dy = 1;
-    } else {
-        y = self->height - 1;
-        yend = ystep - 1;
-        dy = -1;
-    }
-    for (; y != yend; y += dy) {
-        for (int x = sx; x != xend; x += dx) {
-            setpixel(self, x, y, getpixel(self, x - xstep, y - ystep));
-        }
+    int w = self->width - (xstep < 0 ? -xstep : xstep);
+    int h = self->height - (ystep < 0 ? -ystep : ystep);
+    if (w > 0 && h > 0) {
+        copy_rect(self, MAX(xstep, 0), MAX(ystep, 0), self, MAX(-xstep, 0), MAX(-ystep, 0), w, h, -1);
     }
     return mp_const_none;
 }
@@ -501,6 +794,8 @@ STATIC mp_obj_t framebuf_text(size_t n_args, const mp_obj_t *args) {
         col = mp_obj_get_int(args[4]);
     }
 
+    setpixel_t set = formats[self->format].setpixel;
+
     // loop over chars
     for (; *str; ++str) {
         // get char and make sure its in range of font
@@ -510,14 +805,43 @@ STATIC mp_obj_t framebuf_text(size_t n_args, const mp_obj_t *args) {
         }
         // get char data
         const uint8_t *chr_data = &font_petme128_8x8[(chr - 32) * 8];
+        MARK_DIRTY(self, x0, y0, 8, 8);
         // loop over char data
         for (int j = 0; j < 8; j++, x0++) {
             if (0 <= x0 && x0 < self->width) { // clip x
                 uint vline_data = chr_data[j]; // each byte is a column of 8 pixels, LSB at top
+                if (self->format == FRAMEBUF_MVLSB) {
+                    // the column maps onto the bits of at most two bytes
+                    if (y0 <= -8 || y0 >= self->height) {
+                        continue;
+                    }
+                    int y = y0;
+                    if (y < 0) {
+                        vline_data >>= -y;
+                        y = 0;
+                    }
+                    if (self->height - y < 8) {
+                        vline_data &= (1 << (self->height - y)) - 1;
+                    }
+                    uint8_t *b = &((uint8_t*)self->buf)[(y >> 3) * self->stride + x0];
+                    uint bits = vline_data << (y & 7);
+                    if (col) {
+                        b[0] |= bits;
+                        if (bits >> 8) {
+                            b[self->stride] |= bits >> 8;
+                        }
+                    } else {
+                        b[0] &= ~bits;
+                        if (bits >> 8) {
+                            b[self->stride] &= ~(bits >> 8);
+                        }
+                    }
+                    continue;
+                }
                 for (int y = y0; vline_data; vline_data >>= 1, y++) { // scan over vertical column
                     if (vline_data & 1) { // only draw if pixel set
                         if (0 <= y && y < self->height) { // clip y
-                            setpixel(self, x0, y, col);
+                            set(self, x0, y, col);
                         }
                     }
                 }
@@ -528,6 +852,109 @@ STATIC mp_obj_t framebuf_text(size_t n_args, const mp_obj_t *args) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_text_obj, 4, 5, framebuf_text);
 
+#if MICROPY_PY_FRAMEBUF_DIRTY
+
+// track_dirty([tile_w, tile_h])
+// Start tracking which tile_w x tile_h tiles get drawn to (default 8 x 8), with
+// all tiles initially dirty; track_dirty(0) stops tracking.
+STATIC mp_obj_t framebuf_track_dirty(size_t n_args, const mp_obj_t *args) {
+    mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t tile_w = n_args > 1 ? mp_obj_get_int(args[1]) : 8;
+    mp_int_t tile_h = n_args > 2 ? mp_obj_get_int(args[2]) : tile_w;
+    if (tile_w == 0) {
+        self->dirty = NULL;
+        return mp_const_none;
+    }
+    if (tile_w < 0 || tile_h <= 0 || tile_w > 0xffff || tile_h > 0xffff) {
+        mp_raise_ValueError(NULL);
+    }
+    self->tile_w = tile_w;
+    self->tile_h = tile_h;
+    self->tiles_x = (self->width + tile_w - 1) / tile_w;
+    self->tiles_y = (self->height + tile_h - 1) / tile_h;
+    size_t n = (self->tiles_x * self->tiles_y + 7) / 8;
+    self->dirty = m_new(uint8_t, n);
+    memset(self->dirty, 0xff, n);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_track_dirty_obj, 1, 3, framebuf_track_dirty);
+
+STATIC mp_obj_t framebuf_clear_dirty(mp_obj_t self_in) {
+    mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->dirty != NULL) {
+        memset(self->dirty, 0, (self->tiles_x * self->tiles_y + 7) / 8);
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(framebuf_clear_dirty_obj, framebuf_clear_dirty);
+
+// mark_dirty(x, y, w, h), for when the buffer is modified directly
+STATIC mp_obj_t framebuf_mark_dirty(size_t n_args, const mp_obj_t *args) {
+    (void)n_args;
+    mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(args[0]);
+    MARK_DIRTY(self, mp_obj_get_int(args[1]), mp_obj_get_int(args[2]), mp_obj_get_int(args[3]), mp_obj_get_int(args[4]));
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_mark_dirty_obj, 5, 5, framebuf_mark_dirty);
+
+typedef struct _mp_obj_framebuf_dirty_it_t {
+    mp_obj_base_t base;
+    mp_obj_framebuf_t *fb;
+    uint16_t tx, ty;
+} mp_obj_framebuf_dirty_it_t;
+
+STATIC bool framebuf_tile_is_dirty(const mp_obj_framebuf_t *fb, int tx, int ty) {
+    int i = ty * fb->tiles_x + tx;
+    return fb->dirty[i >> 3] & (1 << (i & 7));
+}
+
+// Yields (x, y, w, h) for each run of horizontally adjacent dirty tiles
+STATIC mp_obj_t framebuf_dirty_it_iternext(mp_obj_t self_in) {
+    mp_obj_framebuf_dirty_it_t *self = MP_OBJ_TO_PTR(self_in);
+    const mp_obj_framebuf_t *fb = self->fb;
+    if (fb->dirty == NULL) {
+        return MP_OBJ_STOP_ITERATION;
+    }
+    for (; self->ty < fb->tiles_y; self->ty++, self->tx = 0) {
+        for (; self->tx < fb->tiles_x; self->tx++) {
+            if (framebuf_tile_is_dirty(fb, self->tx, self->ty)) {
+                int tx0 = self->tx;
+                while (self->tx < fb->tiles_x && framebuf_tile_is_dirty(fb, self->tx, self->ty)) {
+                    self->tx++;
+                }
+                int x = tx0 * fb->tile_w, y = self->ty * fb->tile_h;
+                mp_obj_t t[4] = {
+                    MP_OBJ_NEW_SMALL_INT(x),
+                    MP_OBJ_NEW_SMALL_INT(y),
+                    MP_OBJ_NEW_SMALL_INT(MIN(self->tx * fb->tile_w, fb->width) - x),
+                    MP_OBJ_NEW_SMALL_INT(MIN(y + fb->tile_h, fb->height) - y),
+                };
+                return mp_obj_new_tuple(4, t);
+            }
+        }
+    }
+    return MP_OBJ_STOP_ITERATION;
+}
+
+STATIC const mp_obj_type_t mp_type_framebuf_dirty_it = {
+    { &mp_type_type },
+    .name = MP_QSTR_iterator,
+    .getiter = mp_identity_getiter,
+    .iternext = framebuf_dirty_it_iternext,
+};
+
+STATIC mp_obj_t framebuf_dirty(mp_obj_t self_in) {
+    mp_obj_framebuf_dirty_it_t *o = m_new_obj(mp_obj_framebuf_dirty_it_t);
+    o->base.type = &mp_type_framebuf_dirty_it;
+    o->fb = MP_OBJ_TO_PTR(self_in);
+    o->tx = 0;
+    o->ty = 0;
+    return MP_OBJ_FROM_PTR(o);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(framebuf_dirty_obj, framebuf_dirty);
+
+#endif // MICROPY_PY_FRAMEBUF_DIRTY
+
 STATIC const mp_rom_map_elem_t framebuf_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_fill), MP_ROM_PTR(&framebuf_fill_obj) },
     { MP_ROM_QSTR(MP_QSTR_fill_rect), MP_ROM_PTR(&framebuf_fill_rect_obj) },
@@ -539,6 +966,12 @@ STATIC const mp_rom_map_elem_t framebuf_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_blit), MP_ROM_PTR(&framebuf_blit_obj) },
     { MP_ROM_QSTR(MP_QSTR_scroll), MP_ROM_PTR(&framebuf_scroll_obj) },
     { MP_ROM_QSTR(MP_QSTR_text), MP_ROM_PTR(&framebuf_text_obj) },
+    #if MICROPY_PY_FRAMEBUF_DIRTY
+    { MP_ROM_QSTR(MP_QSTR_track_dirty), MP_ROM_PTR(&framebuf_track_dirty_obj) },
+    { MP_ROM_QSTR(MP_QSTR_dirty), MP_ROM_PTR(&framebuf_dirty_obj) },
+    { MP_ROM_QSTR(MP_QSTR_clear_dirty), MP_ROM_PTR(&framebuf_clear_dirty_obj) },
+    { MP_ROM_QSTR(MP_QSTR_mark_dirty), MP_ROM_PTR(&framebuf_mark_dirty_obj) },
+    #endif
 };
 STATIC MP_DEFINE_CONST_DICT(framebuf_locals_dict, framebuf_locals_dict_table);
 
@@ -562,6 +995,9 @@ STATIC mp_obj_t legacy_framebuffer1(size_t n_args, const mp_obj_t *args) {
     o->width = mp_obj_get_int(args[1]);
     o->height = mp_obj_get_int(args[2]);
     o->format = FRAMEBUF_MVLSB;
+    #if MICROPY_PY_FRAMEBUF_DIRTY
+    o->dirty = NULL;
+    #endif
     if (n_args >= 4) {
         o->stride = mp_obj_get_int(args[3]);
     } else {
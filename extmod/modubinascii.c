@@ -30,8 +30,65 @@
 
 #include "py/runtime.h"
 #include "py/binary.h"
+#include "py/stream.h"
 #include "extmod/modubinascii.h"
 
+#if MICROPY_OPT_BINASCII_X86_SIMD && defined(__SSE2__)
+#include <emmintrin.h>
+#define BINASCII_SSE2 (1)
+#else
+#define BINASCII_SSE2 (0)
+#endif
+
+static inline byte hex_digit(byte d) {
+    return d < 10 ? d + '0' : d + 'a' - 10;
+}
+
+// Write the hex representation of len bytes of in to out, which must have
+// room for len * 2 bytes, plus len - 1 if sep is not NULL
+STATIC void hexlify_buf(byte *out, const byte *in, size_t len, const char *sep) {
+    if (sep != NULL) {
+        for (size_t i = len; i--;) {
+            *out++ = hex_digit(*in >> 4);
+            *out++ = hex_digit(*in++ & 0xf);
+            if (i != 0) {
+                *out++ = *sep;
+            }
+        }
+        return;
+    }
+    #if BINASCII_SSE2
+    // 16 bytes at a time: split into nibbles, interleave them, and add '0'
+    // or 'a' - 10 to each
+    const __m128i mask_lo = _mm_set1_epi8(0x0f);
+    for (; len >= 16; len -= 16, in += 16, out += 32) {
+        __m128i v = _mm_loadu_si128((const __m128i*)in);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask_lo);
+        __m128i lo = _mm_and_si128(v, mask_lo);
+        __m128i n0 = _mm_unpacklo_epi8(hi, lo);
+        __m128i n1 = _mm_unpackhi_epi8(hi, lo);
+        const __m128i nine = _mm_set1_epi8(9);
+        const __m128i zero = _mm_set1_epi8('0');
+        const __m128i alpha = _mm_set1_epi8('a' - '0' - 10);
+        n0 = _mm_add_epi8(_mm_add_epi8(n0, zero), _mm_and_si128(_mm_cmpgt_epi8(n0, nine), alpha));
+        n1 = _mm_add_epi8(_mm_add_epi8(n1, zero), _mm_and_si128(_mm_cmpgt_epi8(n1, nine), alpha));
+        _mm_storeu_si128((__m128i*)out, n0);
+        _mm_storeu_si128((__m128i*)(out + 16), n1);
+    }
+    #endif
+    for (; len; --len) {
+        *out++ = hex_digit(*in >> 4);
+        *out++ = hex_digit(*in++ & 0xf);
+    }
+}
+
+STATIC size_t hexlify_len(size_t len, const char *sep) {
+    if (len == 0) {
+        return 0;
+    }
+    return len * 2 + (sep != NULL ? len - 1 : 0);
+}
+
 mp_obj_t mod_binascii_hexlify(size_t n_args, const mp_obj_t *args) {
     // Second argument is for an extension to allow a separator to be used
     // between values.
@@ -45,30 +102,13 @@ mp_obj_t mod_binascii_hexlify(size_t n_args, const mp_obj_t *args) {
         return mp_const_empty_bytes;
     }
 
-    vstr_t vstr;
-    size_t out_len = bufinfo.len * 2;
     if (n_args > 1) {
         // 1-char separator between hex numbers
-        out_len += bufinfo.len - 1;
         sep = mp_obj_str_get_str(args[1]);
     }
-    vstr_init_len(&vstr, out_len);
-    byte *in = bufinfo.buf, *out = (byte*)vstr.buf;
-    for (mp_uint_t i = bufinfo.len; i--;) {
-        byte d = (*in >> 4);
-        if (d > 9) {
-            d += 'a' - '9' - 1;
-        }
-        *out++ = d + '0';
-        d = (*in++ & 0xf);
-        if (d > 9) {
-            d += 'a' - '9' - 1;
-        }
-        *out++ = d + '0';
-        if (sep != NULL && i != 0) {
-            *out++ = *sep;
-        }
-    }
+    vstr_t vstr;
+    vstr_init_len(&vstr, hexlify_len(bufinfo.len, sep));
+    hexlify_buf((byte*)vstr.buf, bufinfo.buf, bufinfo.len, sep);
     return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_binascii_hexlify_obj, 1, 2, mod_binascii_hexlify);
@@ -82,44 +122,109 @@ mp_obj_t mod_binascii_unhexlify(mp_obj_t data) {
     }
     vstr_t vstr;
     vstr_init_len(&vstr, bufinfo.len / 2);
-    byte *in = bufinfo.buf, *out = (byte*)vstr.buf;
-    byte hex_byte = 0;
-    for (mp_uint_t i = bufinfo.len; i--;) {
-        byte hex_ch = *in++;
-        if (unichar_isxdigit(hex_ch)) {
-            hex_byte += unichar_xdigit_value(hex_ch);
-        } else {
-            mp_raise_ValueError("non-hex digit found");
+    const byte *in = bufinfo.buf;
+    byte *out = (byte*)vstr.buf;
+    size_t len = bufinfo.len;
+    #if BINASCII_SSE2
+    // 32 digits at a time; a block with any non-hex digit is left to the
+    // loop below, which raises the error
+    for (; len >= 32; len -= 32, in += 32, out += 16) {
+        __m128i w[2];
+        int valid = 0xffff;
+        for (int i = 0; i < 2; ++i) {
+            __m128i c = _mm_loadu_si128((const __m128i*)(in + 16 * i));
+            __m128i lc = _mm_or_si128(c, _mm_set1_epi8(0x20));
+            __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+            __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lc, _mm_set1_epi8('a' - 1)),
+                _mm_cmplt_epi8(lc, _mm_set1_epi8('f' + 1)));
+            valid &= _mm_movemask_epi8(_mm_or_si128(digit, alpha));
+            __m128i n = _mm_or_si128(
+                _mm_and_si128(digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+                _mm_and_si128(alpha, _mm_sub_epi8(lc, _mm_set1_epi8('a' - 10))));
+            // combine each pair of nibbles, high nibble first
+            w[i] = _mm_or_si128(_mm_srli_epi16(n, 8),
+                _mm_slli_epi16(_mm_and_si128(n, _mm_set1_epi16(0x00ff)), 4));
         }
-        if (i & 1) {
-            hex_byte <<= 4;
-        } else {
-            *out++ = hex_byte;
-            hex_byte = 0;
+        if (valid != 0xffff) {
+            break;
+        }
+        _mm_storeu_si128((__m128i*)out, _mm_packus_epi16(w[0], w[1]));
+    }
+    #endif
+    for (; len; len -= 2) {
+        byte hi = *in++;
+        byte lo = *in++;
+        if (!unichar_isxdigit(hi) || !unichar_isxdigit(lo)) {
+            mp_raise_ValueError("non-hex digit found");
         }
+        *out++ = unichar_xdigit_value(hi) << 4 | unichar_xdigit_value(lo);
     }
     return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
 }
 MP_DEFINE_CONST_FUN_OBJ_1(mod_binascii_unhexlify_obj, mod_binascii_unhexlify);
 
+STATIC const char base64_alphabet[64] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Value of each ASCII character in the base64 alphabet, or -1 for characters
+// not in it (including the pad character)
+STATIC const int8_t base64_decode_table[128] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+};
+
 // If ch is a character in the base64 alphabet, and is not a pad character, then
 // the corresponding integer between 0 and 63, inclusively, is returned.
 // Otherwise, -1 is returned.
-static int mod_binascii_sextet(byte ch) {
-    if (ch >= 'A' && ch <= 'Z') {
-        return ch - 'A';
-    } else if (ch >= 'a' && ch <= 'z') {
-        return ch - 'a' + 26;
-    } else if (ch >= '0' && ch <= '9') {
-        return ch - '0' + 52;
-    } else if (ch == '+') {
-        return 62;
-    } else if (ch == '/') {
-        return 63;
-    } else {
-        return -1;
+static inline int mod_binascii_sextet(byte ch) {
+    return ch < 128 ? base64_decode_table[ch] : -1;
+}
+
+#if BINASCII_SSE2
+// Decode 16 base64 characters to 12 bytes, returning false (having written
+// nothing) if any of them is not in the alphabet
+STATIC bool a2b_base64_sse2(byte *out, const byte *in) {
+    __m128i c = _mm_loadu_si128((const __m128i*)in);
+    #define IN_RANGE(lo, hi) _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8((lo) - 1)), \
+        _mm_cmplt_epi8(c, _mm_set1_epi8((hi) + 1)))
+    __m128i upper = IN_RANGE('A', 'Z');
+    __m128i lower = IN_RANGE('a', 'z');
+    __m128i digit = IN_RANGE('0', '9');
+    #undef IN_RANGE
+    __m128i plus = _mm_cmpeq_epi8(c, _mm_set1_epi8('+'));
+    __m128i slash = _mm_cmpeq_epi8(c, _mm_set1_epi8('/'));
+    __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(_mm_or_si128(digit, plus), slash));
+    if (_mm_movemask_epi8(valid) != 0xffff) {
+        return false;
+    }
+    __m128i off = _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')), _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+        _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+            _mm_or_si128(_mm_and_si128(plus, _mm_set1_epi8(62 - '+')), _mm_and_si128(slash, _mm_set1_epi8(63 - '/')))));
+    __m128i s = _mm_add_epi8(c, off);
+    // each 32-bit lane holds 4 sextets, first in the low byte; pack them
+    // into 24 bits, first at the top
+    __m128i m = _mm_set1_epi32(0x3f);
+    __m128i x = _mm_or_si128(
+        _mm_or_si128(_mm_slli_epi32(_mm_and_si128(s, m), 18), _mm_slli_epi32(_mm_and_si128(s, _mm_slli_epi32(m, 8)), 4)),
+        _mm_or_si128(_mm_srli_epi32(_mm_and_si128(s, _mm_slli_epi32(m, 16)), 10), _mm_srli_epi32(s, 24)));
+    uint32_t w[4];
+    _mm_storeu_si128((__m128i*)w, x);
+    for (int i = 0; i < 4; ++i) {
+        *out++ = w[i] >> 16;
+        *out++ = w[i] >> 8;
+        *out++ = w[i];
     }
+    return true;
 }
+#endif
 
 mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
     mp_buffer_info_t bufinfo;
@@ -134,6 +239,36 @@ mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
     int nbits = 0; // Number of meaningful bits in shift
     bool hadpad = false; // Had a pad character since last valid character
     for (size_t i = 0; i < bufinfo.len; i++) {
+        if (nbits == 0) {
+            // At a group boundary, whole groups of valid characters can be
+            // decoded without going through the state machine below
+            #if BINASCII_SSE2
+            while (bufinfo.len - i >= 16 && a2b_base64_sse2(out + vstr.len, in + i)) {
+                vstr.len += 12;
+                i += 16;
+                hadpad = false;
+            }
+            #endif
+            while (bufinfo.len - i >= 4) {
+                int s0 = mod_binascii_sextet(in[i]);
+                int s1 = mod_binascii_sextet(in[i + 1]);
+                int s2 = mod_binascii_sextet(in[i + 2]);
+                int s3 = mod_binascii_sextet(in[i + 3]);
+                if ((s0 | s1 | s2 | s3) < 0) {
+                    break;
+                }
+                uint32_t v = s0 << 18 | s1 << 12 | s2 << 6 | s3;
+                out[vstr.len++] = v >> 16;
+                out[vstr.len++] = v >> 8;
+                out[vstr.len++] = v;
+                i += 4;
+                hadpad = false;
+            }
+            if (i == bufinfo.len) {
+                break;
+            }
+        }
+
         if (in[i] == '=') {
             if ((nbits == 2) || ((nbits == 4) && hadpad)) {
                 nbits = 0;
@@ -164,58 +299,213 @@ mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
 }
 MP_DEFINE_CONST_FUN_OBJ_1(mod_binascii_a2b_base64_obj, mod_binascii_a2b_base64);
 
+// Number of characters needed to base64-encode len bytes, including padding
+#define B2A_BASE64_LEN(len) (((len) + 2) / 3 * 4)
+
+// Base64-encode len bytes of in, with padding, to out, which must have room
+// for B2A_BASE64_LEN(len) characters.  Returns a pointer past the end of the
+// output.
+STATIC byte *b2a_base64_buf(byte *out, const byte *in, size_t len) {
+    #if BINASCII_SSE2
+    // 12 bytes at a time: gather each 3-byte group into a 32-bit lane, split
+    // it into 4 sextets (first in the low byte) and map them to the alphabet
+    for (; len >= 12; len -= 12, in += 12, out += 16) {
+        #define GROUP(i) (in[3 * (i)] << 16 | in[3 * (i) + 1] << 8 | in[3 * (i) + 2])
+        __m128i x = _mm_set_epi32(GROUP(3), GROUP(2), GROUP(1), GROUP(0));
+        #undef GROUP
+        __m128i s = _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(_mm_srli_epi32(x, 18), _mm_set1_epi32(0x3f)),
+                _mm_and_si128(_mm_srli_epi32(x, 4), _mm_set1_epi32(0x3f00))),
+            _mm_or_si128(_mm_and_si128(_mm_slli_epi32(x, 10), _mm_set1_epi32(0x3f0000)),
+                _mm_slli_epi32(x, 24)));
+        s = _mm_and_si128(s, _mm_set1_epi32(0x3f3f3f3f));
+        // 'A' + s for 0-25, then adjust for the a-z, 0-9, '+' and '/' ranges
+        __m128i off = _mm_set1_epi8('A');
+        off = _mm_add_epi8(off, _mm_and_si128(_mm_cmpgt_epi8(s, _mm_set1_epi8(25)), _mm_set1_epi8('a' - 26 - 'A')));
+        off = _mm_add_epi8(off, _mm_and_si128(_mm_cmpgt_epi8(s, _mm_set1_epi8(51)), _mm_set1_epi8('0' - 52 - ('a' - 26))));
+        off = _mm_add_epi8(off, _mm_and_si128(_mm_cmpgt_epi8(s, _mm_set1_epi8(61)), _mm_set1_epi8('+' - 62 - ('0' - 52))));
+        off = _mm_add_epi8(off, _mm_and_si128(_mm_cmpgt_epi8(s, _mm_set1_epi8(62)), _mm_set1_epi8('/' - 63 - ('+' - 62))));
+        _mm_storeu_si128((__m128i*)out, _mm_add_epi8(s, off));
+    }
+    #endif
+    for (; len >= 3; len -= 3, in += 3, out += 4) {
+        uint32_t v = in[0] << 16 | in[1] << 8 | in[2];
+        out[0] = base64_alphabet[v >> 18];
+        out[1] = base64_alphabet[(v >> 12) & 0x3f];
+        out[2] = base64_alphabet[(v >> 6) & 0x3f];
+        out[3] = base64_alphabet[v & 0x3f];
+    }
+    if (len != 0) {
+        uint32_t v = in[0] << 16 | (len == 2 ? in[1] << 8 : 0);
+        out[0] = base64_alphabet[v >> 18];
+        out[1] = base64_alphabet[(v >> 12) & 0x3f];
+        out[2] = len == 2 ? base64_alphabet[(v >> 6) & 0x3f] : '=';
+        out[3] = '=';
+        out += 4;
+    }
+    return out;
+}
+
 mp_obj_t mod_binascii_b2a_base64(mp_obj_t data) {
     mp_buffer_info_t bufinfo;
     mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
 
     vstr_t vstr;
-    vstr_init_len(&vstr, ((bufinfo.len != 0) ? (((bufinfo.len - 1) / 3) + 1) * 4 : 0) + 1);
-
-    // First pass, we convert input buffer to numeric base 64 values
-    byte *in = bufinfo.buf, *out = (byte*)vstr.buf;
-    mp_uint_t i;
-    for (i = bufinfo.len; i >= 3; i -= 3) {
-        *out++ = (in[0] & 0xFC) >> 2;
-        *out++ = (in[0] & 0x03) << 4 | (in[1] & 0xF0) >> 4;
-        *out++ = (in[1] & 0x0F) << 2 | (in[2] & 0xC0) >> 6;
-        *out++ = in[2] & 0x3F;
-        in += 3;
-    }
-    if (i != 0) {
-        *out++ = (in[0] & 0xFC) >> 2;
-        if (i == 2) {
-            *out++ = (in[0] & 0x03) << 4 | (in[1] & 0xF0) >> 4;
-            *out++ = (in[1] & 0x0F) << 2;
+    vstr_init_len(&vstr, B2A_BASE64_LEN(bufinfo.len) + 1);
+    byte *out = b2a_base64_buf((byte*)vstr.buf, bufinfo.buf, bufinfo.len);
+    *out = '\n';
+    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
+}
+MP_DEFINE_CONST_FUN_OBJ_1(mod_binascii_b2a_base64_obj, mod_binascii_b2a_base64);
+
+#if MICROPY_PY_UBINASCII_INTO
+
+STATIC void binascii_get_dest(mp_obj_t buf_in, mp_buffer_info_t *bufinfo, size_t len) {
+    mp_get_buffer_raise(buf_in, bufinfo, MP_BUFFER_WRITE);
+    if (bufinfo->len < len) {
+        mp_raise_ValueError("buffer too small");
+    }
+}
+
+mp_obj_t mod_binascii_hexlify_into(size_t n_args, const mp_obj_t *args) {
+    mp_buffer_info_t bufinfo, dest;
+    mp_get_buffer_raise(args[0], &bufinfo, MP_BUFFER_READ);
+    const char *sep = NULL;
+    if (n_args > 2) {
+        sep = mp_obj_str_get_str(args[2]);
+    }
+    size_t len = hexlify_len(bufinfo.len, sep);
+    binascii_get_dest(args[1], &dest, len);
+    hexlify_buf(dest.buf, bufinfo.buf, bufinfo.len, sep);
+    return MP_OBJ_NEW_SMALL_INT(len);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_binascii_hexlify_into_obj, 2, 3, mod_binascii_hexlify_into);
+
+mp_obj_t mod_binascii_b2a_base64_into(mp_obj_t data, mp_obj_t buf_in) {
+    mp_buffer_info_t bufinfo, dest;
+    mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
+    size_t len = B2A_BASE64_LEN(bufinfo.len) + 1;
+    binascii_get_dest(buf_in, &dest, len);
+    byte *out = b2a_base64_buf(dest.buf, bufinfo.buf, bufinfo.len);
+    *out = '\n';
+    return MP_OBJ_NEW_SMALL_INT(len);
+}
+MP_DEFINE_CONST_FUN_OBJ_2(mod_binascii_b2a_base64_into_obj, mod_binascii_b2a_base64_into);
+
+// Base64Encoder: a write-only stream which base64-encodes everything written
+// to it and writes the result to another stream, a chunk at a time
+
+#define BASE64_ENCODER_CHUNK (512)
+
+typedef struct _mp_obj_base64_encoder_t {
+    mp_obj_base_t base;
+    mp_obj_t dest_stream;
+    byte npending; // number of bytes in pending, 0-2, or 0xff once closed
+    byte pending[3];
+    byte out[BASE64_ENCODER_CHUNK];
+} mp_obj_base64_encoder_t;
+
+STATIC mp_obj_t base64_encoder_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 1, 1, false);
+    mp_get_stream_raise(args[0], MP_STREAM_OP_WRITE);
+    mp_obj_base64_encoder_t *o = m_new_obj(mp_obj_base64_encoder_t);
+    o->base.type = type;
+    o->dest_stream = args[0];
+    o->npending = 0;
+    return MP_OBJ_FROM_PTR(o);
+}
+
+STATIC bool base64_encoder_flush_out(mp_obj_base64_encoder_t *self, byte *end, int *errcode) {
+    if (end != self->out) {
+        mp_stream_write_exactly(self->dest_stream, self->out, end - self->out, errcode);
+        if (*errcode != 0) {
+            return false;
         }
-        else {
-            *out++ = (in[0] & 0x03) << 4;
-            *out++ = 64;
+    }
+    return true;
+}
+
+STATIC mp_uint_t base64_encoder_write(mp_obj_t self_in, const void *buf_in, mp_uint_t size, int *errcode) {
+    mp_obj_base64_encoder_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->npending == 0xff) {
+        *errcode = MP_EINVAL;
+        return MP_STREAM_ERROR;
+    }
+    const byte *in = buf_in;
+    mp_uint_t remain = size;
+    byte *out = self->out;
+
+    // complete a group left over from the previous write
+    if (self->npending != 0) {
+        while (self->npending < 3 && remain != 0) {
+            self->pending[self->npending++] = *in++;
+            remain--;
         }
-        *out = 64;
-    }
-
-    // Second pass, we convert number base 64 values to actual base64 ascii encoding
-    out = (byte*)vstr.buf;
-    for (mp_uint_t j = vstr.len - 1; j--;) {
-        if (*out < 26) {
-            *out += 'A';
-        } else if (*out < 52) {
-            *out += 'a' - 26;
-        } else if (*out < 62) {
-            *out += '0' - 52;
-        } else if (*out == 62) {
-            *out ='+';
-        } else if (*out == 63) {
-            *out = '/';
-        } else {
-            *out = '=';
+        if (self->npending < 3) {
+            return size;
         }
-        out++;
+        out = b2a_base64_buf(out, self->pending, 3);
+        self->npending = 0;
     }
-    *out = '\n';
-    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
+
+    while (remain >= 3) {
+        size_t n = MIN(remain / 3, (size_t)(self->out + BASE64_ENCODER_CHUNK - out) / 4) * 3;
+        if (n == 0) {
+            if (!base64_encoder_flush_out(self, out, errcode)) {
+                return MP_STREAM_ERROR;
+            }
+            out = self->out;
+            continue;
+        }
+        out = b2a_base64_buf(out, in, n);
+        in += n;
+        remain -= n;
+    }
+    if (!base64_encoder_flush_out(self, out, errcode)) {
+        return MP_STREAM_ERROR;
+    }
+
+    memcpy(self->pending, in, remain);
+    self->npending = remain;
+    return size;
 }
-MP_DEFINE_CONST_FUN_OBJ_1(mod_binascii_b2a_base64_obj, mod_binascii_b2a_base64);
+
+// Write out the final group, with padding; the destination stream is left open
+STATIC mp_obj_t base64_encoder_close(mp_obj_t self_in) {
+    mp_obj_base64_encoder_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->npending == 0xff) {
+        return mp_const_none;
+    }
+    int errcode = 0;
+    byte *out = b2a_base64_buf(self->out, self->pending, self->npending);
+    self->npending = 0xff;
+    if (!base64_encoder_flush_out(self, out, &errcode)) {
+        mp_raise_OSError(errcode);
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(base64_encoder_close_obj, base64_encoder_close);
+
+STATIC const mp_rom_map_elem_t base64_encoder_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_write), MP_ROM_PTR(&mp_stream_write_obj) },
+    { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&base64_encoder_close_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(base64_encoder_locals_dict, base64_encoder_locals_dict_table);
+
+STATIC const mp_stream_p_t base64_encoder_stream_p = {
+    .write = base64_encoder_write,
+};
+
+STATIC const mp_obj_type_t base64_encoder_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_Base64Encoder,
+    .make_new = base64_encoder_make_new,
+    .protocol = &base64_encoder_stream_p,
+    .locals_dict = (void*)&base64_encoder_locals_dict,
+};
+
+#endif // MICROPY_PY_UBINASCII_INTO
 
 #if MICROPY_PY_UBINASCII_CRC32
 #include "uzlib/tinf.h"
@@ -230,6 +520,185 @@ mp_obj_t mod_binascii_crc32(size_t n_args, const mp_obj_t *args) {
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_binascii_crc32_obj, 1, 2, mod_binascii_crc32);
 #endif
 
+#if MICROPY_PY_UBINASCII_CRC_EXTRA
+
+#if MICROPY_OPT_CRC_X86_SIMD && defined(__x86_64__) && defined(__GNUC__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define CRC32C_SSE42 (1)
+#else
+#define CRC32C_SSE42 (0)
+#endif
+
+// CRC-32C (Castagnoli), reflected polynomial 0x82f63b78
+#if MICROPY_OPT_CRC_LARGE_TABLES
+STATIC const uint32_t crc32c_table[256] = {
+    0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4, 0xc79a971f, 0x35f1141c,
+    0x26a1e7e8, 0xd4ca64eb, 0x8ad958cf, 0x78b2dbcc, 0x6be22838, 0x9989ab3b,
+    0x4d43cfd0, 0xbf284cd3, 0xac78bf27, 0x5e133c24, 0x105ec76f, 0xe235446c,
+    0xf165b798, 0x030e349b, 0xd7c45070, 0x25afd373, 0x36ff2087, 0xc494a384,
+    0x9a879fa0, 0x68ec1ca3, 0x7bbcef57, 0x89d76c54, 0x5d1d08bf, 0xaf768bbc,
+    0xbc267848, 0x4e4dfb4b, 0x20bd8ede, 0xd2d60ddd, 0xc186fe29, 0x33ed7d2a,
+    0xe72719c1, 0x154c9ac2, 0x061c6936, 0xf477ea35, 0xaa64d611, 0x580f5512,
+    0x4b5fa6e6, 0xb93425e5, 0x6dfe410e, 0x9f95c20d, 0x8cc531f9, 0x7eaeb2fa,
+    0x30e349b1, 0xc288cab2, 0xd1d83946, 0x23b3ba45, 0xf779deae, 0x05125dad,
+    0x1642ae59, 0xe4292d5a, 0xba3a117e, 0x4851927d, 0x5b016189, 0xa96ae28a,
+    0x7da08661, 0x8fcb0562, 0x9c9bf696, 0x6ef07595, 0x417b1dbc, 0xb3109ebf,
+    0xa0406d4b, 0x522bee48, 0x86e18aa3, 0x748a09a0, 0x67dafa54, 0x95b17957,
+    0xcba24573, 0x39c9c670, 0x2a993584, 0xd8f2b687, 0x0c38d26c, 0xfe53516f,
+    0xed03a29b, 0x1f682198, 0x5125dad3, 0xa34e59d0, 0xb01eaa24, 0x42752927,
+    0x96bf4dcc, 0x64d4cecf, 0x77843d3b, 0x85efbe38, 0xdbfc821c, 0x2997011f,
+    0x3ac7f2eb, 0xc8ac71e8, 0x1c661503, 0xee0d9600, 0xfd5d65f4, 0x0f36e6f7,
+    0x61c69362, 0x93ad1061, 0x80fde395, 0x72966096, 0xa65c047d, 0x5437877e,
+    0x4767748a, 0xb50cf789, 0xeb1fcbad, 0x197448ae, 0x0a24bb5a, 0xf84f3859,
+    0x2c855cb2, 0xdeeedfb1, 0xcdbe2c45, 0x3fd5af46, 0x7198540d, 0x83f3d70e,
+    0x90a324fa, 0x62c8a7f9, 0xb602c312, 0x44694011, 0x5739b3e5, 0xa55230e6,
+    0xfb410cc2, 0x092a8fc1, 0x1a7a7c35, 0xe811ff36, 0x3cdb9bdd, 0xceb018de,
+    0xdde0eb2a, 0x2f8b6829, 0x82f63b78, 0x709db87b, 0x63cd4b8f, 0x91a6c88c,
+    0x456cac67, 0xb7072f64, 0xa457dc90, 0x563c5f93, 0x082f63b7, 0xfa44e0b4,
+    0xe9141340, 0x1b7f9043, 0xcfb5f4a8, 0x3dde77ab, 0x2e8e845f, 0xdce5075c,
+    0x92a8fc17, 0x60c37f14, 0x73938ce0, 0x81f80fe3, 0x55326b08, 0xa759e80b,
+    0xb4091bff, 0x466298fc, 0x1871a4d8, 0xea1a27db, 0xf94ad42f, 0x0b21572c,
+    0xdfeb33c7, 0x2d80b0c4, 0x3ed04330, 0xccbbc033, 0xa24bb5a6, 0x502036a5,
+    0x4370c551, 0xb11b4652, 0x65d122b9, 0x97baa1ba, 0x84ea524e, 0x7681d14d,
+    0x2892ed69, 0xdaf96e6a, 0xc9a99d9e, 0x3bc21e9d, 0xef087a76, 0x1d63f975,
+    0x0e330a81, 0xfc588982, 0xb21572c9, 0x407ef1ca, 0x532e023e, 0xa145813d,
+    0x758fe5d6, 0x87e466d5, 0x94b49521, 0x66df1622, 0x38cc2a06, 0xcaa7a905,
+    0xd9f75af1, 0x2b9cd9f2, 0xff56bd19, 0x0d3d3e1a, 0x1e6dcdee, 0xec064eed,
+    0xc38d26c4, 0x31e6a5c7, 0x22b65633, 0xd0ddd530, 0x0417b1db, 0xf67c32d8,
+    0xe52cc12c, 0x1747422f, 0x49547e0b, 0xbb3ffd08, 0xa86f0efc, 0x5a048dff,
+    0x8ecee914, 0x7ca56a17, 0x6ff599e3, 0x9d9e1ae0, 0xd3d3e1ab, 0x21b862a8,
+    0x32e8915c, 0xc083125f, 0x144976b4, 0xe622f5b7, 0xf5720643, 0x07198540,
+    0x590ab964, 0xab613a67, 0xb831c993, 0x4a5a4a90, 0x9e902e7b, 0x6cfbad78,
+    0x7fab5e8c, 0x8dc0dd8f, 0xe330a81a, 0x115b2b19, 0x020bd8ed, 0xf0605bee,
+    0x24aa3f05, 0xd6c1bc06, 0xc5914ff2, 0x37faccf1, 0x69e9f0d5, 0x9b8273d6,
+    0x88d28022, 0x7ab90321, 0xae7367ca, 0x5c18e4c9, 0x4f48173d, 0xbd23943e,
+    0xf36e6f75, 0x0105ec76, 0x12551f82, 0xe03e9c81, 0x34f4f86a, 0xc69f7b69,
+    0xd5cf889d, 0x27a40b9e, 0x79b737ba, 0x8bdcb4b9, 0x988c474d, 0x6ae7c44e,
+    0xbe2da0a5, 0x4c4623a6, 0x5f16d052, 0xad7d5351,
+};
+#else
+STATIC const uint32_t crc32c_table[16] = {
+    0x00000000, 0x105ec76f, 0x20bd8ede, 0x30e349b1, 0x417b1dbc, 0x5125dad3,
+    0x61c69362, 0x7198540d, 0x82f63b78, 0x92a8fc17, 0xa24bb5a6, 0xb21572c9,
+    0xc38d26c4, 0xd3d3e1ab, 0xe330a81a, 0xf36e6f75,
+};
+#endif
+
+// CRC-16/CCITT as used by binascii.crc_hqx, polynomial 0x1021, not reflected
+#if MICROPY_OPT_CRC_LARGE_TABLES
+STATIC const uint16_t crc_hqx_table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+    0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52b5, 0x4294, 0x72f7, 0x62d6,
+    0x9339, 0x8318, 0xb37b, 0xa35a, 0xd3bd, 0xc39c, 0xf3ff, 0xe3de,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64e6, 0x74c7, 0x44a4, 0x5485,
+    0xa56a, 0xb54b, 0x8528, 0x9509, 0xe5ee, 0xf5cf, 0xc5ac, 0xd58d,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76d7, 0x66f6, 0x5695, 0x46b4,
+    0xb75b, 0xa77a, 0x9719, 0x8738, 0xf7df, 0xe7fe, 0xd79d, 0xc7bc,
+    0x48c4, 0x58e5, 0x6886, 0x78a7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xc9cc, 0xd9ed, 0xe98e, 0xf9af, 0x8948, 0x9969, 0xa90a, 0xb92b,
+    0x5af5, 0x4ad4, 0x7ab7, 0x6a96, 0x1a71, 0x0a50, 0x3a33, 0x2a12,
+    0xdbfd, 0xcbdc, 0xfbbf, 0xeb9e, 0x9b79, 0x8b58, 0xbb3b, 0xab1a,
+    0x6ca6, 0x7c87, 0x4ce4, 0x5cc5, 0x2c22, 0x3c03, 0x0c60, 0x1c41,
+    0xedae, 0xfd8f, 0xcdec, 0xddcd, 0xad2a, 0xbd0b, 0x8d68, 0x9d49,
+    0x7e97, 0x6eb6, 0x5ed5, 0x4ef4, 0x3e13, 0x2e32, 0x1e51, 0x0e70,
+    0xff9f, 0xefbe, 0xdfdd, 0xcffc, 0xbf1b, 0xaf3a, 0x9f59, 0x8f78,
+    0x9188, 0x81a9, 0xb1ca, 0xa1eb, 0xd10c, 0xc12d, 0xf14e, 0xe16f,
+    0x1080, 0x00a1, 0x30c2, 0x20e3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83b9, 0x9398, 0xa3fb, 0xb3da, 0xc33d, 0xd31c, 0xe37f, 0xf35e,
+    0x02b1, 0x1290, 0x22f3, 0x32d2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xb5ea, 0xa5cb, 0x95a8, 0x8589, 0xf56e, 0xe54f, 0xd52c, 0xc50d,
+    0x34e2, 0x24c3, 0x14a0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xa7db, 0xb7fa, 0x8799, 0x97b8, 0xe75f, 0xf77e, 0xc71d, 0xd73c,
+    0x26d3, 0x36f2, 0x0691, 0x16b0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xd94c, 0xc96d, 0xf90e, 0xe92f, 0x99c8, 0x89e9, 0xb98a, 0xa9ab,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18c0, 0x08e1, 0x3882, 0x28a3,
+    0xcb7d, 0xdb5c, 0xeb3f, 0xfb1e, 0x8bf9, 0x9bd8, 0xabbb, 0xbb9a,
+    0x4a75, 0x5a54, 0x6a37, 0x7a16, 0x0af1, 0x1ad0, 0x2ab3, 0x3a92,
+    0xfd2e, 0xed0f, 0xdd6c, 0xcd4d, 0xbdaa, 0xad8b, 0x9de8, 0x8dc9,
+    0x7c26, 0x6c07, 0x5c64, 0x4c45, 0x3ca2, 0x2c83, 0x1ce0, 0x0cc1,
+    0xef1f, 0xff3e, 0xcf5d, 0xdf7c, 0xaf9b, 0xbfba, 0x8fd9, 0x9ff8,
+    0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0,
+};
+#else
+STATIC const uint16_t crc_hqx_table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+    0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+};
+#endif
+
+#if CRC32C_SSE42
+// 1 if the CPU has the SSE4.2 crc32 instruction, 0 if not, -1 if not checked yet
+STATIC int8_t crc32c_have_sse42 = -1;
+
+__attribute__((target("sse4.2")))
+STATIC uint32_t crc32c_sse42(const byte *buf, size_t len, uint32_t crc) {
+    uint64_t crc64 = crc;
+    for (; len >= 8; len -= 8, buf += 8) {
+        uint64_t v;
+        memcpy(&v, buf, 8);
+        crc64 = _mm_crc32_u64(crc64, v);
+    }
+    crc = crc64;
+    while (len--) {
+        crc = _mm_crc32_u8(crc, *buf++);
+    }
+    return crc;
+}
+#endif
+
+STATIC uint32_t crc32c_update(const byte *buf, size_t len, uint32_t crc) {
+    #if CRC32C_SSE42
+    if (crc32c_have_sse42 < 0) {
+        unsigned int eax, ebx, ecx, edx;
+        crc32c_have_sse42 = __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_SSE4_2);
+    }
+    if (crc32c_have_sse42) {
+        return crc32c_sse42(buf, len, crc);
+    }
+    #endif
+    while (len--) {
+        #if MICROPY_OPT_CRC_LARGE_TABLES
+        crc = crc32c_table[(crc ^ *buf++) & 0xff] ^ (crc >> 8);
+        #else
+        crc ^= *buf++;
+        crc = crc32c_table[crc & 0x0f] ^ (crc >> 4);
+        crc = crc32c_table[crc & 0x0f] ^ (crc >> 4);
+        #endif
+    }
+    return crc;
+}
+
+mp_obj_t mod_binascii_crc32c(size_t n_args, const mp_obj_t *args) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[0], &bufinfo, MP_BUFFER_READ);
+    uint32_t crc = (n_args > 1) ? mp_obj_get_int_truncated(args[1]) : 0;
+    crc = crc32c_update(bufinfo.buf, bufinfo.len, crc ^ 0xffffffff);
+    return mp_obj_new_int_from_uint(crc ^ 0xffffffff);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_binascii_crc32c_obj, 1, 2, mod_binascii_crc32c);
+
+mp_obj_t mod_binascii_crc_hqx(size_t n_args, const mp_obj_t *args) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[0], &bufinfo, MP_BUFFER_READ);
+    uint32_t crc = (n_args > 1) ? mp_obj_get_int_truncated(args[1]) & 0xffff : 0;
+    const byte *buf = bufinfo.buf;
+    for (size_t len = bufinfo.len; len--;) {
+        #if MICROPY_OPT_CRC_LARGE_TABLES
+        crc = ((crc << 8) & 0xff00) ^ crc_hqx_table[(crc >> 8) ^ *buf++];
+        #else
+        crc ^= *buf++ << 8;
+        crc = ((crc << 4) & 0xfff0) ^ crc_hqx_table[crc >> 12];
+        crc = ((crc << 4) & 0xfff0) ^ crc_hqx_table[crc >> 12];
+        #endif
+    }
+    return MP_OBJ_NEW_SMALL_INT(crc);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_binascii_crc_hqx_obj, 1, 2, mod_binascii_crc_hqx);
+
+#endif
+
 #if MICROPY_PY_UBINASCII
 
 STATIC const mp_rom_map_elem_t mp_module_binascii_globals_table[] = {
@@ -238,9 +707,18 @@ STATIC const mp_rom_map_elem_t mp_module_binascii_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_unhexlify), MP_ROM_PTR(&mod_binascii_unhexlify_obj) },
     { MP_ROM_QSTR(MP_QSTR_a2b_base64), MP_ROM_PTR(&mod_binascii_a2b_base64_obj) },
     { MP_ROM_QSTR(MP_QSTR_b2a_base64), MP_ROM_PTR(&mod_binascii_b2a_base64_obj) },
+    #if MICROPY_PY_UBINASCII_INTO
+    { MP_ROM_QSTR(MP_QSTR_hexlify_into), MP_ROM_PTR(&mod_binascii_hexlify_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_b2a_base64_into), MP_ROM_PTR(&mod_binascii_b2a_base64_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_Base64Encoder), MP_ROM_PTR(&base64_encoder_type) },
+    #endif
     #if MICROPY_PY_UBINASCII_CRC32
     { MP_ROM_QSTR(MP_QSTR_crc32), MP_ROM_PTR(&mod_binascii_crc32_obj) },
     #endif
+    #if MICROPY_PY_UBINASCII_CRC_EXTRA
+    { MP_ROM_QSTR(MP_QSTR_crc32c), MP_ROM_PTR(&mod_binascii_crc32c_obj) },
+    { MP_ROM_QSTR(MP_QSTR_crc_hqx), MP_ROM_PTR(&mod_binascii_crc_hqx_obj) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_binascii_globals, mp_module_binascii_globals_table);
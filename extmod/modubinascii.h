@@ -30,12 +30,20 @@ extern mp_obj_t mod_binascii_hexlify(size_t n_args, const mp_obj_t *args);
 extern mp_obj_t mod_binascii_unhexlify(mp_obj_t data);
 extern mp_obj_t mod_binascii_a2b_base64(mp_obj_t data);
 extern mp_obj_t mod_binascii_b2a_base64(mp_obj_t data);
+extern mp_obj_t mod_binascii_hexlify_into(size_t n_args, const mp_obj_t *args);
+extern mp_obj_t mod_binascii_b2a_base64_into(mp_obj_t data, mp_obj_t buf_in);
 extern mp_obj_t mod_binascii_crc32(size_t n_args, const mp_obj_t *args);
+extern mp_obj_t mod_binascii_crc32c(size_t n_args, const mp_obj_t *args);
+extern mp_obj_t mod_binascii_crc_hqx(size_t n_args, const mp_obj_t *args);
 
 MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(mod_binascii_hexlify_obj);
 MP_DECLARE_CONST_FUN_OBJ_1(mod_binascii_unhexlify_obj);
 MP_DECLARE_CONST_FUN_OBJ_1(mod_binascii_a2b_base64_obj);
 MP_DECLARE_CONST_FUN_OBJ_1(mod_binascii_b2a_base64_obj);
+MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(mod_binascii_hexlify_into_obj);
+MP_DECLARE_CONST_FUN_OBJ_2(mod_binascii_b2a_base64_into_obj);
 MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(mod_binascii_crc32_obj);
+MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(mod_binascii_crc32c_obj);
+MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(mod_binascii_crc_hqx_obj);
 
 #endif // MICROPY_INCLUDED_EXTMOD_MODUBINASCII_H
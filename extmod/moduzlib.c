@@ -33,6 +33,9 @@
 
 #if MICROPY_PY_UZLIB
 
+#define TINF_CRC32_SLICE8 (MICROPY_OPT_CRC_LARGE_TABLES)
+#define TINF_CRC32_PCLMUL (MICROPY_OPT_CRC_X86_SIMD)
+#define TINF_FAST_BITS (MICROPY_OPT_UZLIB_FAST_BITS)
 #include "uzlib/tinf.h"
 
 #if 0 // print debugging info
@@ -41,11 +44,18 @@
 #define DEBUG_printf(...) (void)0
 #endif
 
+// Compressed input is read from a seekable source stream in blocks of this
+// size; the part not consumed is given back at the end of the compressed data.
+// Other streams are read a byte at a time so nothing after the data is lost.
+#define DECOMPIO_SRC_BUF_SIZE (256)
+
 typedef struct _mp_obj_decompio_t {
     mp_obj_base_t base;
     mp_obj_t src_stream;
     TINF_DATA decomp;
     bool eof;
+    bool src_seekable;
+    byte src_buf[DECOMPIO_SRC_BUF_SIZE];
 } mp_obj_decompio_t;
 
 STATIC unsigned char read_src_stream(TINF_DATA *data) {
@@ -55,15 +65,39 @@ STATIC unsigned char read_src_stream(TINF_DATA *data) {
 
     const mp_stream_p_t *stream = mp_get_stream_raise(self->src_stream, MP_STREAM_OP_READ);
     int err;
-    byte c;
-    mp_uint_t out_sz = stream->read(self->src_stream, &c, 1, &err);
+    mp_uint_t size = self->src_seekable ? sizeof(self->src_buf) : 1;
+    mp_uint_t out_sz = stream->read(self->src_stream, self->src_buf, size, &err);
     if (out_sz == MP_STREAM_ERROR) {
         mp_raise_OSError(err);
     }
     if (out_sz == 0) {
         nlr_raise(mp_obj_new_exception(&mp_type_EOFError));
     }
-    return c;
+    data->source = self->src_buf + 1;
+    data->source_limit = self->src_buf + out_sz;
+    return self->src_buf[0];
+}
+
+STATIC mp_uint_t decompio_seek_src(mp_obj_decompio_t *self, mp_off_t offset, int *errcode) {
+    const mp_stream_p_t *stream = mp_get_stream_raise(self->src_stream, MP_STREAM_OP_READ);
+    if (stream->ioctl == NULL) {
+        *errcode = MP_EOPNOTSUPP;
+        return MP_STREAM_ERROR;
+    }
+    struct mp_stream_seek_t seek_s;
+    seek_s.offset = offset;
+    seek_s.whence = SEEK_CUR;
+    return stream->ioctl(self->src_stream, MP_STREAM_SEEK, (mp_uint_t)(uintptr_t)&seek_s, errcode);
+}
+
+// Input read past the end of the compressed data is given back, so that the
+// source stream is left positioned just after that data.
+STATIC mp_uint_t decompio_unread_src(mp_obj_decompio_t *self, int *errcode) {
+    mp_off_t unused = self->decomp.source_limit - self->decomp.source + self->decomp.bitcount / 8;
+    if (unused == 0 || !self->src_seekable) {
+        return 0;
+    }
+    return decompio_seek_src(self, -unused, errcode);
 }
 
 STATIC mp_obj_t decompio_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
@@ -74,6 +108,8 @@ STATIC mp_obj_t decompio_make_new(const mp_obj_type_t *type, size_t n_args, size
     o->decomp.readSource = read_src_stream;
     o->src_stream = args[0];
     o->eof = false;
+    int err;
+    o->src_seekable = decompio_seek_src(o, 0, &err) != MP_STREAM_ERROR;
 
     mp_int_t dict_opt = 0;
     int dict_sz;
@@ -113,6 +149,9 @@ STATIC mp_uint_t decompio_read(mp_obj_t o_in, void *buf, mp_uint_t size, int *er
     int st = uzlib_uncompress_chksum(&o->decomp);
     if (st == TINF_DONE) {
         o->eof = true;
+        if (decompio_unread_src(o, errcode) == MP_STREAM_ERROR) {
+            return MP_STREAM_ERROR;
+        }
     }
     if (st < 0) {
         *errcode = MP_EINVAL;
@@ -157,6 +196,7 @@ STATIC mp_obj_t mod_uzlib_decompress(size_t n_args, const mp_obj_t *args) {
     decomp->destSize = dest_buf_size;
     DEBUG_printf("uzlib: Initial out buffer: " UINT_FMT " bytes\n", decomp->destSize);
     decomp->source = bufinfo.buf;
+    decomp->source_limit = decomp->source + bufinfo.len;
 
     int st;
     bool is_zlib = true;
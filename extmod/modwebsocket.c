@@ -38,6 +38,10 @@ enum { FRAME_HEADER, FRAME_OPT, PAYLOAD, CONTROL };
 
 enum { BLOCKING_WRITE = 0x80 };
 
+// Payloads up to this size are sent in the same stream write as the frame
+// header; for bigger ones the header goes with the start of the payload
+#define WEBSOCKET_WRITE_COALESCE (128)
+
 typedef struct _mp_obj_websocket_t {
     mp_obj_base_t base;
     mp_obj_t sock;
@@ -47,7 +51,8 @@ typedef struct _mp_obj_websocket_t {
     byte to_recv;
     byte mask_pos;
     byte buf_pos;
-    byte buf[6];
+    // 8 bytes of extended payload length followed by 4 bytes of mask
+    byte buf[12];
     byte opts;
     // Copy of last data frame flags
     byte ws_flags;
@@ -57,6 +62,34 @@ typedef struct _mp_obj_websocket_t {
 
 STATIC mp_uint_t websocket_write(mp_obj_t self_in, const void *buf, mp_uint_t size, int *errcode);
 
+// XOR len bytes of buf with the mask, starting at position *mask_pos in the
+// mask, a machine word at a time where buf is suitably aligned
+STATIC void websocket_unmask(byte *buf, size_t len, const byte mask[4], byte *mask_pos) {
+    byte pos = *mask_pos;
+    *mask_pos = pos + len;
+    while (len && ((uintptr_t)buf & (sizeof(uintptr_t) - 1))) {
+        *buf++ ^= mask[pos++ & 3];
+        len--;
+    }
+    if (len >= sizeof(uintptr_t)) {
+        // the mask, rotated to start at the current position and repeated to
+        // fill a word
+        union { byte b[sizeof(uintptr_t)]; uintptr_t w; } m;
+        for (size_t i = 0; i < sizeof(uintptr_t); ++i) {
+            m.b[i] = mask[(pos + i) & 3];
+        }
+        // the word size is a multiple of 4, so pos is unchanged by this loop
+        uintptr_t *w = (uintptr_t*)buf;
+        for (; len >= sizeof(uintptr_t); len -= sizeof(uintptr_t)) {
+            *w++ ^= m.w;
+        }
+        buf = (byte*)w;
+    }
+    while (len--) {
+        *buf++ ^= mask[pos++ & 3];
+    }
+}
+
 STATIC mp_obj_t websocket_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     mp_arg_check_num(n_args, n_kw, 1, 2, false);
     mp_obj_websocket_t *o = m_new_obj(mp_obj_websocket_t);
@@ -120,7 +153,7 @@ STATIC mp_uint_t websocket_read(mp_obj_t self_in, void *buf, mp_uint_t size, int
                     to_recv += 2;
                 } else if (sz == 127) {
                     // Msg size is next 8 bytes
-                    assert(0);
+                    to_recv += 8;
                 }
                 if (self->buf[1] & 0x80) {
                     // Next 4 bytes is mask
@@ -143,11 +176,20 @@ STATIC mp_uint_t websocket_read(mp_obj_t self_in, void *buf, mp_uint_t size, int
             }
 
             case FRAME_OPT: {
-                if ((self->buf_pos & 3) == 2) {
+                int len_sz = self->msg_sz == 126 ? 2 : self->msg_sz == 127 ? 8 : 0;
+                if (self->msg_sz == 126) {
                     // First two bytes are message length
                     self->msg_sz = (self->buf[0] << 8) | self->buf[1];
+                } else if (self->msg_sz == 127) {
+                    // First eight bytes are message length, we only support
+                    // lengths that fit in 32 bits
+                    if (self->buf[0] | self->buf[1] | self->buf[2] | self->buf[3]) {
+                        *errcode = MP_EIO;
+                        return MP_STREAM_ERROR;
+                    }
+                    self->msg_sz = (uint32_t)self->buf[4] << 24 | self->buf[5] << 16 | self->buf[6] << 8 | self->buf[7];
                 }
-                if (self->buf_pos >= 4) {
+                if (self->buf_pos > len_sz) {
                     // Last 4 bytes is mask
                     memcpy(self->mask, self->buf + self->buf_pos - 4, 4);
                 }
@@ -174,9 +216,10 @@ STATIC mp_uint_t websocket_read(mp_obj_t self_in, void *buf, mp_uint_t size, int
                     return out_sz;
                 }
 
-                sz = out_sz;
-                for (byte *p = buf; sz--; p++) {
-                    *p ^= self->mask[self->mask_pos++ & 3];
+                // the payload was read straight into the caller's buffer, so
+                // unmask it in place (an all-zero mask means no masking)
+                if (self->mask[0] | self->mask[1] | self->mask[2] | self->mask[3]) {
+                    websocket_unmask(buf, out_sz, self->mask, &self->mask_pos);
                 }
 
                 self->msg_sz -= out_sz;
@@ -217,18 +260,31 @@ no_payload:
 
 STATIC mp_uint_t websocket_write(mp_obj_t self_in, const void *buf, mp_uint_t size, int *errcode) {
     mp_obj_websocket_t *self =  MP_OBJ_TO_PTR(self_in);
-    assert(size < 0x10000);
-    byte header[4] = {0x80 | (self->opts & FRAME_OPCODE_MASK)};
+
+    // assemble the header and the start of the payload in one buffer, so the
+    // header doesn't go out as a separate small write (and packet)
+    byte frame[10 + WEBSOCKET_WRITE_COALESCE];
+    frame[0] = 0x80 | (self->opts & FRAME_OPCODE_MASK);
     int hdr_sz;
     if (size < 126) {
-        header[1] = size;
+        frame[1] = size;
         hdr_sz = 2;
-    } else {
-        header[1] = 126;
-        header[2] = size >> 8;
-        header[3] = size & 0xff;
+    } else if (size < 0x10000) {
+        frame[1] = 126;
+        frame[2] = size >> 8;
+        frame[3] = size & 0xff;
         hdr_sz = 4;
+    } else {
+        frame[1] = 127;
+        memset(frame + 2, 0, 4);
+        frame[6] = (uint32_t)size >> 24;
+        frame[7] = size >> 16;
+        frame[8] = size >> 8;
+        frame[9] = size & 0xff;
+        hdr_sz = 10;
     }
+    mp_uint_t first_sz = MIN(size, WEBSOCKET_WRITE_COALESCE);
+    memcpy(frame + hdr_sz, buf, first_sz);
 
     mp_obj_t dest[3];
     if (self->opts & BLOCKING_WRITE) {
@@ -237,9 +293,10 @@ STATIC mp_uint_t websocket_write(mp_obj_t self_in, const void *buf, mp_uint_t si
         mp_call_method_n_kw(1, 0, dest);
     }
 
-    mp_uint_t out_sz = mp_stream_write_exactly(self->sock, header, hdr_sz, errcode);
-    if (*errcode == 0) {
-        out_sz = mp_stream_write_exactly(self->sock, buf, size, errcode);
+    mp_stream_write_exactly(self->sock, frame, hdr_sz + first_sz, errcode);
+    if (*errcode == 0 && size > first_sz) {
+        // the rest of the payload goes straight from the caller's buffer
+        mp_stream_write_exactly(self->sock, (const byte*)buf + first_sz, size - first_sz, errcode);
     }
 
     if (self->opts & BLOCKING_WRITE) {
@@ -250,7 +307,7 @@ STATIC mp_uint_t websocket_write(mp_obj_t self_in, const void *buf, mp_uint_t si
     if (*errcode != 0) {
         return MP_STREAM_ERROR;
     }
-    return out_sz;
+    return size;
 }
 
 STATIC mp_uint_t websocket_ioctl(mp_obj_t self_in, mp_uint_t request, uintptr_t arg, int *errcode) {
@@ -39,19 +39,41 @@ extern "C" {
 #define TINF_CHKSUM_ADLER 1
 #define TINF_CHKSUM_CRC   2
 
+/* number of bits decoded at once with a lookup table; codes up to this
+   length take one table lookup, longer ones are decoded bit by bit */
+#ifndef TINF_FAST_BITS
+#define TINF_FAST_BITS 9
+#endif
+
+/* use 8KiB of slice-by-8 tables for CRC32 instead of a 64-byte table */
+#ifndef TINF_CRC32_SLICE8
+#define TINF_CRC32_SLICE8 0
+#endif
+
+/* use PCLMULQDQ for CRC32 on x86-64 CPUs that have it */
+#ifndef TINF_CRC32_PCLMUL
+#define TINF_CRC32_PCLMUL 0
+#endif
+
 /* data structures */
 
 typedef struct {
    unsigned short table[16];  /* table of code length counts */
    unsigned short trans[288]; /* code -> symbol translation table */
+   /* next TINF_FAST_BITS bits of input -> code length << 9 | symbol,
+      or 0 if the code is longer */
+   unsigned short fast[1 << TINF_FAST_BITS];
 } TINF_TREE;
 
 struct TINF_DATA;
 typedef struct TINF_DATA {
    const unsigned char *source;
-   /* If source above is NULL, this function will be used to read
-      next byte from source stream */
+   /* End of the data at source; bytes past it are read as 0 and set eof */
+   const unsigned char *source_limit;
+   /* If source reaches source_limit, this function will be used to read
+      next byte from source stream; it may refill source/source_limit */
    unsigned char (*readSource)(struct TINF_DATA *data);
+   unsigned char eof;
 
    unsigned int tag;
    unsigned int bitcount;
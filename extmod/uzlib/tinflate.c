@@ -33,6 +33,7 @@
  */
 
 #include <assert.h>
+#include <string.h>
 #include "tinf.h"
 
 uint32_t tinf_get_le_uint32(TINF_DATA *d);
@@ -112,6 +113,31 @@ static void tinf_build_bits_base(unsigned char *bits, unsigned short *base, int
 }
 #endif
 
+/* fill the fast lookup table of a tree from its code length counts and
+   symbols; codes are assigned canonically, and are stored bit-reversed
+   since they are read from the stream most significant bit first */
+static void tinf_build_fast_table(TINF_TREE *t)
+{
+   unsigned int len, i, idx = 0, code = 0;
+
+   memset(t->fast, 0, sizeof(t->fast));
+
+   for (len = 1; len <= TINF_FAST_BITS; ++len)
+   {
+      for (i = 0; i < t->table[len]; ++i, ++code)
+      {
+         unsigned int rev = 0, c = code, j;
+         for (j = 0; j < len; ++j, c >>= 1) rev = (rev << 1) | (c & 1);
+         for (j = rev; j < (1 << TINF_FAST_BITS); j += 1 << len)
+         {
+            t->fast[j] = len << 9 | t->trans[idx];
+         }
+         ++idx;
+      }
+      code <<= 1;
+   }
+}
+
 /* build the fixed huffman trees */
 static void tinf_build_fixed_trees(TINF_TREE *lt, TINF_TREE *dt)
 {
@@ -135,6 +161,9 @@ static void tinf_build_fixed_trees(TINF_TREE *lt, TINF_TREE *dt)
    dt->table[5] = 32;
 
    for (i = 0; i < 32; ++i) dt->trans[i] = i;
+
+   tinf_build_fast_table(lt);
+   tinf_build_fast_table(dt);
 }
 
 /* given an array of code lengths, build a tree */
@@ -163,6 +192,8 @@ static void tinf_build_tree(TINF_TREE *t, const unsigned char *lengths, unsigned
    {
       if (lengths[i]) t->trans[offs[lengths[i]]++] = i;
    }
+
+   tinf_build_fast_table(t);
 }
 
 /* ---------------------- *
@@ -171,10 +202,30 @@ static void tinf_build_tree(TINF_TREE *t, const unsigned char *lengths, unsigned
 
 unsigned char uzlib_get_byte(TINF_DATA *d)
 {
-    if (d->source) {
+    if (d->source < d->source_limit) {
         return *d->source++;
     }
-    return d->readSource(d);
+    if (d->readSource) {
+        return d->readSource(d);
+    }
+    d->eof = 1;
+    return 0;
+}
+
+/* get the next whole byte of input, skipping to a byte boundary and taking
+   any whole bytes left over in the bit buffer first */
+static unsigned char tinf_get_aligned_byte(TINF_DATA *d)
+{
+    unsigned char c;
+    d->tag >>= d->bitcount & 7;
+    d->bitcount &= ~7;
+    if (d->bitcount == 0) {
+        return uzlib_get_byte(d);
+    }
+    c = d->tag;
+    d->tag >>= 8;
+    d->bitcount -= 8;
+    return c;
 }
 
 uint32_t tinf_get_le_uint32(TINF_DATA *d)
@@ -182,7 +233,7 @@ uint32_t tinf_get_le_uint32(TINF_DATA *d)
     uint32_t val = 0;
     int i;
     for (i = 4; i--;) {
-        val = val >> 8 | uzlib_get_byte(d) << 24;
+        val = val >> 8 | (uint32_t)tinf_get_aligned_byte(d) << 24;
     }
     return val;
 }
@@ -192,27 +243,39 @@ uint32_t tinf_get_be_uint32(TINF_DATA *d)
     uint32_t val = 0;
     int i;
     for (i = 4; i--;) {
-        val = val << 8 | uzlib_get_byte(d);
+        val = val << 8 | tinf_get_aligned_byte(d);
     }
     return val;
 }
 
+/* top up the bit buffer with whole bytes that are already in memory; this
+   never calls readSource, so never reads further ahead in a stream */
+static void tinf_refill(TINF_DATA *d)
+{
+   while (d->bitcount <= 24 && d->source < d->source_limit)
+   {
+      d->tag |= (unsigned int)*d->source++ << d->bitcount;
+      d->bitcount += 8;
+   }
+}
+
 /* get one bit from source stream */
 static int tinf_getbit(TINF_DATA *d)
 {
    unsigned int bit;
 
    /* check if tag is empty */
-   if (!d->bitcount--)
+   if (!d->bitcount)
    {
       /* load next tag */
       d->tag = uzlib_get_byte(d);
-      d->bitcount = 7;
+      d->bitcount = 8;
    }
 
    /* shift bit out of tag */
    bit = d->tag & 0x01;
    d->tag >>= 1;
+   d->bitcount--;
 
    return bit;
 }
@@ -225,11 +288,21 @@ static unsigned int tinf_read_bits(TINF_DATA *d, int num, int base)
    /* read num bits */
    if (num)
    {
-      unsigned int limit = 1 << (num);
-      unsigned int mask;
+      tinf_refill(d);
+      if (d->bitcount >= (unsigned int)num)
+      {
+         val = d->tag & ((1 << num) - 1);
+         d->tag >>= num;
+         d->bitcount -= num;
+      }
+      else
+      {
+         unsigned int limit = 1 << (num);
+         unsigned int mask;
 
-      for (mask = 1; mask < limit; mask *= 2)
-         if (tinf_getbit(d)) val += mask;
+         for (mask = 1; mask < limit; mask *= 2)
+            if (tinf_getbit(d)) val += mask;
+      }
    }
 
    return val + base;
@@ -240,6 +313,19 @@ static int tinf_decode_symbol(TINF_DATA *d, TINF_TREE *t)
 {
    int sum = 0, cur = 0, len = 0;
 
+   /* look up short codes in one go */
+   tinf_refill(d);
+   if (d->bitcount >= TINF_FAST_BITS)
+   {
+      unsigned int e = t->fast[d->tag & ((1 << TINF_FAST_BITS) - 1)];
+      if (e)
+      {
+         d->tag >>= e >> 9;
+         d->bitcount -= e >> 9;
+         return e & 0x1ff;
+      }
+   }
+
    /* get more bits while code value is above sum */
    do {
 
@@ -332,88 +418,169 @@ static void tinf_decode_trees(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
  * -- block inflate functions -- *
  * ----------------------------- */
 
-/* given a stream and two trees, inflate a block of data */
-static int tinf_inflate_block_data(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
+/* output a run of bytes, also adding them to the dictionary ring if any */
+static void tinf_put_run(TINF_DATA *d, const unsigned char *src, unsigned int len)
 {
-    if (d->curlen == 0) {
-        unsigned int offs;
-        int dist;
-        int sym = tinf_decode_symbol(d, lt);
-        //printf("huff sym: %02x\n", sym);
-
-        /* literal byte */
-        if (sym < 256) {
-            TINF_PUT(d, sym);
-            return TINF_OK;
+    memcpy(d->dest, src, len);
+    if (d->dict_ring) {
+        const unsigned char *p = d->dest;
+        unsigned int left = len;
+        while (left) {
+            unsigned int n = d->dict_size - d->dict_idx;
+            if (n > left) {
+                n = left;
+            }
+            memcpy(d->dict_ring + d->dict_idx, p, n);
+            p += n;
+            left -= n;
+            d->dict_idx += n;
+            if (d->dict_idx == d->dict_size) {
+                d->dict_idx = 0;
+            }
         }
+    }
+    d->dest += len;
+    d->destSize -= len;
+}
 
-        /* end of block */
-        if (sym == 256) {
-            return TINF_DONE;
-        }
+/* given a stream and two trees, inflate a block of data, as much of it as
+   fits in the output buffer */
+static int tinf_inflate_block_data(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
+{
+    while (d->destSize) {
+        unsigned int len;
+
+        if (d->curlen == 0) {
+            unsigned int offs;
+            int dist;
+            int sym = tinf_decode_symbol(d, lt);
+            //printf("huff sym: %02x\n", sym);
+
+            /* literal byte */
+            if (sym < 256) {
+                TINF_PUT(d, sym);
+                d->destSize--;
+                continue;
+            }
+
+            /* end of block */
+            if (sym == 256) {
+                return TINF_DONE;
+            }
 
-        /* substring from sliding dictionary */
-        sym -= 257;
-        /* possibly get more bits from length code */
-        d->curlen = tinf_read_bits(d, length_bits[sym], length_base[sym]);
+            /* substring from sliding dictionary */
+            sym -= 257;
+            /* possibly get more bits from length code */
+            d->curlen = tinf_read_bits(d, length_bits[sym], length_base[sym]);
+
+            dist = tinf_decode_symbol(d, dt);
+            /* possibly get more bits from distance code */
+            offs = tinf_read_bits(d, dist_bits[dist], dist_base[dist]);
+            if (d->dict_ring) {
+                if (offs > d->dict_size) {
+                    return TINF_DICT_ERROR;
+                }
+                d->lzOff = d->dict_idx - offs;
+                if (d->lzOff < 0) {
+                    d->lzOff += d->dict_size;
+                }
+            } else {
+                d->lzOff = -offs;
+            }
+        }
 
-        dist = tinf_decode_symbol(d, dt);
-        /* possibly get more bits from distance code */
-        offs = tinf_read_bits(d, dist_bits[dist], dist_base[dist]);
+        /* copy the dict substring in runs which don't overlap the bytes
+           they produce, and don't wrap around the dictionary ring */
+        len = d->curlen;
+        if (len > d->destSize) {
+            len = d->destSize;
+        }
         if (d->dict_ring) {
-            if (offs > d->dict_size) {
-                return TINF_DICT_ERROR;
+            unsigned int offs = d->dict_idx - d->lzOff;
+            if ((int)offs <= 0) {
+                offs += d->dict_size;
+            }
+            if (len > offs) {
+                len = offs;
             }
-            d->lzOff = d->dict_idx - offs;
-            if (d->lzOff < 0) {
-                d->lzOff += d->dict_size;
+            if (len > d->dict_size - d->lzOff) {
+                len = d->dict_size - d->lzOff;
+            }
+            tinf_put_run(d, d->dict_ring + d->lzOff, len);
+            d->lzOff += len;
+            if ((unsigned)d->lzOff == d->dict_size) {
+                d->lzOff = 0;
             }
         } else {
-            d->lzOff = -offs;
-        }
-    }
-
-    /* copy next byte from dict substring */
-    if (d->dict_ring) {
-        TINF_PUT(d, d->dict_ring[d->lzOff]);
-        if ((unsigned)++d->lzOff == d->dict_size) {
-            d->lzOff = 0;
+            if (len > (unsigned)-d->lzOff) {
+                len = -d->lzOff;
+            }
+            memcpy(d->dest, d->dest + d->lzOff, len);
+            d->dest += len;
+            d->destSize -= len;
         }
-    } else {
-        d->dest[0] = d->dest[d->lzOff];
-        d->dest++;
+        d->curlen -= len;
     }
-    d->curlen--;
     return TINF_OK;
 }
 
-/* inflate an uncompressed block of data */
+/* inflate an uncompressed block of data, as much of it as fits in the
+   output buffer */
 static int tinf_inflate_uncompressed_block(TINF_DATA *d)
 {
     if (d->curlen == 0) {
         unsigned int length, invlength;
 
-        /* get length */
-        length = uzlib_get_byte(d) + 256 * uzlib_get_byte(d);
+        /* get length, starting on a byte boundary */
+        length = tinf_get_aligned_byte(d);
+        length += 256 * tinf_get_aligned_byte(d);
         /* get one's complement of length */
-        invlength = uzlib_get_byte(d) + 256 * uzlib_get_byte(d);
+        invlength = tinf_get_aligned_byte(d);
+        invlength += 256 * tinf_get_aligned_byte(d);
         /* check length */
         if (length != (~invlength & 0x0000ffff)) return TINF_DATA_ERROR;
 
         /* increment length to properly return TINF_DONE below, without
            producing data at the same time */
         d->curlen = length + 1;
-
-        /* make sure we start next block on a byte boundary */
-        d->bitcount = 0;
     }
 
-    if (--d->curlen == 0) {
-        return TINF_DONE;
-    }
+    while (d->destSize) {
+        unsigned int len;
+
+        if (d->curlen == 1) {
+            d->curlen = 0;
+            return TINF_DONE;
+        }
+
+        /* first use up any whole bytes left in the bit buffer */
+        if (d->bitcount) {
+            unsigned char c = tinf_get_aligned_byte(d);
+            TINF_PUT(d, c);
+            d->destSize--;
+            d->curlen--;
+            continue;
+        }
 
-    unsigned char c = uzlib_get_byte(d);
-    TINF_PUT(d, c);
+        /* then copy straight from the input, as much as is available */
+        len = d->source_limit - d->source;
+        if (len == 0) {
+            unsigned char c = uzlib_get_byte(d);
+            TINF_PUT(d, c);
+            d->destSize--;
+            d->curlen--;
+            continue;
+        }
+        if (len > d->curlen - 1) {
+            len = d->curlen - 1;
+        }
+        if (len > d->destSize) {
+            len = d->destSize;
+        }
+        tinf_put_run(d, d->source, len);
+        d->source += len;
+        d->curlen -= len;
+    }
     return TINF_OK;
 }
 
@@ -447,10 +614,11 @@ void uzlib_uncompress_init(TINF_DATA *d, void *dict, unsigned int dictLen)
    d->curlen = 0;
 }
 
-/* inflate next byte of compressed stream */
+/* inflate compressed stream until the output buffer (destSize bytes) is
+   full or the end of the stream is reached */
 int uzlib_uncompress(TINF_DATA *d)
 {
-    do {
+    while (d->destSize) {
         int res;
 
         /* start a new block */
@@ -489,17 +657,21 @@ next_blk:
             return TINF_DATA_ERROR;
         }
 
+        /* ran off the end of the input */
+        if (d->eof) {
+            return TINF_DATA_ERROR;
+        }
+
         if (res == TINF_DONE && !d->bfinal) {
-            /* the block has ended (without producing more data), but we
-               can't return without data, so start procesing next block */
+            /* the block has ended, but we can't return until the output
+               buffer is full, so start procesing next block */
             goto next_blk;
         }
 
         if (res != TINF_OK) {
             return res;
         }
-
-    } while (--d->destSize);
+    }
 
     return TINF_OK;
 }
@@ -36,19 +36,20 @@
 
 typedef struct _mp_reader_vfs_t {
     mp_obj_t file;
+    uint16_t bufsize;
     uint16_t len;
     uint16_t pos;
-    byte buf[24];
+    byte buf[];
 } mp_reader_vfs_t;
 
 STATIC mp_uint_t mp_reader_vfs_readbyte(void *data) {
     mp_reader_vfs_t *reader = (mp_reader_vfs_t*)data;
     if (reader->pos >= reader->len) {
-        if (reader->len < sizeof(reader->buf)) {
+        if (reader->len < reader->bufsize) {
             return MP_READER_EOF;
         } else {
             int errcode;
-            reader->len = mp_stream_rw(reader->file, reader->buf, sizeof(reader->buf),
+            reader->len = mp_stream_rw(reader->file, reader->buf, reader->bufsize,
                 &errcode, MP_STREAM_RW_READ | MP_STREAM_RW_ONCE);
             if (errcode != 0) {
                 // TODO handle errors properly
@@ -66,15 +67,24 @@ STATIC mp_uint_t mp_reader_vfs_readbyte(void *data) {
 STATIC void mp_reader_vfs_close(void *data) {
     mp_reader_vfs_t *reader = (mp_reader_vfs_t*)data;
     mp_stream_close(reader->file);
-    m_del_obj(mp_reader_vfs_t, reader);
+    m_del_var(mp_reader_vfs_t, byte, reader->bufsize, reader);
 }
 
 void mp_reader_new_file(mp_reader_t *reader, const char *filename) {
-    mp_reader_vfs_t *rf = m_new_obj(mp_reader_vfs_t);
+    // Try to get a full-sized buffer so the filesystem can read whole blocks
+    // (and small files in one go), but fall back to a small one if the heap
+    // is too fragmented to provide it.
+    size_t bufsize = MICROPY_READER_BUF_SIZE;
+    mp_reader_vfs_t *rf = m_new_obj_var_maybe(mp_reader_vfs_t, byte, bufsize);
+    if (rf == NULL) {
+        bufsize = MP_READER_MIN_BUF_SIZE;
+        rf = m_new_obj_var(mp_reader_vfs_t, byte, bufsize);
+    }
+    rf->bufsize = bufsize;
     mp_obj_t arg = mp_obj_new_str(filename, strlen(filename), false);
     rf->file = mp_vfs_open(1, &arg, (mp_map_t*)&mp_const_empty_map);
     int errcode;
-    rf->len = mp_stream_rw(rf->file, rf->buf, sizeof(rf->buf), &errcode, MP_STREAM_RW_READ | MP_STREAM_RW_ONCE);
+    rf->len = mp_stream_rw(rf->file, rf->buf, rf->bufsize, &errcode, MP_STREAM_RW_READ | MP_STREAM_RW_ONCE);
     if (errcode != 0) {
         mp_raise_OSError(errcode);
     }
@@ -18,10 +18,13 @@
 // compiler configuration
 #define MICROPY_COMP_MODULE_CONST           (1)
 #define MICROPY_COMP_TRIPLE_TUPLE_ASSIGN    (1)
+#define MICROPY_COMP_OPTIMISE               (1)
 
 // optimisations
 #define MICROPY_OPT_COMPUTED_GOTO           (1)
+#define MICROPY_OPT_VM_SMALL_INT            (1)
 #define MICROPY_OPT_MPZ_BITWISE             (1)
+#define MICROPY_OPT_CRC_LARGE_TABLES        (1)
 
 // Python internal features
 #define MICROPY_READER_VFS                  (1)
@@ -100,6 +103,7 @@
 #define MICROPY_PY_IO_BYTESIO               (1)
 #define MICROPY_PY_IO_BUFFEREDWRITER        (1)
 #define MICROPY_PY_STRUCT                   (1)
+#define MICROPY_PY_STRUCT_COMPILED          (1)
 #define MICROPY_PY_SYS                      (1)
 #define MICROPY_PY_SYS_MAXSIZE              (1)
 #define MICROPY_PY_SYS_MODULES              (1)
@@ -124,6 +128,8 @@
 #define MICROPY_PY_UHASHLIB_SHA1            (MICROPY_PY_USSL && MICROPY_SSL_AXTLS)
 #define MICROPY_PY_UBINASCII                (1)
 #define MICROPY_PY_UBINASCII_CRC32          (1)
+#define MICROPY_PY_UBINASCII_CRC_EXTRA      (1)
+#define MICROPY_PY_UBINASCII_INTO           (1)
 #define MICROPY_PY_URANDOM                  (1)
 #define MICROPY_PY_URANDOM_EXTRA_FUNCS      (1)
 #define MICROPY_PY_MACHINE                  (1)
@@ -141,6 +147,7 @@
 #define MICROPY_PY_USSL_FINALISER           (1)
 #define MICROPY_PY_WEBSOCKET                (1)
 #define MICROPY_PY_FRAMEBUF                 (1)
+#define MICROPY_PY_FRAMEBUF_DIRTY           (1)
 
 // fatfs configuration
 #define MICROPY_FATFS_ENABLE_LFN            (1)
@@ -38,6 +38,9 @@
 #ifndef MICROPY_EMIT_THUMB
 #define MICROPY_EMIT_THUMB          (1)
 #endif
+#ifndef MICROPY_EMIT_THUMB_FLOAT
+#define MICROPY_EMIT_THUMB_FLOAT    (1)
+#endif
 #ifndef MICROPY_EMIT_INLINE_THUMB
 #define MICROPY_EMIT_INLINE_THUMB   (1)
 #endif
@@ -11,6 +11,7 @@
 #include "py/formatfloat.h"
 #include "py/stream.h"
 #include "py/binary.h"
+#include "extmod/btree_pagecache.h"
 
 #if defined(MICROPY_UNIX_COVERAGE)
 
@@ -138,6 +139,23 @@ STATIC const mp_obj_str_t str_no_hash_obj = {{&mp_type_str}, 0, 10, (const byte*
 STATIC const mp_obj_str_t bytes_no_hash_obj = {{&mp_type_bytes}, 0, 10, (const byte*)"0123456789"};
 
 // function to run extra tests for things that can't be checked by scripts
+#if MICROPY_PY_BTREE_PAGECACHE
+// pin pages whose first byte has the top bit set
+STATIC bool pagecache_pin(const byte *page) {
+    return page[0] >= 0x80;
+}
+
+// read a 16-byte page through the cache and return its first byte
+STATIC int pagecache_read(mp_btree_page_cache_t *c, size_t pgno) {
+    byte page[16];
+    mp_btree_page_cache_lseek(c, pgno * 16, SEEK_SET);
+    if (mp_btree_page_cache_read(c, page, 16) != 16) {
+        return -1;
+    }
+    return page[0];
+}
+#endif
+
 STATIC mp_obj_t extra_coverage(void) {
     // mp_printf (used by ports that don't have a native printf)
     {
@@ -335,6 +353,59 @@ STATIC mp_obj_t extra_coverage(void) {
         }
     }
 
+    #if MICROPY_PY_BTREE_PAGECACHE
+    // btree page cache
+    {
+        mp_printf(&mp_plat_print, "# btree page cache\n");
+
+        // a stream of 8 pages of 16 bytes, each filled with its page number,
+        // except that page 4 is marked to be pinned
+        byte data[8 * 16];
+        for (size_t i = 0; i < sizeof(data); ++i) {
+            data[i] = i / 16;
+        }
+        data[4 * 16] = 0x84;
+        mp_obj_t arg = mp_obj_new_bytes(data, sizeof(data));
+        mp_obj_t stream = mp_type_bytesio.make_new(&mp_type_bytesio, 1, 0, &arg);
+        mp_btree_page_cache_t *c = mp_btree_page_cache_new(stream, 4, 3, pagecache_pin);
+
+        // until the page size is known, reads go straight to the stream
+        byte buf[16];
+        mp_btree_page_cache_lseek(c, 16, SEEK_SET);
+        mp_printf(&mp_plat_print, "%d", (int)mp_btree_page_cache_read(c, buf, 16));
+        mp_printf(&mp_plat_print, " %d %d\n", buf[0], (int)c->misses);
+        mp_btree_page_cache_start(c, 16);
+
+        // a hit, sequential misses that read ahead and evict the oldest
+        // pages, a pinned page, and a miss out of sequence
+        static const byte pages[] = {0, 0, 1, 2, 3, 4, 0};
+        for (size_t i = 0; i < sizeof(pages); ++i) {
+            mp_printf(&mp_plat_print, i == 0 ? "%d" : " %d", pagecache_read(c, pages[i]));
+        }
+        mp_printf(&mp_plat_print, "\n%u %u %u %u\n", (uint)c->hits, (uint)c->misses, (uint)c->evictions, c->n_pinned);
+
+        // writing a whole page updates the cached copy, and writing part of
+        // a page drops it; both are written to the stream
+        memset(buf, 0x55, 16);
+        mp_btree_page_cache_lseek(c, 5 * 16, SEEK_SET);
+        mp_btree_page_cache_write(c, buf, 16);
+        memset(buf, 0x66, 4);
+        mp_btree_page_cache_lseek(c, 6 * 16, SEEK_SET);
+        mp_btree_page_cache_write(c, buf, 4);
+        mp_printf(&mp_plat_print, "%d %d\n", pagecache_read(c, 5), pagecache_read(c, 6));
+        mp_printf(&mp_plat_print, "%u %u %u %u\n", (uint)c->hits, (uint)c->misses, (uint)c->evictions, c->n_pinned);
+        mp_stream_posix_lseek(stream, 5 * 16, SEEK_SET);
+        mp_stream_posix_read(stream, buf, 16);
+        mp_printf(&mp_plat_print, "%d\n", buf[0]);
+
+        // a read that isn't of a whole page goes straight to the stream
+        mp_btree_page_cache_lseek(c, 4 * 16 + 1, SEEK_SET);
+        mp_printf(&mp_plat_print, "%d", (int)mp_btree_page_cache_read(c, buf, 16));
+        mp_printf(&mp_plat_print, " %d %d\n", buf[0], (int)mp_btree_page_cache_lseek(c, 0, SEEK_CUR));
+        mp_printf(&mp_plat_print, "%d\n", (int)mp_btree_page_cache_lseek(c, 0, SEEK_END));
+    }
+    #endif
+
     mp_obj_streamtest_t *s = m_new_obj(mp_obj_streamtest_t);
     s->base.type = &mp_type_stest_fileio;
     s->buf = NULL;
@@ -57,6 +57,11 @@ STATIC uint emit_opt = MP_EMIT_OPT_NONE;
 // Heap size of GC heap (if enabled)
 // Make it larger on a 64 bit machine, because pointers are larger.
 long heap_size = 1024*1024 * (sizeof(mp_uint_t) / 4);
+
+#if MICROPY_ENABLE_PYSTACK
+// Python stack for the main thread, holding the state of function calls
+STATIC mp_obj_t pystack[16384];
+#endif
 #endif
 
 STATIC void stderr_print_strn(void *env, const char *str, size_t len) {
@@ -440,6 +445,10 @@ MP_NOINLINE int main_(int argc, char **argv) {
     gc_init(heap, heap + heap_size);
 #endif
 
+    #if MICROPY_ENABLE_PYSTACK
+    mp_pystack_init(pystack, &pystack[MP_ARRAY_SIZE(pystack)]);
+    #endif
+
     mp_init();
 
     char *home = getenv("HOME");
@@ -632,8 +641,14 @@ MP_NOINLINE int main_(int argc, char **argv) {
 
 #if MICROPY_ENABLE_GC && !defined(NDEBUG)
     // We don't really need to free memory since we are about to exit the
-    // process, but doing so helps to find memory leaks.
-    free(heap);
+    // process, but doing so helps to find memory leaks.  Other threads keep
+    // using the heap until the process exits, so it can't be freed under them.
+    #if MICROPY_PY_THREAD
+    if (!mp_thread_unix_others_running())
+    #endif
+    {
+        free(heap);
+    }
 #endif
 
     //printf("total bytes = %d\n", m_get_total_bytes_allocated());
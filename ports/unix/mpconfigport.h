@@ -46,9 +46,16 @@
 #define MICROPY_COMP_MODULE_CONST   (1)
 #define MICROPY_COMP_TRIPLE_TUPLE_ASSIGN (1)
 #define MICROPY_COMP_RETURN_IF_EXPR (1)
+#define MICROPY_COMP_OPTIMISE       (1)
 #define MICROPY_ENABLE_GC           (1)
 #define MICROPY_ENABLE_FINALISER    (1)
 #define MICROPY_STACK_CHECK         (1)
+#define MICROPY_ENABLE_PYSTACK      (1)
+#define MICROPY_PYSTACK_THREAD_SIZE (1024 * BYTES_PER_WORD)
+// Thread allocation buffers measured slower here, so they're opt-in
+#ifndef MICROPY_GC_THREAD_ALLOC_BLOCKS
+#define MICROPY_GC_THREAD_ALLOC_BLOCKS (0)
+#endif
 #define MICROPY_MALLOC_USES_ALLOCATED_SIZE (1)
 #define MICROPY_MEM_STATS           (1)
 #define MICROPY_DEBUG_PRINTERS      (1)
@@ -62,7 +69,9 @@
 #define MICROPY_REPL_AUTO_INDENT    (1)
 #define MICROPY_HELPER_LEXER_UNIX   (1)
 #define MICROPY_ENABLE_SOURCE_LINE  (1)
+#ifndef MICROPY_FLOAT_IMPL
 #define MICROPY_FLOAT_IMPL          (MICROPY_FLOAT_IMPL_DOUBLE)
+#endif
 #define MICROPY_LONGINT_IMPL        (MICROPY_LONGINT_IMPL_MPZ)
 #define MICROPY_STREAMS_NON_BLOCK   (1)
 #define MICROPY_STREAMS_POSIX_API   (1)
@@ -70,6 +79,17 @@
 #ifndef MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE
 #define MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE (1)
 #endif
+#ifndef MICROPY_OPT_CACHE_GLOBAL_LOOKUP
+#define MICROPY_OPT_CACHE_GLOBAL_LOOKUP (1)
+#endif
+#define MICROPY_OPT_VM_SMALL_INT    (1)
+#ifndef MICROPY_OPT_FAST_FLOAT
+#define MICROPY_OPT_FAST_FLOAT      (1)
+#endif
+#define MICROPY_OPT_CRC_LARGE_TABLES (1)
+#define MICROPY_OPT_CRC_X86_SIMD    (1)
+#define MICROPY_OPT_UZLIB_FAST_BITS (9)
+#define MICROPY_OPT_BINASCII_X86_SIMD (1)
 #define MICROPY_CAN_OVERRIDE_BUILTINS (1)
 #define MICROPY_PY_FUNCTION_ATTRS   (1)
 #define MICROPY_PY_DESCRIPTORS      (1)
@@ -104,6 +124,7 @@
 #define MICROPY_PY_CMATH            (1)
 #define MICROPY_PY_IO_FILEIO        (1)
 #define MICROPY_PY_IO_RESOURCE_STREAM (1)
+#define MICROPY_PY_STRUCT_COMPILED  (1)
 #define MICROPY_PY_GC_COLLECT_RETVAL (1)
 #define MICROPY_MODULE_FROZEN_STR   (1)
 
@@ -126,11 +147,15 @@
 #endif
 #define MICROPY_PY_UBINASCII        (1)
 #define MICROPY_PY_UBINASCII_CRC32  (1)
+#define MICROPY_PY_UBINASCII_CRC_EXTRA (1)
+#define MICROPY_PY_UBINASCII_INTO   (1)
 #define MICROPY_PY_URANDOM          (1)
 #ifndef MICROPY_PY_USELECT_POSIX
 #define MICROPY_PY_USELECT_POSIX    (1)
 #endif
 #define MICROPY_PY_WEBSOCKET        (1)
+#define MICROPY_PY_FRAMEBUF         (1)
+#define MICROPY_PY_FRAMEBUF_DIRTY   (1)
 #define MICROPY_PY_MACHINE          (1)
 #define MICROPY_PY_MACHINE_PULSE    (1)
 #define MICROPY_MACHINE_MEM_GET_READ_ADDR   mod_machine_mem_get_addr
@@ -302,6 +327,11 @@ void mp_unix_mark_exec(void);
 #endif
 #endif
 
+#if MICROPY_PY_THREAD
+#include <sched.h>
+#define MICROPY_THREAD_YIELD() sched_yield()
+#endif
+
 // From "man readdir": "Under glibc, programs can check for the availability
 // of the fields [in struct dirent] not defined in POSIX.1 by testing whether
 // the macros [...], _DIRENT_HAVE_D_TYPE are defined."
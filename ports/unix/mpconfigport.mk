@@ -13,6 +13,8 @@ MICROPY_PY_BTREE = 1
 
 # _thread module using pthreads
 MICROPY_PY_THREAD = 1
+# Whether threads take a global interpreter lock (GIL) to run Python code
+MICROPY_PY_THREAD_GIL = 0
 
 # Subset of CPython termios module
 MICROPY_PY_TERMIOS = 1
@@ -44,3 +44,4 @@
 #undef MICROPY_VFS_FAT
 #define MICROPY_VFS_FAT                (1)
 #define MICROPY_PY_FRAMEBUF            (1)
+#define MICROPY_PY_BTREE_PAGECACHE     (1)
@@ -24,6 +24,7 @@
  * THE SOFTWARE.
  */
 #include <unistd.h>
+#include <errno.h>
 
 #ifndef CHAR_CTRL_C
 #define CHAR_CTRL_C (3)
@@ -56,3 +57,24 @@ static inline void mp_hal_delay_us(mp_uint_t us) { usleep(us); }
 #define RAISE_ERRNO(err_flag, error_val) \
     { if (err_flag == -1) \
         { mp_raise_OSError(error_val); } }
+
+// Run a potentially blocking syscall with the GIL released, so other threads
+// can run while it blocks.  The call is retried if it is interrupted by a
+// signal (after handling any pending exception, eg KeyboardInterrupt).  On
+// any other error the "raise" statement is executed with the errno in "err".
+#define MP_HAL_RETRY_SYSCALL(ret, syscall, raise) { \
+    for (;;) { \
+        MP_THREAD_GIL_EXIT(); \
+        ret = syscall; \
+        int err = errno; \
+        MP_THREAD_GIL_ENTER(); \
+        if (ret == -1) { \
+            if (err == EINTR) { \
+                mp_handle_pending(); \
+                continue; \
+            } \
+            raise; \
+        } \
+        break; \
+    } \
+}
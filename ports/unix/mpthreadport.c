@@ -36,12 +36,18 @@
 
 #include <signal.h>
 #include <sched.h>
+#include <semaphore.h>
 
 // this structure forms a linked list, one node per active thread
 typedef struct _thread_t {
     pthread_t id;           // system id of thread
     int ready;              // whether the thread is ready and running
     void *arg;              // thread Python args, a GC root pointer
+    mp_state_thread_t *state; // thread state, giving its stack_top and pystack
+    void **gc_sp;           // lowest stack address in use while stopped for GC
+    #if MICROPY_GC_PARALLEL_MARK
+    size_t gc_worker;       // number of this thread when it helps to mark, or 0
+    #endif
     struct _thread_t *next;
 } thread_t;
 
@@ -51,22 +57,59 @@ STATIC pthread_key_t tls_key;
 STATIC pthread_mutex_t thread_mutex = PTHREAD_MUTEX_INITIALIZER;
 STATIC thread_t *thread;
 
-// this is used to synchronise the signal handler of the thread
-// it's needed because we can't use any pthread calls in a signal handler
-STATIC volatile int thread_signal_done;
+// these are used to stop the other threads during a garbage collection
+// they're needed because we can't use any pthread calls in a signal handler
+// each handler posts thread_gc_stopped once its thread's roots are recorded,
+// then waits in sigsuspend until thread_gc_epoch changes, which is signalled
+// with SIGUSR2; with parallel marking the epoch first changes to let the
+// threads given a worker number mark, and they post thread_gc_stopped again
+// when that's done
+STATIC sem_t thread_gc_stopped;
+STATIC volatile sig_atomic_t thread_gc_epoch;
 
-// this signal handler is used to scan the regs and stack of a thread
+STATIC void mp_thread_gc_resume(int signo) {
+    (void)signo; // only used to wake up sigsuspend
+}
+
+// this signal handler is used to stop a thread and record its regs and stack
 STATIC void mp_thread_gc(int signo, siginfo_t *info, void *context) {
     (void)info; // unused
     (void)context; // unused
     if (signo == SIGUSR1) {
-        void gc_collect_regs_and_stack(void);
-        gc_collect_regs_and_stack();
-        // We have access to the context (regs, stack) of the thread but it seems
-        // that we don't need the extra information, enough is captured by the
-        // gc_collect_regs_and_stack function above
-        //gc_collect_root((void**)context, sizeof(ucontext_t) / sizeof(uintptr_t));
-        thread_signal_done = 1;
+        sig_atomic_t epoch = thread_gc_epoch;
+
+        // The registers of the interrupted code are saved by the kernel in the
+        // signal frame (the context), which lies on this thread's stack above
+        // the frame of this handler, so scanning from here up to stack_top
+        // covers them as well as the stack.
+        volatile mp_uint_t stack_dummy = 0;
+        thread_t *self = thread;
+        while (!pthread_equal(self->id, pthread_self())) {
+            self = self->next;
+        }
+        self->gc_sp = (void**)&stack_dummy;
+        sem_post(&thread_gc_stopped);
+
+        // wait until the collector has marked the roots of all threads; SIGUSR2
+        // is blocked while this handler runs except within sigsuspend
+        sigset_t mask;
+        sigfillset(&mask);
+        sigdelset(&mask, SIGUSR2);
+        #if MICROPY_GC_PARALLEL_MARK
+        // the epoch changes once the collector has given out worker numbers,
+        // and again when the threads may continue
+        while (thread_gc_epoch == epoch) {
+            sigsuspend(&mask);
+        }
+        if (self->gc_worker != 0) {
+            gc_mark_parallel(self->gc_worker);
+            sem_post(&thread_gc_stopped);
+        }
+        epoch += 1;
+        #endif
+        while (thread_gc_epoch == epoch) {
+            sigsuspend(&mask);
+        }
     }
 }
 
@@ -79,39 +122,133 @@ void mp_thread_init(void) {
     thread->id = pthread_self();
     thread->ready = 1;
     thread->arg = NULL;
+    thread->state = &mp_state_ctx.thread;
+    thread->gc_sp = NULL;
+    #if MICROPY_GC_PARALLEL_MARK
+    thread->gc_worker = 0;
+    #endif
     thread->next = NULL;
 
-    // enable signal handler for garbage collection
+    sem_init(&thread_gc_stopped, 0, 0);
+
+    // enable signal handlers for garbage collection
     struct sigaction sa;
     sa.sa_flags = SA_SIGINFO;
     sa.sa_sigaction = mp_thread_gc;
     sigemptyset(&sa.sa_mask);
+    sigaddset(&sa.sa_mask, SIGUSR2);
     sigaction(SIGUSR1, &sa, NULL);
+    sa.sa_flags = 0;
+    sa.sa_handler = mp_thread_gc_resume;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGUSR2, &sa, NULL);
 }
 
 // This function scans all pointers that are external to the current thread.
-// It does this by signalling all other threads and getting them to scan their
-// own registers and stack.  Note that there may still be some edge cases left
+// It stops all other threads at once by signalling them, waits until all of
+// them have recorded where their roots are, marks those roots and then lets
+// the threads continue.  Note that there may still be some edge cases left
 // with race conditions and root-pointer scanning: a given thread may manipulate
 // the global root pointers (in mp_state_ctx) while another thread is doing a
 // garbage collection and tracing these pointers.
 void mp_thread_gc_others(void) {
     pthread_mutex_lock(&thread_mutex);
+    size_t n_signalled = 0;
     for (thread_t *th = thread; th != NULL; th = th->next) {
         gc_collect_root(&th->arg, 1);
+        th->gc_sp = NULL;
         if (th->id == pthread_self()) {
             continue;
         }
         if (!th->ready) {
             continue;
         }
-        thread_signal_done = 0;
         pthread_kill(th->id, SIGUSR1);
-        while (thread_signal_done == 0) {
-            sched_yield();
+        n_signalled += 1;
+    }
+
+    // sleep until all the signalled threads have stopped
+    for (size_t i = 0; i < n_signalled; i++) {
+        while (sem_wait(&thread_gc_stopped) != 0) {
+            // interrupted by a signal, try again
+        }
+    }
+
+    #if MICROPY_GC_PARALLEL_MARK
+    // all threads are now stopped, so mark their stacks in parallel with the
+    // help of some of them, which mark from within their signal handler; the
+    // root ranges can't be malloc'd because a stopped thread may hold its lock
+    gc_root_range_t *roots = alloca(2 * (n_signalled + 1) * sizeof(gc_root_range_t));
+    size_t n_roots = 0;
+    size_t n_workers = 1;
+    for (thread_t *th = thread; th != NULL; th = th->next) {
+        if (th->gc_sp == NULL) {
+            continue;
+        }
+        mp_state_thread_t *ts = th->state;
+        roots[n_roots].ptrs = th->gc_sp;
+        roots[n_roots++].len = ((uintptr_t)ts->stack_top - (uintptr_t)th->gc_sp) / sizeof(uintptr_t);
+        #if MICROPY_ENABLE_PYSTACK
+        // the pystack of a thread is not traced by gc_collect_start
+        roots[n_roots].ptrs = (void**)(void*)ts->pystack_start;
+        roots[n_roots++].len = (ts->pystack_cur - ts->pystack_start) / sizeof(void*);
+        #endif
+        th->gc_worker = 0;
+        if (n_workers < MICROPY_GC_PARALLEL_MARK_WORKERS) {
+            th->gc_worker = n_workers++;
+        }
+    }
+    gc_mark_parallel_start(roots, n_roots, n_workers);
+    thread_gc_epoch += 1;
+    for (thread_t *th = thread; th != NULL; th = th->next) {
+        if (th->gc_sp != NULL && th->gc_worker != 0) {
+            pthread_kill(th->id, SIGUSR2);
+        }
+    }
+    gc_mark_parallel(0);
+    for (size_t i = 1; i < n_workers; i++) {
+        while (sem_wait(&thread_gc_stopped) != 0) {
+            // interrupted by a signal, try again
+        }
+    }
+    #else
+    // all threads are now stopped, so mark their stacks
+    for (thread_t *th = thread; th != NULL; th = th->next) {
+        if (th->gc_sp == NULL) {
+            continue;
+        }
+        mp_state_thread_t *ts = th->state;
+        gc_collect_root(th->gc_sp, ((uintptr_t)ts->stack_top - (uintptr_t)th->gc_sp) / sizeof(uintptr_t));
+        #if MICROPY_ENABLE_PYSTACK
+        // the pystack of a thread is not traced by gc_collect_start
+        gc_collect_root((void**)(void*)ts->pystack_start, (ts->pystack_cur - ts->pystack_start) / sizeof(void*));
+        #endif
+    }
+    #endif
+
+    // let the threads continue
+    thread_gc_epoch += 1;
+    for (thread_t *th = thread; th != NULL; th = th->next) {
+        if (th->gc_sp != NULL) {
+            pthread_kill(th->id, SIGUSR2);
+        }
+    }
+    pthread_mutex_unlock(&thread_mutex);
+}
+
+// Returns whether any thread besides the calling one may still use the heap,
+// including threads that have been created but haven't started running yet.
+bool mp_thread_unix_others_running(void) {
+    bool running = false;
+    pthread_mutex_lock(&thread_mutex);
+    for (thread_t *th = thread; th != NULL; th = th->next) {
+        if (!pthread_equal(th->id, pthread_self()) && (th->ready || th->state == NULL)) {
+            running = true;
+            break;
         }
     }
     pthread_mutex_unlock(&thread_mutex);
+    return running;
 }
 
 mp_state_thread_t *mp_thread_get_state(void) {
@@ -126,6 +263,7 @@ void mp_thread_start(void) {
     pthread_mutex_lock(&thread_mutex);
     for (thread_t *th = thread; th != NULL; th = th->next) {
         if (th->id == pthread_self()) {
+            th->state = mp_thread_get_state();
             th->ready = 1;
             break;
         }
@@ -174,6 +312,11 @@ void mp_thread_create(void *(*entry)(void*), void *arg, size_t *stack_size) {
     th->id = id;
     th->ready = 0;
     th->arg = arg;
+    th->state = NULL;
+    th->gc_sp = NULL;
+    #if MICROPY_GC_PARALLEL_MARK
+    th->gc_worker = 0;
+    #endif
     th->next = thread;
     thread = th;
 
@@ -24,9 +24,11 @@
  * THE SOFTWARE.
  */
 
+#include <stdbool.h>
 #include <pthread.h>
 
 typedef pthread_mutex_t mp_thread_mutex_t;
 
 void mp_thread_init(void);
 void mp_thread_gc_others(void);
+bool mp_thread_unix_others_running(void);
@@ -213,6 +213,31 @@ static inline void asm_thumb_ldrb_rlo_rlo_i5(asm_thumb_t *as, uint rlo_dest, uin
 static inline void asm_thumb_ldrh_rlo_rlo_i5(asm_thumb_t *as, uint rlo_dest, uint rlo_base, uint byte_offset)
     { asm_thumb_format_9_10(as, ASM_THUMB_FORMAT_10_LDRH, rlo_dest, rlo_base, byte_offset); }
 
+// VFP single-precision instructions, on registers s0-s31
+
+#define ASM_THUMB_VFP_OP_ADD (0x30)
+#define ASM_THUMB_VFP_OP_SUB (0x34)
+#define ASM_THUMB_VFP_OP_MUL (0x20)
+#define ASM_THUMB_VFP_OP_DIV (0x80)
+
+static inline void asm_thumb_vmov_sreg_reg(asm_thumb_t *as, uint sreg_dest, uint reg_src)
+    { asm_thumb_op32(as, 0xee00 | (sreg_dest >> 1), 0x0a10 | (reg_src << 12) | ((sreg_dest & 1) << 7)); }
+static inline void asm_thumb_vmov_reg_sreg(asm_thumb_t *as, uint reg_dest, uint sreg_src)
+    { asm_thumb_op32(as, 0xee10 | (sreg_src >> 1), 0x0a10 | (reg_dest << 12) | ((sreg_src & 1) << 7)); }
+static inline void asm_thumb_vfp_op(asm_thumb_t *as, uint op, uint sd, uint sn, uint sm) {
+    asm_thumb_op32(as, 0xee00 | (op & 0xf0) | ((sd & 1) << 6) | (sn >> 1),
+        0x0a00 | ((op & 0xf) << 4) | ((sd & 0x1e) << 11) | ((sn & 1) << 7) | ((sm & 1) << 5) | (sm >> 1));
+}
+static inline void asm_thumb_vfp_2reg(asm_thumb_t *as, uint op, uint sd, uint sm)
+    { asm_thumb_op32(as, op | ((sd & 1) << 6), 0x0ac0 | ((sd & 0x1e) << 11) | ((sm & 1) << 5) | (sm >> 1)); }
+static inline void asm_thumb_vcvt_f32_s32(asm_thumb_t *as, uint sd, uint sm) { asm_thumb_vfp_2reg(as, 0xeeb8, sd, sm); }
+static inline void asm_thumb_vcvt_s32_f32(asm_thumb_t *as, uint sd, uint sm) { asm_thumb_vfp_2reg(as, 0xeebd, sd, sm); }
+// vcmp.f32 followed by vmrs APSR_nzcv, FPSCR so the result can be used with conditional instructions
+static inline void asm_thumb_vcmp_f32(asm_thumb_t *as, uint sd, uint sm) {
+    asm_thumb_op32(as, 0xeeb4 | ((sd & 1) << 6), 0x0a40 | ((sd & 0x1e) << 11) | ((sm & 1) << 5) | (sm >> 1));
+    asm_thumb_op32(as, 0xeef1, 0xfa10);
+}
+
 // TODO convert these to above format style
 
 #define ASM_THUMB_OP_MOVW (0xf240)
@@ -83,6 +83,11 @@
 #define OPCODE_CALL_REL32        (0xe8)
 #define OPCODE_CALL_RM32         (0xff) /* /2 */
 #define OPCODE_LEAVE             (0xc9)
+#define OPCODE_MOVQ_R64_TO_XMM   (0x6e) /* 0x66 REX.W 0x0f 0x6e/r */
+#define OPCODE_MOVQ_XMM_TO_R64   (0x7e) /* 0x66 REX.W 0x0f 0x7e/r */
+#define OPCODE_CVTSI2S_R64_TO_XMM (0x2a) /* 0xf2/0xf3 REX.W 0x0f 0x2a/r */
+#define OPCODE_CVTTS2SI_XMM_TO_R64 (0x2c) /* 0xf2/0xf3 REX.W 0x0f 0x2c/r */
+#define OPCODE_UCOMIS_XMM_WITH_XMM (0x2e) /* [0x66] 0x0f 0x2e/r */
 
 #define MODRM_R64(x)    (((x) & 0x7) << 3)
 #define MODRM_RM_DISP0  (0x00)
@@ -92,6 +97,8 @@
 #define MODRM_RM_R64(x) ((x) & 0x7)
 
 #define OP_SIZE_PREFIX (0x66)
+#define SSE_SD_PREFIX (0xf2)
+#define SSE_SS_PREFIX (0xf3)
 
 #define REX_PREFIX  (0x40)
 #define REX_W       (0x08)  // width
@@ -183,19 +190,23 @@ STATIC void asm_x64_write_word32_to(asm_x64_t *as, int offset, int w32) {
 STATIC void asm_x64_write_r64_disp(asm_x64_t *as, int r64, int disp_r64, int disp_offset) {
     assert(disp_r64 != ASM_X64_REG_RSP);
 
-    if (disp_r64 == ASM_X64_REG_R12) {
-        // special case for r12; not fully implemented
-        assert(SIGNED_FIT8(disp_offset));
-        asm_x64_write_byte_3(as, MODRM_R64(r64) | MODRM_RM_DISP8 | MODRM_RM_R64(disp_r64), 0x24, IMM32_L0(disp_offset));
-        return;
-    }
-
-    if (disp_offset == 0 && disp_r64 != ASM_X64_REG_RBP) {
-        asm_x64_write_byte_1(as, MODRM_R64(r64) | MODRM_RM_DISP0 | MODRM_RM_R64(disp_r64));
+    // a base with low bits 101 (rbp, r13) has no disp0 form, and one with
+    // low bits 100 (r12) needs a SIB byte
+    int mod;
+    if (disp_offset == 0 && (disp_r64 & 7) != ASM_X64_REG_RBP) {
+        mod = MODRM_RM_DISP0;
     } else if (SIGNED_FIT8(disp_offset)) {
-        asm_x64_write_byte_2(as, MODRM_R64(r64) | MODRM_RM_DISP8 | MODRM_RM_R64(disp_r64), IMM32_L0(disp_offset));
+        mod = MODRM_RM_DISP8;
     } else {
-        asm_x64_write_byte_1(as, MODRM_R64(r64) | MODRM_RM_DISP32 | MODRM_RM_R64(disp_r64));
+        mod = MODRM_RM_DISP32;
+    }
+    asm_x64_write_byte_1(as, MODRM_R64(r64) | mod | MODRM_RM_R64(disp_r64));
+    if ((disp_r64 & 7) == ASM_X64_REG_RSP) {
+        asm_x64_write_byte_1(as, 0x24); // SIB with no index
+    }
+    if (mod == MODRM_RM_DISP8) {
+        asm_x64_write_byte_1(as, IMM32_L0(disp_offset));
+    } else if (mod == MODRM_RM_DISP32) {
         asm_x64_write_word32(as, disp_offset);
     }
 }
@@ -248,7 +259,8 @@ void asm_x64_mov_r64_r64(asm_x64_t *as, int dest_r64, int src_r64) {
 }
 
 void asm_x64_mov_r8_to_mem8(asm_x64_t *as, int src_r64, int dest_r64, int dest_disp) {
-    if (src_r64 < 8 && dest_r64 < 8) {
+    // the low byte of rsp, rbp, rsi and rdi can only be accessed with a REX prefix
+    if (src_r64 < 4 && dest_r64 < 8) {
         asm_x64_write_byte_1(as, OPCODE_MOV_R8_TO_RM8);
     } else {
         asm_x64_write_byte_2(as, REX_PREFIX | REX_R_FROM_R64(src_r64) | REX_B_FROM_R64(dest_r64), OPCODE_MOV_R8_TO_RM8);
@@ -281,31 +293,28 @@ void asm_x64_mov_r64_to_mem64(asm_x64_t *as, int src_r64, int dest_r64, int dest
 }
 
 void asm_x64_mov_mem8_to_r64zx(asm_x64_t *as, int src_r64, int src_disp, int dest_r64) {
-    assert(src_r64 < 8);
-    if (dest_r64 < 8) {
+    if (src_r64 < 8 && dest_r64 < 8) {
         asm_x64_write_byte_2(as, 0x0f, OPCODE_MOVZX_RM8_TO_R64);
     } else {
-        asm_x64_write_byte_3(as, REX_PREFIX | REX_R, 0x0f, OPCODE_MOVZX_RM8_TO_R64);
+        asm_x64_write_byte_3(as, REX_PREFIX | REX_R_FROM_R64(dest_r64) | REX_B_FROM_R64(src_r64), 0x0f, OPCODE_MOVZX_RM8_TO_R64);
     }
     asm_x64_write_r64_disp(as, dest_r64, src_r64, src_disp);
 }
 
 void asm_x64_mov_mem16_to_r64zx(asm_x64_t *as, int src_r64, int src_disp, int dest_r64) {
-    assert(src_r64 < 8);
-    if (dest_r64 < 8) {
+    if (src_r64 < 8 && dest_r64 < 8) {
         asm_x64_write_byte_2(as, 0x0f, OPCODE_MOVZX_RM16_TO_R64);
     } else {
-        asm_x64_write_byte_3(as, REX_PREFIX | REX_R, 0x0f, OPCODE_MOVZX_RM16_TO_R64);
+        asm_x64_write_byte_3(as, REX_PREFIX | REX_R_FROM_R64(dest_r64) | REX_B_FROM_R64(src_r64), 0x0f, OPCODE_MOVZX_RM16_TO_R64);
     }
     asm_x64_write_r64_disp(as, dest_r64, src_r64, src_disp);
 }
 
 void asm_x64_mov_mem32_to_r64zx(asm_x64_t *as, int src_r64, int src_disp, int dest_r64) {
-    assert(src_r64 < 8);
-    if (dest_r64 < 8) {
+    if (src_r64 < 8 && dest_r64 < 8) {
         asm_x64_write_byte_1(as, OPCODE_MOV_RM64_TO_R64);
     } else {
-        asm_x64_write_byte_2(as, REX_PREFIX | REX_R, OPCODE_MOV_RM64_TO_R64);
+        asm_x64_write_byte_2(as, REX_PREFIX | REX_R_FROM_R64(dest_r64) | REX_B_FROM_R64(src_r64), OPCODE_MOV_RM64_TO_R64);
     }
     asm_x64_write_r64_disp(as, dest_r64, src_r64, src_disp);
 }
@@ -476,6 +485,42 @@ void asm_x64_setcc_r8(asm_x64_t *as, int jcc_type, int dest_r8) {
     asm_x64_write_byte_3(as, OPCODE_SETCC_RM8_A, OPCODE_SETCC_RM8_B | jcc_type, MODRM_R64(0) | MODRM_RM_REG | MODRM_RM_R64(dest_r8));
 }
 
+// emit [prefix] [REX] 0x0f op modrm, with both operands being registers
+STATIC void asm_x64_sse_generic(asm_x64_t *as, int prefix, int rex_w, int op, int r64, int rm64) {
+    if (prefix != 0) {
+        asm_x64_write_byte_1(as, prefix);
+    }
+    int rex = rex_w | REX_R_FROM_R64(r64) | REX_B_FROM_R64(rm64);
+    if (rex != 0) {
+        asm_x64_write_byte_1(as, REX_PREFIX | rex);
+    }
+    asm_x64_write_byte_3(as, 0x0f, op, MODRM_R64(r64) | MODRM_RM_REG | MODRM_RM_R64(rm64));
+}
+
+void asm_x64_movq_r64_to_xmm(asm_x64_t *as, int src_r64, int dest_xmm) {
+    asm_x64_sse_generic(as, OP_SIZE_PREFIX, REX_W, OPCODE_MOVQ_R64_TO_XMM, dest_xmm, src_r64);
+}
+
+void asm_x64_movq_xmm_to_r64(asm_x64_t *as, int src_xmm, int dest_r64) {
+    asm_x64_sse_generic(as, OP_SIZE_PREFIX, REX_W, OPCODE_MOVQ_XMM_TO_R64, src_xmm, dest_r64);
+}
+
+void asm_x64_sse_op_xmm_xmm(asm_x64_t *as, bool dbl, int op, int dest_xmm, int src_xmm) {
+    asm_x64_sse_generic(as, dbl ? SSE_SD_PREFIX : SSE_SS_PREFIX, 0, op, dest_xmm, src_xmm);
+}
+
+void asm_x64_cvtsi2s_r64_to_xmm(asm_x64_t *as, bool dbl, int src_r64, int dest_xmm) {
+    asm_x64_sse_generic(as, dbl ? SSE_SD_PREFIX : SSE_SS_PREFIX, REX_W, OPCODE_CVTSI2S_R64_TO_XMM, dest_xmm, src_r64);
+}
+
+void asm_x64_cvtts2si_xmm_to_r64(asm_x64_t *as, bool dbl, int src_xmm, int dest_r64) {
+    asm_x64_sse_generic(as, dbl ? SSE_SD_PREFIX : SSE_SS_PREFIX, REX_W, OPCODE_CVTTS2SI_XMM_TO_R64, dest_r64, src_xmm);
+}
+
+void asm_x64_ucomis_xmm_with_xmm(asm_x64_t *as, bool dbl, int src_xmm_a, int src_xmm_b) {
+    asm_x64_sse_generic(as, dbl ? OP_SIZE_PREFIX : 0, 0, OPCODE_UCOMIS_XMM_WITH_XMM, src_xmm_a, src_xmm_b);
+}
+
 STATIC mp_uint_t get_label_dest(asm_x64_t *as, mp_uint_t label) {
     assert(label < as->base.max_num_labels);
     return as->base.label_offsets[label];
@@ -536,10 +581,14 @@ void asm_x64_entry(asm_x64_t *as, int num_locals) {
     asm_x64_push_r64(as, ASM_X64_REG_RBX);
     asm_x64_push_r64(as, ASM_X64_REG_R12);
     asm_x64_push_r64(as, ASM_X64_REG_R13);
+    asm_x64_push_r64(as, ASM_X64_REG_R14);
+    asm_x64_push_r64(as, ASM_X64_REG_R15);
     as->num_locals = num_locals;
 }
 
 void asm_x64_exit(asm_x64_t *as) {
+    asm_x64_pop_r64(as, ASM_X64_REG_R15);
+    asm_x64_pop_r64(as, ASM_X64_REG_R14);
     asm_x64_pop_r64(as, ASM_X64_REG_R13);
     asm_x64_pop_r64(as, ASM_X64_REG_R12);
     asm_x64_pop_r64(as, ASM_X64_REG_RBX);
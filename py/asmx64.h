@@ -61,15 +61,26 @@
 
 // condition codes, used for jcc and setcc (despite their j-name!)
 #define ASM_X64_CC_JB  (0x2) // below, unsigned
+#define ASM_X64_CC_JAE (0x3) // above or equal, unsigned
 #define ASM_X64_CC_JZ  (0x4)
 #define ASM_X64_CC_JE  (0x4)
 #define ASM_X64_CC_JNZ (0x5)
 #define ASM_X64_CC_JNE (0x5)
+#define ASM_X64_CC_JA  (0x7) // above, unsigned
+#define ASM_X64_CC_JP  (0xa) // parity (unordered after ucomis)
+#define ASM_X64_CC_JNP (0xb)
 #define ASM_X64_CC_JL  (0xc) // less, signed
 #define ASM_X64_CC_JGE (0xd) // greater or equal, signed
 #define ASM_X64_CC_JLE (0xe) // less or equal, signed
 #define ASM_X64_CC_JG  (0xf) // greater, signed
 
+// scalar SSE ops, for asm_x64_sse_op_xmm_xmm
+#define ASM_X64_SSE_OP_ADD (0x58)
+#define ASM_X64_SSE_OP_MUL (0x59)
+#define ASM_X64_SSE_OP_CVT (0x5a) // convert to the other precision
+#define ASM_X64_SSE_OP_SUB (0x5c)
+#define ASM_X64_SSE_OP_DIV (0x5e)
+
 typedef struct _asm_x64_t {
     mp_asm_base_t base;
     int num_locals;
@@ -105,6 +116,13 @@ void asm_x64_mul_r64_r64(asm_x64_t* as, int dest_r64, int src_r64);
 void asm_x64_cmp_r64_with_r64(asm_x64_t* as, int src_r64_a, int src_r64_b);
 void asm_x64_test_r8_with_r8(asm_x64_t* as, int src_r64_a, int src_r64_b);
 void asm_x64_setcc_r8(asm_x64_t* as, int jcc_type, int dest_r8);
+// the SSE functions take dbl to select double (sd) or single (ss) precision
+void asm_x64_movq_r64_to_xmm(asm_x64_t *as, int src_r64, int dest_xmm);
+void asm_x64_movq_xmm_to_r64(asm_x64_t *as, int src_xmm, int dest_r64);
+void asm_x64_sse_op_xmm_xmm(asm_x64_t *as, bool dbl, int op, int dest_xmm, int src_xmm);
+void asm_x64_cvtsi2s_r64_to_xmm(asm_x64_t *as, bool dbl, int src_r64, int dest_xmm);
+void asm_x64_cvtts2si_xmm_to_r64(asm_x64_t *as, bool dbl, int src_xmm, int dest_r64);
+void asm_x64_ucomis_xmm_with_xmm(asm_x64_t *as, bool dbl, int src_xmm_a, int src_xmm_b);
 void asm_x64_jmp_label(asm_x64_t* as, mp_uint_t label);
 void asm_x64_jcc_label(asm_x64_t* as, int jcc_type, mp_uint_t label);
 void asm_x64_entry(asm_x64_t* as, int num_locals);
@@ -137,7 +155,9 @@ void asm_x64_call_ind(asm_x64_t* as, void* ptr, int temp_r32);
 #define REG_LOCAL_1 ASM_X64_REG_RBX
 #define REG_LOCAL_2 ASM_X64_REG_R12
 #define REG_LOCAL_3 ASM_X64_REG_R13
-#define REG_LOCAL_NUM (3)
+#define REG_LOCAL_4 ASM_X64_REG_R14
+#define REG_LOCAL_5 ASM_X64_REG_R15
+#define REG_LOCAL_NUM (5)
 
 #define ASM_T               asm_x64_t
 #define ASM_END_PASS        asm_x64_end_pass
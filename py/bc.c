@@ -70,6 +70,25 @@ const byte *mp_decode_uint_skip(const byte *ptr) {
     return ptr;
 }
 
+const byte mp_bc_fast_int_op[16] = {
+    MP_BINARY_OP_LESS,
+    MP_BINARY_OP_MORE,
+    MP_BINARY_OP_EQUAL,
+    MP_BINARY_OP_LESS_EQUAL,
+    MP_BINARY_OP_MORE_EQUAL,
+    MP_BINARY_OP_NOT_EQUAL,
+    MP_BINARY_OP_INPLACE_ADD,
+    MP_BINARY_OP_INPLACE_SUBTRACT,
+    MP_BINARY_OP_ADD,
+    MP_BINARY_OP_SUBTRACT,
+    MP_BINARY_OP_MULTIPLY,
+    MP_BINARY_OP_FLOOR_DIVIDE,
+    MP_BINARY_OP_MODULO,
+    MP_BINARY_OP_AND,
+    MP_BINARY_OP_OR,
+    MP_BINARY_OP_RSHIFT,
+};
+
 STATIC NORETURN void fun_pos_args_mismatch(mp_obj_fun_bc_t *f, size_t expected, size_t given) {
 #if MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE
     // generic message, used also for other argument issues
@@ -315,19 +334,19 @@ STATIC const byte opcode_format_table[64] = {
     OC4(B, B, V, V), // 0x20-0x23
     OC4(Q, Q, Q, B), // 0x24-0x27
     OC4(V, V, Q, Q), // 0x28-0x2b
-    OC4(U, U, U, U), // 0x2c-0x2f
+    OC4(B, B, U, U), // 0x2c-0x2f
     OC4(B, B, B, B), // 0x30-0x33
     OC4(B, O, O, O), // 0x34-0x37
     OC4(O, O, U, U), // 0x38-0x3b
     OC4(U, O, B, O), // 0x3c-0x3f
     OC4(O, B, B, O), // 0x40-0x43
     OC4(B, B, O, B), // 0x44-0x47
-    OC4(U, U, U, U), // 0x48-0x4b
+    OC4(O, U, U, U), // 0x48-0x4b
     OC4(U, U, U, U), // 0x4c-0x4f
     OC4(V, V, U, V), // 0x50-0x53
     OC4(B, U, V, V), // 0x54-0x57
     OC4(V, V, V, B), // 0x58-0x5b
-    OC4(B, B, B, U), // 0x5c-0x5f
+    OC4(B, B, B, B), // 0x5c-0x5f
     OC4(V, V, V, V), // 0x60-0x63
     OC4(V, V, V, V), // 0x64-0x67
     OC4(Q, Q, B, U), // 0x68-0x6b
@@ -390,6 +409,8 @@ uint mp_opcode_format(const byte *ip, size_t *opcode_size) {
     } else {
         int extra_byte = (
             *ip == MP_BC_RAISE_VARARGS
+            || *ip == MP_BC_LOAD_FAST_PAIR
+            || *ip == MP_BC_BINARY_OP_POP_JUMP_IF
             || *ip == MP_BC_MAKE_CLOSURE
             || *ip == MP_BC_MAKE_CLOSURE_DEFARGS
             #if MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE
@@ -399,6 +420,10 @@ uint mp_opcode_format(const byte *ip, size_t *opcode_size) {
             || *ip == MP_BC_STORE_ATTR
             #endif
         );
+        if (*ip == MP_BC_LOAD_FAST_INT_OP) {
+            // local num and op, then the small int
+            extra_byte = 2;
+        }
         ip += 1;
         if (f == MP_OPCODE_VAR_UINT) {
             while ((*ip++ & 0x80) != 0) {
@@ -89,6 +89,10 @@ typedef struct _mp_code_state_t {
     //mp_exc_stack_t exc_state[0];
 } mp_code_state_t;
 
+// The binary ops that MP_BC_LOAD_FAST_INT_OP can encode, indexed by the low
+// 4 bits of its first argument byte
+extern const byte mp_bc_fast_int_op[16];
+
 mp_uint_t mp_decode_uint(const byte **ptr);
 mp_uint_t mp_decode_uint_value(const byte *ptr);
 const byte *mp_decode_uint_skip(const byte *ptr);
@@ -59,6 +59,9 @@
 #define MP_BC_DELETE_NAME        (0x2a) // qstr
 #define MP_BC_DELETE_GLOBAL      (0x2b) // qstr
 
+#define MP_BC_LOAD_FAST_PAIR     (0x2c) // byte: 2 local nums, each < 16
+#define MP_BC_LOAD_FAST_INT_OP   (0x2d) // byte: local num << 4 | index in mp_bc_fast_int_op; then a signed byte
+
 #define MP_BC_DUP_TOP            (0x30)
 #define MP_BC_DUP_TOP_TWO        (0x31)
 #define MP_BC_POP_TOP            (0x32)
@@ -81,6 +84,7 @@
 #define MP_BC_POP_EXCEPT         (0x45)
 #define MP_BC_UNWIND_JUMP        (0x46) // rel byte code offset, 16-bit signed, in excess; then a byte
 #define MP_BC_GET_ITER_STACK     (0x47)
+#define MP_BC_BINARY_OP_POP_JUMP_IF  (0x48) // rel byte code offset, 16-bit signed, in excess; then a byte: op | cond << 7
 
 #define MP_BC_BUILD_TUPLE        (0x50) // uint
 #define MP_BC_BUILD_LIST         (0x51) // uint
@@ -96,6 +100,7 @@
 #define MP_BC_RAISE_VARARGS      (0x5c) // byte
 #define MP_BC_YIELD_VALUE        (0x5d)
 #define MP_BC_YIELD_FROM         (0x5e)
+#define MP_BC_RETURN_NONE        (0x5f)
 
 #define MP_BC_MAKE_FUNCTION         (0x60) // uint
 #define MP_BC_MAKE_FUNCTION_DEFARGS (0x61) // uint
@@ -2166,7 +2166,89 @@ STATIC void compile_factor_2(compiler_t *comp, mp_parse_node_struct_t *pns) {
     EMIT_ARG(unary_op, op);
 }
 
+#if MICROPY_COMP_OPTIMISE
+// Fold a constant subscript that is being loaded: "str"[i], b"bytes"[i],
+// (a, b, ...)[i] or [a, b, ...][i], where i is a small int and the base is
+// made only of constant leaves.  This is done here rather than in the parser
+// so that subscripts used as store, delete and augmented-assignment targets
+// are left alone.  Returns true if the folded value was emitted.
+STATIC bool compile_const_subscript(compiler_t *comp, mp_parse_node_t pn_base, mp_parse_node_struct_t *pns_trail) {
+    mp_parse_node_t pn_index = pns_trail->nodes[0];
+    if (!MP_PARSE_NODE_IS_SMALL_INT(pn_index)) {
+        return false;
+    }
+    mp_int_t index = MP_PARSE_NODE_LEAF_SMALL_INT(pn_index);
+    if (MP_PARSE_NODE_IS_LEAF(pn_base)
+        && (MP_PARSE_NODE_LEAF_KIND(pn_base) == MP_PARSE_NODE_STRING
+        || MP_PARSE_NODE_LEAF_KIND(pn_base) == MP_PARSE_NODE_BYTES)) {
+        size_t len;
+        const byte *data = qstr_data(MP_PARSE_NODE_LEAF_ARG(pn_base), &len);
+        if (index < 0) {
+            index += len;
+        }
+        if (index < 0 || (size_t)index >= len) {
+            return false;
+        }
+        if (MP_PARSE_NODE_LEAF_KIND(pn_base) == MP_PARSE_NODE_BYTES) {
+            EMIT_ARG(load_const_small_int, data[index]);
+        } else {
+            // only fold ASCII strings, where byte and character indices agree
+            for (size_t i = 0; i < len; ++i) {
+                if (data[i] >= 0x80) {
+                    return false;
+                }
+            }
+            EMIT_ARG(load_const_str, qstr_from_strn((const char*)data + index, 1));
+        }
+        return true;
+    } else if (MP_PARSE_NODE_IS_STRUCT_KIND(pn_base, PN_atom_paren)
+        || MP_PARSE_NODE_IS_STRUCT_KIND(pn_base, PN_atom_bracket)) {
+        mp_parse_node_t pn_list = ((mp_parse_node_struct_t*)pn_base)->nodes[0];
+        if (!MP_PARSE_NODE_IS_STRUCT_KIND(pn_list, PN_testlist_comp)) {
+            return false;
+        }
+        // a testlist_comp holds the first item and then either the second item,
+        // a trailing comma (testlist_comp_3b), the remaining items (testlist_comp_3c)
+        // or a comprehension
+        mp_parse_node_struct_t *pns_list = (mp_parse_node_struct_t*)pn_list;
+        mp_parse_node_t *rest = &pns_list->nodes[1];
+        size_t len = 2;
+        if (MP_PARSE_NODE_IS_STRUCT_KIND(*rest, PN_testlist_comp_3b)) {
+            len = 1;
+        } else if (MP_PARSE_NODE_IS_STRUCT_KIND(*rest, PN_testlist_comp_3c)) {
+            mp_parse_node_struct_t *pns_rest = (mp_parse_node_struct_t*)*rest;
+            rest = pns_rest->nodes;
+            len = 1 + MP_PARSE_NODE_STRUCT_NUM_NODES(pns_rest);
+        }
+        for (size_t i = 0; i < len; ++i) {
+            // any struct (comprehension, star_expr, nested expression) or name prevents folding
+            mp_parse_node_t pn = i == 0 ? pns_list->nodes[0] : rest[i - 1];
+            if (!MP_PARSE_NODE_IS_LEAF(pn) || MP_PARSE_NODE_IS_ID(pn)) {
+                return false;
+            }
+        }
+        if (index < 0) {
+            index += len;
+        }
+        if (index < 0 || (size_t)index >= len) {
+            return false;
+        }
+        compile_node(comp, index == 0 ? pns_list->nodes[0] : rest[index - 1]);
+        return true;
+    }
+    return false;
+}
+#endif
+
 STATIC void compile_atom_expr_normal(compiler_t *comp, mp_parse_node_struct_t *pns) {
+    #if MICROPY_COMP_OPTIMISE
+    if (MP_STATE_VM(mp_optimise_value) >= 1
+        && MP_PARSE_NODE_IS_STRUCT_KIND(pns->nodes[1], PN_trailer_bracket)
+        && compile_const_subscript(comp, pns->nodes[0], (mp_parse_node_struct_t*)pns->nodes[1])) {
+        return;
+    }
+    #endif
+
     // compile the subject of the expression
     compile_node(comp, pns->nodes[0]);
 
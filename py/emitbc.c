@@ -33,12 +33,21 @@
 #include "py/mpstate.h"
 #include "py/emit.h"
 #include "py/bc0.h"
+#include "py/bc.h"
 
 #if MICROPY_ENABLE_COMPILER
 
 #define BYTES_FOR_INT ((BYTES_PER_WORD * 8 + 6) / 7)
 #define DUMMY_DATA_SIZE (BYTES_FOR_INT)
 
+#if MICROPY_COMP_OPTIMISE
+// maximum number of labels at the same offset that jumps can be threaded through
+#define LABEL_RUN_MAX (4)
+#define EMIT_DEAD(emit) ((emit)->dead)
+#else
+#define EMIT_DEAD(emit) (false)
+#endif
+
 struct _emit_t {
     // Accessed as mp_obj_t, so must be aligned as such, and we rely on the
     // memory allocator returning a suitably aligned pointer.
@@ -58,6 +67,25 @@ struct _emit_t {
     mp_uint_t max_num_labels;
     mp_uint_t *label_offsets;
 
+    #if MICROPY_COMP_OPTIMISE
+    // Optimisations done when opt_level >= 1.  They are decided from the
+    // sequence of emit calls alone, so the code size is the same in the
+    // MP_PASS_CODE_SIZE and MP_PASS_EMIT passes.
+    bool opt;
+    bool dead; // last instruction was a jump, return or raise; no label since
+    byte last_op; // valid if the instruction ended at last_op_end
+    byte prev_op; // the instruction just before last_op, if prev_op_offset is valid
+    size_t last_op_offset;
+    size_t last_op_end;
+    size_t prev_op_offset;
+    // labels assigned at label_run_offset, and for each label the label its
+    // unconditional jump goes to, found in MP_PASS_CODE_SIZE
+    size_t label_run_offset;
+    byte label_run_len;
+    mp_uint_t label_run[LABEL_RUN_MAX];
+    mp_uint_t *label_jumps;
+    #endif
+
     size_t code_info_offset;
     size_t code_info_size;
     size_t bytecode_offset;
@@ -80,10 +108,16 @@ emit_t *emit_bc_new(void) {
 void emit_bc_set_max_num_labels(emit_t *emit, mp_uint_t max_num_labels) {
     emit->max_num_labels = max_num_labels;
     emit->label_offsets = m_new(mp_uint_t, emit->max_num_labels);
+    #if MICROPY_COMP_OPTIMISE
+    emit->label_jumps = m_new(mp_uint_t, emit->max_num_labels);
+    #endif
 }
 
 void emit_bc_free(emit_t *emit) {
     m_del(mp_uint_t, emit->label_offsets, emit->max_num_labels);
+    #if MICROPY_COMP_OPTIMISE
+    m_del(mp_uint_t, emit->label_jumps, emit->max_num_labels);
+    #endif
     m_del_obj(emit_t, emit);
 }
 
@@ -171,7 +205,10 @@ STATIC void emit_write_code_info_bytes_lines(emit_t *emit, mp_uint_t bytes_to_sk
 // all functions must go through this one to emit byte code
 STATIC byte *emit_get_cur_to_write_bytecode(emit_t *emit, int num_bytes_to_write) {
     //printf("emit %d\n", num_bytes_to_write);
-    if (emit->pass < MP_PASS_EMIT) {
+    if (EMIT_DEAD(emit)) {
+        // unreachable code is discarded
+        return emit->dummy_data;
+    } else if (emit->pass < MP_PASS_EMIT) {
         emit->bytecode_offset += num_bytes_to_write;
         return emit->dummy_data;
     } else {
@@ -254,7 +291,9 @@ STATIC void emit_write_bytecode_byte_obj(emit_t *emit, byte b, mp_obj_t obj) {
     #else
     // aligns the pointer so it is friendly to GC
     emit_write_bytecode_byte(emit, b);
-    emit->bytecode_offset = (size_t)MP_ALIGN(emit->bytecode_offset, sizeof(mp_obj_t));
+    if (!EMIT_DEAD(emit)) {
+        emit->bytecode_offset = (size_t)MP_ALIGN(emit->bytecode_offset, sizeof(mp_obj_t));
+    }
     mp_obj_t *c = (mp_obj_t*)emit_get_cur_to_write_bytecode(emit, sizeof(mp_obj_t));
     // Verify thar c is already uint-aligned
     assert(c == MP_ALIGN(c, sizeof(mp_obj_t)));
@@ -270,7 +309,9 @@ STATIC void emit_write_bytecode_byte_raw_code(emit_t *emit, byte b, mp_raw_code_
     #else
     // aligns the pointer so it is friendly to GC
     emit_write_bytecode_byte(emit, b);
-    emit->bytecode_offset = (size_t)MP_ALIGN(emit->bytecode_offset, sizeof(void*));
+    if (!EMIT_DEAD(emit)) {
+        emit->bytecode_offset = (size_t)MP_ALIGN(emit->bytecode_offset, sizeof(void*));
+    }
     void **c = (void**)emit_get_cur_to_write_bytecode(emit, sizeof(void*));
     // Verify thar c is already uint-aligned
     assert(c == MP_ALIGN(c, sizeof(void*)));
@@ -292,12 +333,60 @@ STATIC void emit_write_bytecode_byte_unsigned_label(emit_t *emit, byte b1, mp_ui
     c[2] = bytecode_offset >> 8;
 }
 
+#if MICROPY_COMP_OPTIMISE
+// The last emitted opcode, or -1 if it can't be changed: optimisations are
+// off, or there was a label or line number after it.
+STATIC int emit_bc_opt_last_op(emit_t *emit) {
+    if (emit->opt && !emit->dead && emit->last_op_end == emit->bytecode_offset) {
+        return emit->last_op;
+    }
+    return -1;
+}
+
+STATIC void emit_bc_opt_record_op(emit_t *emit, byte op, size_t offset) {
+    if (emit->last_op_end == offset) {
+        emit->prev_op = emit->last_op;
+        emit->prev_op_offset = emit->last_op_offset;
+    } else {
+        emit->prev_op_offset = (size_t)-1;
+    }
+    emit->last_op = op;
+    emit->last_op_offset = offset;
+    emit->last_op_end = emit->bytecode_offset;
+}
+
+// Called after an instruction that never continues to the next one
+STATIC void emit_bc_opt_end_block(emit_t *emit) {
+    emit->dead = emit->opt;
+}
+
+// Follow a label to the final target of any unconditional jumps at it
+STATIC mp_uint_t emit_bc_opt_jump_target(emit_t *emit, mp_uint_t label) {
+    for (int i = 0; i < 8; ++i) {
+        mp_uint_t next = emit->label_jumps[label];
+        if (next == (mp_uint_t)-1 || next == label) {
+            break;
+        }
+        label = next;
+    }
+    return label;
+}
+#else
+#define emit_bc_opt_record_op(emit, op, offset) (void)(offset)
+#define emit_bc_opt_end_block(emit)
+#endif
+
 // signed labels are relative to ip following this instruction, stored as 16 bits, in excess
 STATIC void emit_write_bytecode_byte_signed_label(emit_t *emit, byte b1, mp_uint_t label) {
     int bytecode_offset;
     if (emit->pass < MP_PASS_EMIT) {
         bytecode_offset = 0;
     } else {
+        #if MICROPY_COMP_OPTIMISE
+        if (emit->opt) {
+            label = emit_bc_opt_jump_target(emit, label);
+        }
+        #endif
         bytecode_offset = emit->label_offsets[label] - emit->bytecode_offset - 3 + 0x8000;
     }
     byte *c = emit_get_cur_to_write_bytecode(emit, 3);
@@ -316,6 +405,16 @@ void mp_emit_bc_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scope) {
     if (pass < MP_PASS_EMIT) {
         memset(emit->label_offsets, -1, emit->max_num_labels * sizeof(mp_uint_t));
     }
+    #if MICROPY_COMP_OPTIMISE
+    emit->opt = MP_STATE_VM(mp_optimise_value) >= 1;
+    emit->dead = false;
+    emit->last_op_end = (size_t)-1;
+    emit->label_run_offset = (size_t)-1;
+    emit->label_run_len = 0;
+    if (pass == MP_PASS_CODE_SIZE) {
+        memset(emit->label_jumps, -1, emit->max_num_labels * sizeof(mp_uint_t));
+    }
+    #endif
     emit->bytecode_offset = 0;
     emit->code_info_offset = 0;
 
@@ -476,6 +575,10 @@ void mp_emit_bc_set_source_line(emit_t *emit, mp_uint_t source_line) {
         emit_write_code_info_bytes_lines(emit, bytes_to_skip, lines_to_skip);
         emit->last_source_line_offset = emit->bytecode_offset;
         emit->last_source_line = source_line;
+        #if MICROPY_COMP_OPTIMISE
+        // code before this point can no longer be removed
+        emit->last_op_end = (size_t)-1;
+        #endif
     }
 #else
     (void)emit;
@@ -498,6 +601,19 @@ void mp_emit_bc_label_assign(emit_t *emit, mp_uint_t l) {
         //printf("l%d: (at %d vs %d)\n", l, emit->bytecode_offset, emit->label_offsets[l]);
         assert(emit->label_offsets[l] == emit->bytecode_offset);
     }
+    #if MICROPY_COMP_OPTIMISE
+    emit->dead = false;
+    emit->last_op_end = (size_t)-1;
+    if (emit->pass == MP_PASS_CODE_SIZE) {
+        if (emit->label_run_offset != emit->bytecode_offset) {
+            emit->label_run_offset = emit->bytecode_offset;
+            emit->label_run_len = 0;
+        }
+        if (emit->label_run_len < LABEL_RUN_MAX) {
+            emit->label_run[emit->label_run_len++] = l;
+        }
+    }
+    #endif
 }
 
 void mp_emit_bc_import_name(emit_t *emit, qstr qst) {
@@ -517,21 +633,27 @@ void mp_emit_bc_import_star(emit_t *emit) {
 
 void mp_emit_bc_load_const_tok(emit_t *emit, mp_token_kind_t tok) {
     emit_bc_pre(emit, 1);
+    byte op;
     switch (tok) {
-        case MP_TOKEN_KW_FALSE: emit_write_bytecode_byte(emit, MP_BC_LOAD_CONST_FALSE); break;
-        case MP_TOKEN_KW_NONE: emit_write_bytecode_byte(emit, MP_BC_LOAD_CONST_NONE); break;
-        case MP_TOKEN_KW_TRUE: emit_write_bytecode_byte(emit, MP_BC_LOAD_CONST_TRUE); break;
+        case MP_TOKEN_KW_FALSE: op = MP_BC_LOAD_CONST_FALSE; break;
+        case MP_TOKEN_KW_NONE: op = MP_BC_LOAD_CONST_NONE; break;
+        case MP_TOKEN_KW_TRUE: op = MP_BC_LOAD_CONST_TRUE; break;
         default:
             assert(tok == MP_TOKEN_ELLIPSIS);
             emit_write_bytecode_byte_obj(emit, MP_BC_LOAD_CONST_OBJ, MP_OBJ_FROM_PTR(&mp_const_ellipsis_obj));
-            break;
+            return;
     }
+    size_t offset = emit->bytecode_offset;
+    emit_write_bytecode_byte(emit, op);
+    emit_bc_opt_record_op(emit, op, offset);
 }
 
 void mp_emit_bc_load_const_small_int(emit_t *emit, mp_int_t arg) {
     emit_bc_pre(emit, 1);
     if (-16 <= arg && arg <= 47) {
+        size_t offset = emit->bytecode_offset;
         emit_write_bytecode_byte(emit, MP_BC_LOAD_CONST_SMALL_INT_MULTI + 16 + arg);
+        emit_bc_opt_record_op(emit, MP_BC_LOAD_CONST_SMALL_INT_MULTI + 16 + arg, offset);
     } else {
         emit_write_bytecode_byte_int(emit, MP_BC_LOAD_CONST_SMALL_INT, arg);
     }
@@ -556,7 +678,21 @@ void mp_emit_bc_load_fast(emit_t *emit, qstr qst, mp_uint_t local_num) {
     (void)qst;
     emit_bc_pre(emit, 1);
     if (local_num <= 15) {
+        size_t offset = emit->bytecode_offset;
+        #if MICROPY_COMP_OPTIMISE
+        int last = emit_bc_opt_last_op(emit);
+        if (last >= MP_BC_LOAD_FAST_MULTI && last < MP_BC_LOAD_FAST_MULTI + 16) {
+            // LOAD_FAST a; LOAD_FAST b -> LOAD_FAST_PAIR (a << 4 | b)
+            if (emit->pass == MP_PASS_EMIT) {
+                emit->code_base[emit->code_info_size + emit->last_op_offset] = MP_BC_LOAD_FAST_PAIR;
+            }
+            emit_write_bytecode_byte(emit, (last - MP_BC_LOAD_FAST_MULTI) << 4 | local_num);
+            emit_bc_opt_record_op(emit, MP_BC_LOAD_FAST_PAIR, emit->last_op_offset);
+            return;
+        }
+        #endif
         emit_write_bytecode_byte(emit, MP_BC_LOAD_FAST_MULTI + local_num);
+        emit_bc_opt_record_op(emit, MP_BC_LOAD_FAST_MULTI + local_num, offset);
     } else {
         emit_write_bytecode_byte_uint(emit, MP_BC_LOAD_FAST_N, local_num);
     }
@@ -682,7 +818,9 @@ void mp_emit_bc_delete_subscr(emit_t *emit) {
 
 void mp_emit_bc_dup_top(emit_t *emit) {
     emit_bc_pre(emit, 1);
+    size_t offset = emit->bytecode_offset;
     emit_write_bytecode_byte(emit, MP_BC_DUP_TOP);
+    emit_bc_opt_record_op(emit, MP_BC_DUP_TOP, offset);
 }
 
 void mp_emit_bc_dup_top_two(emit_t *emit) {
@@ -692,6 +830,17 @@ void mp_emit_bc_dup_top_two(emit_t *emit) {
 
 void mp_emit_bc_pop_top(emit_t *emit) {
     emit_bc_pre(emit, -1);
+    #if MICROPY_COMP_OPTIMISE
+    int last = emit_bc_opt_last_op(emit);
+    if ((last >= MP_BC_LOAD_CONST_FALSE && last <= MP_BC_LOAD_CONST_TRUE)
+        || (last >= MP_BC_LOAD_CONST_SMALL_INT_MULTI && last < MP_BC_LOAD_CONST_SMALL_INT_MULTI + 64)
+        || last == MP_BC_DUP_TOP) {
+        // a value pushed with no side effects and discarded straight away
+        emit->bytecode_offset = emit->last_op_offset;
+        emit->last_op_end = (size_t)-1;
+        return;
+    }
+    #endif
     emit_write_bytecode_byte(emit, MP_BC_POP_TOP);
 }
 
@@ -707,11 +856,33 @@ void mp_emit_bc_rot_three(emit_t *emit) {
 
 void mp_emit_bc_jump(emit_t *emit, mp_uint_t label) {
     emit_bc_pre(emit, 0);
+    #if MICROPY_COMP_OPTIMISE
+    if (emit->opt && !emit->dead && emit->pass == MP_PASS_CODE_SIZE
+        && emit->label_run_offset == emit->bytecode_offset) {
+        // the labels here lead straight to another label, so jumps to them
+        // can go there directly
+        for (size_t i = 0; i < emit->label_run_len; ++i) {
+            emit->label_jumps[emit->label_run[i]] = label;
+        }
+    }
+    #endif
     emit_write_bytecode_byte_signed_label(emit, MP_BC_JUMP, label);
+    emit_bc_opt_end_block(emit);
 }
 
 void mp_emit_bc_pop_jump_if(emit_t *emit, bool cond, mp_uint_t label) {
     emit_bc_pre(emit, -1);
+    #if MICROPY_COMP_OPTIMISE
+    int last = emit_bc_opt_last_op(emit);
+    if (last >= MP_BC_BINARY_OP_MULTI && last < MP_BC_BINARY_OP_MULTI + MP_BINARY_OP_NUM_BYTECODE) {
+        // BINARY_OP op; POP_JUMP_IF cond -> BINARY_OP_POP_JUMP_IF op | cond << 7
+        emit->bytecode_offset = emit->last_op_offset;
+        emit->last_op_end = (size_t)-1;
+        emit_write_bytecode_byte_signed_label(emit, MP_BC_BINARY_OP_POP_JUMP_IF, label);
+        emit_write_bytecode_byte(emit, (last - MP_BC_BINARY_OP_MULTI) | (cond << 7));
+        return;
+    }
+    #endif
     if (cond) {
         emit_write_bytecode_byte_signed_label(emit, MP_BC_POP_JUMP_IF_TRUE, label);
     } else {
@@ -744,6 +915,7 @@ void mp_emit_bc_unwind_jump(emit_t *emit, mp_uint_t label, mp_uint_t except_dept
         emit_write_bytecode_byte_signed_label(emit, MP_BC_UNWIND_JUMP, label & ~MP_EMIT_BREAK_FROM_FOR);
         emit_write_bytecode_byte(emit, ((label & MP_EMIT_BREAK_FROM_FOR) ? 0x80 : 0) | except_depth);
     }
+    emit_bc_opt_end_block(emit);
 }
 
 void mp_emit_bc_setup_with(emit_t *emit, mp_uint_t label) {
@@ -816,7 +988,35 @@ void mp_emit_bc_binary_op(emit_t *emit, mp_binary_op_t op) {
         op = MP_BINARY_OP_IS;
     }
     emit_bc_pre(emit, -1);
+    #if MICROPY_COMP_OPTIMISE
+    if (!invert) {
+        int last = emit_bc_opt_last_op(emit);
+        if (last >= MP_BC_LOAD_CONST_SMALL_INT_MULTI && last < MP_BC_LOAD_CONST_SMALL_INT_MULTI + 64
+            && emit->prev_op_offset != (size_t)-1
+            && emit->prev_op >= MP_BC_LOAD_FAST_MULTI && emit->prev_op < MP_BC_LOAD_FAST_MULTI + 16) {
+            for (size_t i = 0; i < MP_ARRAY_SIZE(mp_bc_fast_int_op); ++i) {
+                if (mp_bc_fast_int_op[i] == op) {
+                    // LOAD_FAST a; LOAD_CONST_SMALL_INT n; BINARY_OP op
+                    //   -> LOAD_FAST_INT_OP (a << 4 | index of op), n
+                    size_t offset = emit->prev_op_offset;
+                    byte arg = (emit->prev_op - MP_BC_LOAD_FAST_MULTI) << 4 | i;
+                    emit->bytecode_offset = offset;
+                    byte *c = emit_get_cur_to_write_bytecode(emit, 3);
+                    c[0] = MP_BC_LOAD_FAST_INT_OP;
+                    c[1] = arg;
+                    c[2] = last - MP_BC_LOAD_CONST_SMALL_INT_MULTI - 16;
+                    emit_bc_opt_record_op(emit, MP_BC_LOAD_FAST_INT_OP, offset);
+                    return;
+                }
+            }
+        }
+    }
+    #endif
+    size_t offset = emit->bytecode_offset;
     emit_write_bytecode_byte(emit, MP_BC_BINARY_OP_MULTI + op);
+    if (!invert) {
+        emit_bc_opt_record_op(emit, MP_BC_BINARY_OP_MULTI + op, offset);
+    }
     if (invert) {
         emit_bc_pre(emit, 0);
         emit_write_bytecode_byte(emit, MP_BC_UNARY_OP_MULTI + MP_UNARY_OP_NOT);
@@ -929,13 +1129,23 @@ void mp_emit_bc_call_method(emit_t *emit, mp_uint_t n_positional, mp_uint_t n_ke
 void mp_emit_bc_return_value(emit_t *emit) {
     emit_bc_pre(emit, -1);
     emit->last_emit_was_return_value = true;
+    #if MICROPY_COMP_OPTIMISE
+    if (emit_bc_opt_last_op(emit) == MP_BC_LOAD_CONST_NONE) {
+        emit->bytecode_offset = emit->last_op_offset;
+        emit_write_bytecode_byte(emit, MP_BC_RETURN_NONE);
+        emit_bc_opt_end_block(emit);
+        return;
+    }
+    #endif
     emit_write_bytecode_byte(emit, MP_BC_RETURN_VALUE);
+    emit_bc_opt_end_block(emit);
 }
 
 void mp_emit_bc_raise_varargs(emit_t *emit, mp_uint_t n_args) {
     assert(n_args <= 2);
     emit_bc_pre(emit, -n_args);
     emit_write_bytecode_byte_byte(emit, MP_BC_RAISE_VARARGS, n_args);
+    emit_bc_opt_end_block(emit);
 }
 
 void mp_emit_bc_yield_value(emit_t *emit) {
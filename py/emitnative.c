@@ -125,6 +125,13 @@ STATIC byte mp_f_n_args[MP_F_NUMBER_OF] = {
     [MP_F_SETUP_CODE_STATE] = 5,
     [MP_F_SMALL_INT_FLOOR_DIVIDE] = 2,
     [MP_F_SMALL_INT_MODULO] = 2,
+    [MP_F_NATIVE_YIELD_FROM] = 2,
+    [MP_F_MEMCPY] = 3,
+#if MICROPY_PY_BUILTINS_FLOAT
+    [MP_F_NATIVE_FLOAT_BINARY_OP] = 3,
+    [MP_F_NATIVE_FLOAT_FROM_INT] = 1,
+    [MP_F_NATIVE_FLOAT_TO_INT] = 1,
+#endif
 };
 
 #include "py/asmx86.h"
@@ -154,6 +161,15 @@ STATIC byte mp_f_n_args[MP_F_NUMBER_OF] = {
 
 #endif
 
+// Viper floats are held unboxed as the bits of an mp_float_t in a machine
+// word, so they are only supported when an mp_float_t fits in a word.
+#define N_FLOAT (MICROPY_PY_BUILTINS_FLOAT && (N_X64 || MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_FLOAT))
+
+// Archs that do float arithmetic inline; others call helper functions.
+#define N_FLOAT_SSE (N_FLOAT && N_X64)
+#define N_FLOAT_VFP (N_FLOAT && N_THUMB && MICROPY_EMIT_THUMB_FLOAT)
+#define N_FLOAT_DBL (MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_DOUBLE)
+
 #define EMIT_NATIVE_VIPER_TYPE_ERROR(emit, ...) do { \
         *emit->error_slot = mp_obj_new_exception_msg_varg(&mp_type_ViperTypeError, __VA_ARGS__); \
     } while (0)
@@ -175,6 +191,8 @@ typedef enum {
     VTYPE_PTR8 = 0x00 | MP_NATIVE_TYPE_PTR8,
     VTYPE_PTR16 = 0x00 | MP_NATIVE_TYPE_PTR16,
     VTYPE_PTR32 = 0x00 | MP_NATIVE_TYPE_PTR32,
+    VTYPE_FLOAT = 0x00 | MP_NATIVE_TYPE_FLOAT,
+    VTYPE_PTRF32 = 0x00 | MP_NATIVE_TYPE_PTRF32,
 
     VTYPE_PTR_NONE = 0x50 | MP_NATIVE_TYPE_PTR,
 
@@ -192,6 +210,10 @@ STATIC qstr vtype_to_qstr(vtype_kind_t vtype) {
         case VTYPE_PTR8: return MP_QSTR_ptr8;
         case VTYPE_PTR16: return MP_QSTR_ptr16;
         case VTYPE_PTR32: return MP_QSTR_ptr32;
+        #if N_FLOAT
+        case VTYPE_FLOAT: return MP_QSTR_float;
+        case VTYPE_PTRF32: return MP_QSTR_ptrf32;
+        #endif
         case VTYPE_PTR_NONE: default: return MP_QSTR_None;
     }
 }
@@ -205,6 +227,30 @@ typedef struct _stack_info_t {
     } data;
 } stack_info_t;
 
+// the registers that can hold locals, in the order they are allocated
+STATIC const uint8_t reg_local_table[REG_LOCAL_NUM] = {
+    REG_LOCAL_1, REG_LOCAL_2, REG_LOCAL_3,
+    #if REG_LOCAL_NUM > 3
+    REG_LOCAL_4, REG_LOCAL_5,
+    #endif
+};
+
+// the code range over which a local of a viper function is accessed; it is
+// gathered in the first pass and used to allocate registers to the locals
+typedef struct _local_live_t {
+    size_t start;
+    size_t end;
+} local_live_t;
+
+#define LOCAL_LIVE_UNUSED ((size_t)-1)
+
+// an active exception handler: the label to jump to and the position of its
+// nlr_buf_t on the stack
+typedef struct _exc_stack_entry_t {
+    uint16_t label;
+    uint16_t nlr_pos;
+} exc_stack_entry_t;
+
 struct _emit_t {
     mp_obj_t *error_slot;
     int pass;
@@ -215,11 +261,25 @@ struct _emit_t {
 
     mp_uint_t local_vtype_alloc;
     vtype_kind_t *local_vtype;
+    local_live_t *local_live;
+    int8_t *local_reg; // index into reg_local_table, or -1 if held in the frame
 
     mp_uint_t stack_info_alloc;
     stack_info_t *stack_info;
     vtype_kind_t saved_stack_vtype;
 
+    mp_uint_t exc_stack_alloc;
+    mp_uint_t exc_stack_size;
+    exc_stack_entry_t *exc_stack;
+
+    // labels beyond those used by the compiler, for generator resume points
+    mp_uint_t label_base;
+    mp_uint_t next_label;
+    mp_uint_t gen_dispatch_label;
+    mp_uint_t gen_resume_alloc;
+    mp_uint_t gen_resume_num;
+    uint16_t *gen_resume_label;
+
     int prelude_offset;
     int const_table_offset;
     int n_state;
@@ -236,6 +296,7 @@ struct _emit_t {
 emit_t *EXPORT_FUN(new)(mp_obj_t *error_slot, mp_uint_t max_num_labels) {
     emit_t *emit = m_new0(emit_t, 1);
     emit->error_slot = error_slot;
+    emit->label_base = max_num_labels;
     emit->as = m_new0(ASM_T, 1);
     mp_asm_base_init(&emit->as->base, max_num_labels);
     return emit;
@@ -245,10 +306,28 @@ void EXPORT_FUN(free)(emit_t *emit) {
     mp_asm_base_deinit(&emit->as->base, false);
     m_del_obj(ASM_T, emit->as);
     m_del(vtype_kind_t, emit->local_vtype, emit->local_vtype_alloc);
+    m_del(local_live_t, emit->local_live, emit->local_vtype_alloc);
+    m_del(int8_t, emit->local_reg, emit->local_vtype_alloc);
     m_del(stack_info_t, emit->stack_info, emit->stack_info_alloc);
+    m_del(exc_stack_entry_t, emit->exc_stack, emit->exc_stack_alloc);
+    m_del(uint16_t, emit->gen_resume_label, emit->gen_resume_alloc);
     m_del_obj(emit_t, emit);
 }
 
+// allocate a label beyond those reserved by the compiler, growing the
+// assembler's table of labels if needed
+STATIC mp_uint_t emit_native_new_label(emit_t *emit) {
+    mp_asm_base_t *as = &emit->as->base;
+    mp_uint_t label = emit->label_base + emit->next_label++;
+    if (label >= as->max_num_labels) {
+        size_t new_max = label + 8;
+        as->label_offsets = m_renew(size_t, as->label_offsets, as->max_num_labels, new_max);
+        memset(as->label_offsets + as->max_num_labels, -1, (new_max - as->max_num_labels) * sizeof(size_t));
+        as->max_num_labels = new_max;
+    }
+    return label;
+}
+
 STATIC void emit_native_set_native_type(emit_t *emit, mp_uint_t op, mp_uint_t arg1, qstr arg2) {
     switch (op) {
         case MP_EMIT_NATIVE_TYPE_ENABLE:
@@ -266,6 +345,10 @@ STATIC void emit_native_set_native_type(emit_t *emit, mp_uint_t op, mp_uint_t ar
                 case MP_QSTR_ptr8: type = VTYPE_PTR8; break;
                 case MP_QSTR_ptr16: type = VTYPE_PTR16; break;
                 case MP_QSTR_ptr32: type = VTYPE_PTR32; break;
+                #if N_FLOAT
+                case MP_QSTR_float: type = VTYPE_FLOAT; break;
+                case MP_QSTR_ptrf32: type = VTYPE_PTRF32; break;
+                #endif
                 default: EMIT_NATIVE_VIPER_TYPE_ERROR(emit, "unknown type '%q'", arg2); return;
             }
             if (op == MP_EMIT_NATIVE_TYPE_RETURN) {
@@ -283,24 +366,171 @@ STATIC void emit_pre_pop_reg(emit_t *emit, vtype_kind_t *vtype, int reg_dest);
 STATIC void emit_post_push_reg(emit_t *emit, vtype_kind_t vtype, int reg);
 STATIC void emit_native_load_fast(emit_t *emit, qstr qst, mp_uint_t local_num);
 STATIC void emit_native_store_fast(emit_t *emit, qstr qst, mp_uint_t local_num);
+STATIC void emit_native_gen_copy_state(emit_t *emit, bool to_heap);
 
 #define STATE_START (sizeof(mp_code_state_t) / sizeof(mp_uint_t))
 
+// A native generator is called as fun(code_state, throw_value) and returns
+// MP_VM_RETURN_NORMAL or MP_VM_RETURN_YIELD, with code_state->sp pointing to
+// the return/yield value as for the VM.  The first two words of the (unused)
+// code_state header in its frame hold these two arguments.
+#define GEN_LOCAL_CODE_STATE (0)
+#define GEN_LOCAL_THROW_VALUE (1)
+
+// code_state->ip of a native generator: 1 to start it, 2+n to resume at the
+// n'th resume point (0 means finished, as for bytecode)
+#define GEN_RESUME_START (1)
+
+// Return the register holding the given local, or -1 if it lives in the frame.
+// Viper locals get the registers picked by emit_native_alloc_local_regs, while
+// the first few locals of a native function are always cached.
+STATIC int emit_native_local_reg(emit_t *emit, mp_uint_t local_num) {
+    if (emit->do_viper_types) {
+        int idx = emit->local_reg[local_num];
+        return idx < 0 ? -1 : reg_local_table[idx];
+    }
+    return local_num < REG_LOCAL_NUM ? reg_local_table[local_num] : -1;
+}
+
+// Return the frame slot of the given local.
+STATIC mp_uint_t emit_native_local_slot(emit_t *emit, mp_uint_t local_num) {
+    if (emit->do_viper_types) {
+        return local_num;
+    }
+    return STATE_START + emit->n_state - 1 - local_num;
+}
+
+// Record an access to a viper local at the current code position.
+STATIC void emit_native_local_access(emit_t *emit, mp_uint_t local_num) {
+    if (emit->do_viper_types && emit->pass == MP_PASS_STACK_SIZE) {
+        size_t pos = mp_asm_base_get_code_pos(&emit->as->base);
+        local_live_t *live = &emit->local_live[local_num];
+        if (live->start == LOCAL_LIVE_UNUSED) {
+            live->start = pos;
+        }
+        live->end = pos;
+    }
+}
+
+// Record a jump to the given label.  A jump backwards closes a loop, and any
+// local accessed within the loop must then stay live over all of it.
+STATIC void emit_native_local_jump(emit_t *emit, mp_uint_t label) {
+    if (emit->do_viper_types && emit->pass == MP_PASS_STACK_SIZE) {
+        size_t loop_start = emit->as->base.label_offsets[label];
+        if (loop_start == (size_t)-1) {
+            // forward jump
+            return;
+        }
+        size_t loop_end = mp_asm_base_get_code_pos(&emit->as->base);
+        for (mp_uint_t i = 0; i < emit->scope->num_locals; i++) {
+            local_live_t *live = &emit->local_live[i];
+            if (live->start != LOCAL_LIVE_UNUSED && live->start <= loop_end && live->end >= loop_start) {
+                if (live->start > loop_start) {
+                    live->start = loop_start;
+                }
+                live->end = loop_end;
+            }
+        }
+    }
+}
+
+// Allocate registers to viper locals with a linear scan over their live
+// ranges.  When the registers run out the range ending last is left in the
+// frame, so loop counters and pointers of inner loops end up in registers.
+STATIC void emit_native_alloc_local_regs(emit_t *emit) {
+    mp_uint_t num_locals = emit->scope->num_locals;
+    int owner[REG_LOCAL_NUM];
+    for (int r = 0; r < REG_LOCAL_NUM; r++) {
+        owner[r] = -1;
+    }
+    size_t last_start = 0;
+    for (;;) {
+        // find the next range by start position (there are few locals)
+        int cur = -1;
+        for (mp_uint_t i = 0; i < num_locals; i++) {
+            local_live_t *live = &emit->local_live[i];
+            if (live->start != LOCAL_LIVE_UNUSED && emit->local_reg[i] == -1 && live->start >= last_start
+                && (cur < 0 || live->start < emit->local_live[cur].start)) {
+                cur = i;
+            }
+        }
+        if (cur < 0) {
+            break;
+        }
+        local_live_t *cur_live = &emit->local_live[cur];
+        last_start = cur_live->start;
+        emit->local_reg[cur] = -2; // visited
+
+        // free the registers whose ranges have ended, and pick a free one
+        int reg = -1;
+        int furthest = -1;
+        for (int r = 0; r < REG_LOCAL_NUM; r++) {
+            if (owner[r] >= 0 && emit->local_live[owner[r]].end < cur_live->start) {
+                owner[r] = -1;
+            }
+            if (owner[r] < 0) {
+                if (reg < 0) {
+                    reg = r;
+                }
+            } else if (furthest < 0 || emit->local_live[owner[r]].end > emit->local_live[owner[furthest]].end) {
+                furthest = r;
+            }
+        }
+        if (reg < 0) {
+            if (emit->local_live[owner[furthest]].end <= cur_live->end) {
+                // leave the current local in the frame
+                continue;
+            }
+            // evict the local with the furthest end back to the frame
+            emit->local_reg[owner[furthest]] = -2;
+            reg = furthest;
+        }
+        owner[reg] = cur;
+        emit->local_reg[cur] = reg;
+    }
+
+    // locals that were visited but didn't get a register live in the frame
+    for (mp_uint_t i = 0; i < num_locals; i++) {
+        if (emit->local_reg[i] == -2) {
+            emit->local_reg[i] = -1;
+        }
+    }
+}
+
 STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scope) {
     DEBUG_printf("start_pass(pass=%u, scope=%p)\n", pass, scope);
 
     emit->pass = pass;
     emit->stack_start = 0;
     emit->stack_size = 0;
+    emit->exc_stack_size = 0;
+    emit->next_label = 0;
+    emit->gen_resume_num = 0;
     emit->last_emit_was_return_value = false;
     emit->scope = scope;
 
     // allocate memory for keeping track of the types of locals
     if (emit->local_vtype_alloc < scope->num_locals) {
         emit->local_vtype = m_renew(vtype_kind_t, emit->local_vtype, emit->local_vtype_alloc, scope->num_locals);
+        emit->local_live = m_renew(local_live_t, emit->local_live, emit->local_vtype_alloc, scope->num_locals);
+        emit->local_reg = m_renew(int8_t, emit->local_reg, emit->local_vtype_alloc, scope->num_locals);
         emit->local_vtype_alloc = scope->num_locals;
     }
 
+    // viper locals live in the frame for the first pass, which finds out
+    // where they are accessed; registers are allocated at the end of it
+    if (emit->do_viper_types && pass == MP_PASS_STACK_SIZE) {
+        for (mp_uint_t i = 0; i < scope->num_locals; i++) {
+            emit->local_live[i].start = LOCAL_LIVE_UNUSED;
+            emit->local_live[i].end = 0;
+            emit->local_reg[i] = -1;
+        }
+        // arguments are live from the entry of the function
+        for (mp_uint_t i = 0; i < scope->num_pos_args && i < scope->num_locals; i++) {
+            emit->local_live[i].start = 0;
+        }
+    }
+
     // allocate memory for keeping track of the objects on the stack
     // XXX don't know stack size on entry, and it should be maximum over all scopes
     // XXX this is such a big hack and really needs to be fixed
@@ -348,12 +578,10 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
         }
 
         // entry to function
+        // every local has a slot in the frame, even if it's held in a register
         int num_locals = 0;
         if (pass > MP_PASS_SCOPE) {
-            num_locals = scope->num_locals - REG_LOCAL_NUM;
-            if (num_locals < 0) {
-                num_locals = 0;
-            }
+            num_locals = scope->num_locals;
             emit->stack_start = num_locals;
             num_locals += scope->stack_size;
         }
@@ -366,38 +594,44 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
         asm_arm_mov_reg_i32(emit->as, ASM_ARM_REG_R7, (mp_uint_t)mp_fun_table);
         #endif
 
-        #if N_X86
+        // move the arguments to where their locals live
+        #if !N_X86
+        static const uint8_t reg_arg_table[] = {REG_ARG_1, REG_ARG_2, REG_ARG_3, REG_ARG_4};
+        #endif
         for (int i = 0; i < scope->num_pos_args; i++) {
-            if (i == 0) {
-                asm_x86_mov_arg_to_r32(emit->as, i, REG_LOCAL_1);
-            } else if (i == 1) {
-                asm_x86_mov_arg_to_r32(emit->as, i, REG_LOCAL_2);
-            } else if (i == 2) {
-                asm_x86_mov_arg_to_r32(emit->as, i, REG_LOCAL_3);
+            int reg_local = emit_native_local_reg(emit, i);
+            #if N_X86
+            if (reg_local >= 0) {
+                asm_x86_mov_arg_to_r32(emit->as, i, reg_local);
             } else {
                 asm_x86_mov_arg_to_r32(emit->as, i, REG_TEMP0);
-                asm_x86_mov_r32_to_local(emit->as, REG_TEMP0, i - REG_LOCAL_NUM);
+                asm_x86_mov_r32_to_local(emit->as, REG_TEMP0, i);
             }
-        }
-        #else
-        for (int i = 0; i < scope->num_pos_args; i++) {
-            if (i == 0) {
-                ASM_MOV_REG_REG(emit->as, REG_LOCAL_1, REG_ARG_1);
-            } else if (i == 1) {
-                ASM_MOV_REG_REG(emit->as, REG_LOCAL_2, REG_ARG_2);
-            } else if (i == 2) {
-                ASM_MOV_REG_REG(emit->as, REG_LOCAL_3, REG_ARG_3);
+            #else
+            if (reg_local >= 0) {
+                ASM_MOV_REG_REG(emit->as, reg_local, reg_arg_table[i]);
             } else {
-                assert(i == 3); // should be true; max 4 args is checked above
-                ASM_MOV_REG_TO_LOCAL(emit->as, REG_ARG_4, i - REG_LOCAL_NUM);
+                ASM_MOV_REG_TO_LOCAL(emit->as, reg_arg_table[i], i);
             }
+            #endif
         }
-        #endif
 
     } else {
+        bool is_gen = scope->scope_flags & MP_SCOPE_FLAG_GENERATOR;
+
         // work out size of state (locals plus stack)
         emit->n_state = scope->num_locals + scope->stack_size;
 
+        if (is_gen) {
+            // keep the stack clear of the code_state header, so the frame's
+            // state lines up with that of the generator object
+            emit->stack_start = STATE_START;
+
+            // the generator object needs to find the prelude before calling
+            // the code, so store its offset in front of the code
+            mp_asm_base_data(&emit->as->base, ASM_WORD_SIZE, emit->prelude_offset);
+        }
+
         // allocate space on C-stack for code_state structure, which includes state
         ASM_ENTRY(emit->as, STATE_START + emit->n_state);
 
@@ -408,43 +642,61 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
         asm_arm_mov_reg_i32(emit->as, ASM_ARM_REG_R7, (mp_uint_t)mp_fun_table);
         #endif
 
-        // prepare incoming arguments for call to mp_setup_code_state
+        if (is_gen) {
+            #if N_X86
+            asm_x86_mov_arg_to_r32(emit->as, 0, REG_ARG_1);
+            asm_x86_mov_arg_to_r32(emit->as, 1, REG_ARG_2);
+            #endif
+            ASM_MOV_REG_TO_LOCAL(emit->as, REG_ARG_1, GEN_LOCAL_CODE_STATE);
+            ASM_MOV_REG_TO_LOCAL(emit->as, REG_ARG_2, GEN_LOCAL_THROW_VALUE);
+            emit_native_gen_copy_state(emit, false);
+        } else {
+            // prepare incoming arguments for call to mp_setup_code_state
 
-        #if N_X86
-        asm_x86_mov_arg_to_r32(emit->as, 0, REG_ARG_1);
-        asm_x86_mov_arg_to_r32(emit->as, 1, REG_ARG_2);
-        asm_x86_mov_arg_to_r32(emit->as, 2, REG_ARG_3);
-        asm_x86_mov_arg_to_r32(emit->as, 3, REG_ARG_4);
-        #endif
+            #if N_X86
+            asm_x86_mov_arg_to_r32(emit->as, 0, REG_ARG_1);
+            asm_x86_mov_arg_to_r32(emit->as, 1, REG_ARG_2);
+            asm_x86_mov_arg_to_r32(emit->as, 2, REG_ARG_3);
+            asm_x86_mov_arg_to_r32(emit->as, 3, REG_ARG_4);
+            #endif
 
-        // set code_state.fun_bc
-        ASM_MOV_REG_TO_LOCAL(emit->as, REG_ARG_1, offsetof(mp_code_state_t, fun_bc) / sizeof(uintptr_t));
+            // set code_state.fun_bc
+            ASM_MOV_REG_TO_LOCAL(emit->as, REG_ARG_1, offsetof(mp_code_state_t, fun_bc) / sizeof(uintptr_t));
 
-        // set code_state.ip (offset from start of this function to prelude info)
-        // XXX this encoding may change size
-        ASM_MOV_IMM_TO_LOCAL_USING(emit->as, emit->prelude_offset, offsetof(mp_code_state_t, ip) / sizeof(uintptr_t), REG_ARG_1);
+            // set code_state.ip (offset from start of this function to prelude info)
+            // XXX this encoding may change size
+            ASM_MOV_IMM_TO_LOCAL_USING(emit->as, emit->prelude_offset, offsetof(mp_code_state_t, ip) / sizeof(uintptr_t), REG_ARG_1);
 
-        // put address of code_state into first arg
-        ASM_MOV_LOCAL_ADDR_TO_REG(emit->as, 0, REG_ARG_1);
+            // put address of code_state into first arg
+            ASM_MOV_LOCAL_ADDR_TO_REG(emit->as, 0, REG_ARG_1);
 
-        // call mp_setup_code_state to prepare code_state structure
-        #if N_THUMB
-        asm_thumb_bl_ind(emit->as, mp_fun_table[MP_F_SETUP_CODE_STATE], MP_F_SETUP_CODE_STATE, ASM_THUMB_REG_R4);
-        #elif N_ARM
-        asm_arm_bl_ind(emit->as, mp_fun_table[MP_F_SETUP_CODE_STATE], MP_F_SETUP_CODE_STATE, ASM_ARM_REG_R4);
-        #else
-        ASM_CALL_IND(emit->as, mp_fun_table[MP_F_SETUP_CODE_STATE], MP_F_SETUP_CODE_STATE);
-        #endif
+            // call mp_setup_code_state to prepare code_state structure
+            #if N_THUMB
+            asm_thumb_bl_ind(emit->as, mp_fun_table[MP_F_SETUP_CODE_STATE], MP_F_SETUP_CODE_STATE, ASM_THUMB_REG_R4);
+            #elif N_ARM
+            asm_arm_bl_ind(emit->as, mp_fun_table[MP_F_SETUP_CODE_STATE], MP_F_SETUP_CODE_STATE, ASM_ARM_REG_R4);
+            #else
+            ASM_CALL_IND(emit->as, mp_fun_table[MP_F_SETUP_CODE_STATE], MP_F_SETUP_CODE_STATE);
+            #endif
+        }
 
         // cache some locals in registers
-        if (scope->num_locals > 0) {
-            ASM_MOV_LOCAL_TO_REG(emit->as, STATE_START + emit->n_state - 1 - 0, REG_LOCAL_1);
-            if (scope->num_locals > 1) {
-                ASM_MOV_LOCAL_TO_REG(emit->as, STATE_START + emit->n_state - 1 - 1, REG_LOCAL_2);
-                if (scope->num_locals > 2) {
-                    ASM_MOV_LOCAL_TO_REG(emit->as, STATE_START + emit->n_state - 1 - 2, REG_LOCAL_3);
-                }
-            }
+        for (mp_uint_t i = 0; i < REG_LOCAL_NUM && i < scope->num_locals; i++) {
+            ASM_MOV_LOCAL_TO_REG(emit->as, emit_native_local_slot(emit, i), reg_local_table[i]);
+        }
+
+        if (is_gen) {
+            // jump to the resume point given by code_state->ip; the dispatch
+            // code is emitted at the end, once all resume points are known,
+            // and uses the label following its own to start the generator
+            emit->gen_dispatch_label = emit_native_new_label(emit);
+            mp_uint_t start_label = emit_native_new_label(emit);
+            ASM_JUMP(emit->as, emit->gen_dispatch_label);
+            mp_asm_base_label_assign(&emit->as->base, start_label);
+
+            // an exception may be thrown into a just-started generator
+            ASM_MOV_LOCAL_TO_REG(emit->as, GEN_LOCAL_THROW_VALUE, REG_ARG_1);
+            ASM_CALL_IND(emit->as, mp_fun_table[MP_F_NATIVE_RAISE], MP_F_NATIVE_RAISE);
         }
 
         // set the type of closed over variables
@@ -463,6 +715,22 @@ STATIC void emit_native_end_pass(emit_t *emit) {
         ASM_EXIT(emit->as);
     }
 
+    if (emit->do_viper_types && emit->pass == MP_PASS_STACK_SIZE) {
+        emit_native_alloc_local_regs(emit);
+    }
+
+    if (!emit->do_viper_types && (emit->scope->scope_flags & MP_SCOPE_FLAG_GENERATOR)) {
+        // dispatch on code_state->ip to the start or a resume point
+        mp_asm_base_label_assign(&emit->as->base, emit->gen_dispatch_label);
+        ASM_MOV_LOCAL_TO_REG(emit->as, GEN_LOCAL_CODE_STATE, REG_TEMP1);
+        ASM_LOAD_REG_REG_OFFSET(emit->as, REG_TEMP0, REG_TEMP1, offsetof(mp_code_state_t, ip) / sizeof(uintptr_t));
+        for (mp_uint_t i = 0; i < emit->gen_resume_num; i++) {
+            ASM_MOV_IMM_TO_REG(emit->as, GEN_RESUME_START + 1 + i, REG_TEMP1);
+            ASM_JUMP_IF_REG_EQ(emit->as, REG_TEMP0, REG_TEMP1, emit->gen_resume_label[i]);
+        }
+        ASM_JUMP(emit->as, emit->gen_dispatch_label + 1);
+    }
+
     if (!emit->do_viper_types) {
         emit->prelude_offset = mp_asm_base_get_code_pos(&emit->as->base);
         mp_asm_base_data(&emit->as->base, 1, 0x80 | ((emit->n_state >> 7) & 0x7f));
@@ -823,6 +1091,12 @@ STATIC void emit_get_stack_pointer_to_reg_for_pop(emit_t *emit, mp_uint_t reg_de
                     ASM_MOV_IMM_TO_LOCAL_USING(emit->as, (uintptr_t)MP_OBJ_NEW_SMALL_INT(si->data.u_imm), emit->stack_start + emit->stack_size - 1 - i, reg_dest);
                     si->vtype = VTYPE_PYOBJ;
                     break;
+                #if N_FLOAT
+                case VTYPE_FLOAT:
+                    // store the bits; the value is boxed below
+                    ASM_MOV_IMM_TO_LOCAL_USING(emit->as, si->data.u_imm, emit->stack_start + emit->stack_size - 1 - i, reg_dest);
+                    break;
+                #endif
                 default:
                     // not handled
                     mp_raise_NotImplementedError("conversion to object");
@@ -862,6 +1136,196 @@ STATIC void emit_get_stack_pointer_to_reg_for_push(emit_t *emit, mp_uint_t reg_d
     adjust_stack(emit, n_push);
 }
 
+#if N_FLOAT
+
+STATIC mp_uint_t emit_native_float_to_bits(mp_float_t f) {
+    union { mp_float_t f; mp_uint_t u; } x = {.u = 0};
+    x.f = f;
+    return x.u;
+}
+
+STATIC mp_float_t emit_native_float_from_bits(mp_uint_t u) {
+    union { mp_float_t f; mp_uint_t u; } x = {.u = u};
+    return x.f;
+}
+
+// convert the float32 bits in reg (as loaded through a ptrf32) to an mp_float_t, in place
+STATIC void emit_native_float_from_f32(emit_t *emit, int reg) {
+    #if N_FLOAT_SSE && N_FLOAT_DBL
+    asm_x64_movq_r64_to_xmm(emit->as, reg, 0);
+    asm_x64_sse_op_xmm_xmm(emit->as, false, ASM_X64_SSE_OP_CVT, 0, 0); // cvtss2sd
+    asm_x64_movq_xmm_to_r64(emit->as, 0, reg);
+    #else
+    (void)emit;
+    (void)reg;
+    #endif
+}
+
+// convert the mp_float_t in reg_value to float32 bits for a store through a ptrf32,
+// returning the register that holds the result (reg_value itself is left untouched
+// because it may be a local, and REG_ARG_3 is not used for the base or index)
+STATIC int emit_native_float_to_f32(emit_t *emit, int reg_value) {
+    #if N_FLOAT_SSE && N_FLOAT_DBL
+    asm_x64_movq_r64_to_xmm(emit->as, reg_value, 0);
+    asm_x64_sse_op_xmm_xmm(emit->as, true, ASM_X64_SSE_OP_CVT, 0, 0); // cvtsd2ss
+    asm_x64_movq_xmm_to_r64(emit->as, 0, REG_ARG_3);
+    return REG_ARG_3;
+    #else
+    (void)emit;
+    return reg_value;
+    #endif
+}
+
+// convert the int (to_float=true) or float (to_float=false) at the given depth
+// of the stack to the other type, in place
+STATIC void emit_native_float_convert(emit_t *emit, int depth, bool to_float) {
+    stack_info_t *si = peek_stack(emit, depth);
+    if (si->kind == STACK_IMM) {
+        // convert at compile time
+        if (to_float) {
+            si->data.u_imm = emit_native_float_to_bits((mp_float_t)(mp_int_t)si->data.u_imm);
+        } else {
+            si->data.u_imm = (mp_int_t)emit_native_float_from_bits(si->data.u_imm);
+        }
+    } else {
+        need_stack_settled(emit);
+        mp_uint_t local_num = emit->stack_start + emit->stack_size - 1 - depth;
+        ASM_MOV_LOCAL_TO_REG(emit->as, local_num, REG_ARG_1);
+        #if N_FLOAT_SSE
+        if (to_float) {
+            asm_x64_cvtsi2s_r64_to_xmm(emit->as, N_FLOAT_DBL, REG_ARG_1, 0);
+            asm_x64_movq_xmm_to_r64(emit->as, 0, REG_RET);
+        } else {
+            asm_x64_movq_r64_to_xmm(emit->as, REG_ARG_1, 0);
+            asm_x64_cvtts2si_xmm_to_r64(emit->as, N_FLOAT_DBL, 0, REG_RET);
+        }
+        #elif N_FLOAT_VFP
+        asm_thumb_vmov_sreg_reg(emit->as, 0, REG_ARG_1);
+        if (to_float) {
+            asm_thumb_vcvt_f32_s32(emit->as, 0, 0);
+        } else {
+            asm_thumb_vcvt_s32_f32(emit->as, 0, 0);
+        }
+        asm_thumb_vmov_reg_sreg(emit->as, REG_RET, 0);
+        #else
+        emit_call(emit, to_float ? MP_F_NATIVE_FLOAT_FROM_INT : MP_F_NATIVE_FLOAT_TO_INT);
+        #endif
+        ASM_MOV_REG_TO_LOCAL(emit->as, REG_RET, local_num);
+    }
+    si->vtype = to_float ? VTYPE_FLOAT : VTYPE_INT;
+}
+
+// the values are kept unboxed in general purpose registers and moved into
+// FPU registers for the operation itself
+STATIC void emit_native_float_binary_op(emit_t *emit, mp_binary_op_t op) {
+    // an int operand is promoted to float
+    if (peek_vtype(emit, 0) == VTYPE_INT) {
+        emit_native_float_convert(emit, 0, true);
+    }
+    if (peek_vtype(emit, 1) == VTYPE_INT) {
+        emit_native_float_convert(emit, 1, true);
+    }
+
+    if (MP_BINARY_OP_INPLACE_OR <= op && op <= MP_BINARY_OP_INPLACE_POWER) {
+        op += MP_BINARY_OP_OR - MP_BINARY_OP_INPLACE_OR;
+    }
+    bool is_compare = MP_BINARY_OP_LESS <= op && op <= MP_BINARY_OP_NOT_EQUAL;
+    if (!is_compare && op != MP_BINARY_OP_ADD && op != MP_BINARY_OP_SUBTRACT
+        && op != MP_BINARY_OP_MULTIPLY && op != MP_BINARY_OP_TRUE_DIVIDE) {
+        adjust_stack(emit, -1);
+        EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+            "binary op %q not implemented", mp_binary_op_method_name[op]);
+        return;
+    }
+
+    vtype_kind_t vtype_lhs, vtype_rhs;
+    emit_pre_pop_reg_reg(emit, &vtype_rhs, REG_ARG_3, &vtype_lhs, REG_ARG_2);
+
+    #if N_FLOAT_SSE
+
+    asm_x64_movq_r64_to_xmm(emit->as, REG_ARG_2, 0);
+    asm_x64_movq_r64_to_xmm(emit->as, REG_ARG_3, 1);
+    if (is_compare) {
+        // ucomis sets ZF, PF and CF for unordered operands, so only the "above"
+        // conditions are false for a NaN; "less" swaps the operands to use them
+        need_reg_single(emit, REG_RET, 0);
+        asm_x64_xor_r64_r64(emit->as, REG_RET, REG_RET);
+        if (op == MP_BINARY_OP_LESS || op == MP_BINARY_OP_LESS_EQUAL) {
+            asm_x64_ucomis_xmm_with_xmm(emit->as, N_FLOAT_DBL, 1, 0);
+            asm_x64_setcc_r8(emit->as, op == MP_BINARY_OP_LESS ? ASM_X64_CC_JA : ASM_X64_CC_JAE, REG_RET);
+        } else if (op == MP_BINARY_OP_MORE || op == MP_BINARY_OP_MORE_EQUAL) {
+            asm_x64_ucomis_xmm_with_xmm(emit->as, N_FLOAT_DBL, 0, 1);
+            asm_x64_setcc_r8(emit->as, op == MP_BINARY_OP_MORE ? ASM_X64_CC_JA : ASM_X64_CC_JAE, REG_RET);
+        } else {
+            // equality must also check the parity flag
+            asm_x64_xor_r64_r64(emit->as, REG_ARG_3, REG_ARG_3);
+            asm_x64_ucomis_xmm_with_xmm(emit->as, N_FLOAT_DBL, 0, 1);
+            if (op == MP_BINARY_OP_EQUAL) {
+                asm_x64_setcc_r8(emit->as, ASM_X64_CC_JE, REG_RET);
+                asm_x64_setcc_r8(emit->as, ASM_X64_CC_JNP, REG_ARG_3);
+                asm_x64_and_r64_r64(emit->as, REG_RET, REG_ARG_3);
+            } else {
+                asm_x64_setcc_r8(emit->as, ASM_X64_CC_JNE, REG_RET);
+                asm_x64_setcc_r8(emit->as, ASM_X64_CC_JP, REG_ARG_3);
+                asm_x64_or_r64_r64(emit->as, REG_RET, REG_ARG_3);
+            }
+        }
+        emit_post_push_reg(emit, VTYPE_BOOL, REG_RET);
+    } else {
+        static const byte ops[] = {
+            [MP_BINARY_OP_ADD - MP_BINARY_OP_ADD] = ASM_X64_SSE_OP_ADD,
+            [MP_BINARY_OP_SUBTRACT - MP_BINARY_OP_ADD] = ASM_X64_SSE_OP_SUB,
+            [MP_BINARY_OP_MULTIPLY - MP_BINARY_OP_ADD] = ASM_X64_SSE_OP_MUL,
+            [MP_BINARY_OP_TRUE_DIVIDE - MP_BINARY_OP_ADD] = ASM_X64_SSE_OP_DIV,
+        };
+        asm_x64_sse_op_xmm_xmm(emit->as, N_FLOAT_DBL, ops[op - MP_BINARY_OP_ADD], 0, 1);
+        asm_x64_movq_xmm_to_r64(emit->as, 0, REG_ARG_2);
+        emit_post_push_reg(emit, VTYPE_FLOAT, REG_ARG_2);
+    }
+
+    #elif N_FLOAT_VFP
+
+    asm_thumb_vmov_sreg_reg(emit->as, 0, REG_ARG_2);
+    asm_thumb_vmov_sreg_reg(emit->as, 1, REG_ARG_3);
+    if (is_compare) {
+        // these conditions are all false for unordered operands, except NE
+        static const byte ccs[6] = {
+            ASM_THUMB_CC_MI,
+            ASM_THUMB_CC_GT,
+            ASM_THUMB_CC_EQ,
+            ASM_THUMB_CC_LS,
+            ASM_THUMB_CC_GE,
+            ASM_THUMB_CC_NE,
+        };
+        uint cc = ccs[op - MP_BINARY_OP_LESS];
+        need_reg_single(emit, REG_RET, 0);
+        asm_thumb_vcmp_f32(emit->as, 0, 1);
+        asm_thumb_it_cc(emit->as, cc, (((cc & 1) ^ 1) << 3) | 4); // ite cc
+        asm_thumb_mov_rlo_i8(emit->as, REG_RET, 1);
+        asm_thumb_mov_rlo_i8(emit->as, REG_RET, 0);
+        emit_post_push_reg(emit, VTYPE_BOOL, REG_RET);
+    } else {
+        static const byte ops[] = {
+            [MP_BINARY_OP_ADD - MP_BINARY_OP_ADD] = ASM_THUMB_VFP_OP_ADD,
+            [MP_BINARY_OP_SUBTRACT - MP_BINARY_OP_ADD] = ASM_THUMB_VFP_OP_SUB,
+            [MP_BINARY_OP_MULTIPLY - MP_BINARY_OP_ADD] = ASM_THUMB_VFP_OP_MUL,
+            [MP_BINARY_OP_TRUE_DIVIDE - MP_BINARY_OP_ADD] = ASM_THUMB_VFP_OP_DIV,
+        };
+        asm_thumb_vfp_op(emit->as, ops[op - MP_BINARY_OP_ADD], 0, 0, 1);
+        asm_thumb_vmov_reg_sreg(emit->as, REG_ARG_2, 0);
+        emit_post_push_reg(emit, VTYPE_FLOAT, REG_ARG_2);
+    }
+
+    #else
+
+    emit_call_with_imm_arg(emit, MP_F_NATIVE_FLOAT_BINARY_OP, op, REG_ARG_1);
+    emit_post_push_reg(emit, is_compare ? VTYPE_BOOL : VTYPE_FLOAT, REG_RET);
+
+    #endif
+}
+
+#endif // N_FLOAT
+
 STATIC void emit_native_label_assign(emit_t *emit, mp_uint_t l) {
     DEBUG_printf("label_assign(" UINT_FMT ")\n", l);
     emit_native_pre(emit);
@@ -980,6 +1444,12 @@ STATIC void emit_native_load_const_str(emit_t *emit, qstr qst) {
 
 STATIC void emit_native_load_const_obj(emit_t *emit, mp_obj_t obj) {
     emit_native_pre(emit);
+    #if N_FLOAT
+    if (emit->do_viper_types && mp_obj_is_float(obj)) {
+        emit_post_push_imm(emit, VTYPE_FLOAT, emit_native_float_to_bits(mp_obj_float_get(obj)));
+        return;
+    }
+    #endif
     need_reg_single(emit, REG_RET, 0);
     ASM_MOV_ALIGNED_IMM_TO_REG(emit->as, (mp_uint_t)obj, REG_RET);
     emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
@@ -997,19 +1467,13 @@ STATIC void emit_native_load_fast(emit_t *emit, qstr qst, mp_uint_t local_num) {
         EMIT_NATIVE_VIPER_TYPE_ERROR(emit, "local '%q' used before type known", qst);
     }
     emit_native_pre(emit);
-    if (local_num == 0) {
-        emit_post_push_reg(emit, vtype, REG_LOCAL_1);
-    } else if (local_num == 1) {
-        emit_post_push_reg(emit, vtype, REG_LOCAL_2);
-    } else if (local_num == 2) {
-        emit_post_push_reg(emit, vtype, REG_LOCAL_3);
+    emit_native_local_access(emit, local_num);
+    int reg_local = emit_native_local_reg(emit, local_num);
+    if (reg_local >= 0) {
+        emit_post_push_reg(emit, vtype, reg_local);
     } else {
         need_reg_single(emit, REG_TEMP0, 0);
-        if (emit->do_viper_types) {
-            ASM_MOV_LOCAL_TO_REG(emit->as, local_num - REG_LOCAL_NUM, REG_TEMP0);
-        } else {
-            ASM_MOV_LOCAL_TO_REG(emit->as, STATE_START + emit->n_state - 1 - local_num, REG_TEMP0);
-        }
+        ASM_MOV_LOCAL_TO_REG(emit->as, emit_native_local_slot(emit, local_num), REG_TEMP0);
         emit_post_push_reg(emit, vtype, REG_TEMP0);
     }
 }
@@ -1049,6 +1513,12 @@ STATIC void emit_native_load_global(emit_t *emit, qstr qst) {
         emit_post_push_imm(emit, VTYPE_BUILTIN_CAST, VTYPE_PTR16);
     } else if (emit->do_viper_types && qst == MP_QSTR_ptr32) {
         emit_post_push_imm(emit, VTYPE_BUILTIN_CAST, VTYPE_PTR32);
+    #if N_FLOAT
+    } else if (emit->do_viper_types && qst == MP_QSTR_float) {
+        emit_post_push_imm(emit, VTYPE_BUILTIN_CAST, VTYPE_FLOAT);
+    } else if (emit->do_viper_types && qst == MP_QSTR_ptrf32) {
+        emit_post_push_imm(emit, VTYPE_BUILTIN_CAST, VTYPE_PTRF32);
+    #endif
     } else {
         emit_call_with_imm_arg(emit, MP_F_LOAD_GLOBAL, qst, REG_ARG_1);
         emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
@@ -1114,6 +1584,9 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
         // TODO The different machine architectures have very different
         // capabilities and requirements for loads, so probably best to
         // write a completely separate load-optimiser for each one.
+        // The loaded value goes in REG_RET so it can't hold anything else
+        // on the stack (it may, for example, after a dup_top).
+        need_reg_single(emit, REG_RET, 0);
         stack_info_t *top = peek_stack(emit, 0);
         if (top->vtype == VTYPE_INT && top->kind == STACK_IMM) {
             // index is an immediate
@@ -1158,7 +1631,11 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
                     ASM_LOAD16_REG_REG(emit->as, REG_RET, reg_base); // load from (base+2*index)
                     break;
                 }
-                case VTYPE_PTR32: {
+                case VTYPE_PTR32:
+                #if N_FLOAT
+                case VTYPE_PTRF32:
+                #endif
+                {
                     // pointer to 32-bit memory
                     if (index_value != 0) {
                         // index is a non-zero immediate
@@ -1204,7 +1681,11 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
                     ASM_LOAD16_REG_REG(emit->as, REG_RET, REG_ARG_1); // load from (base+2*index)
                     break;
                 }
-                case VTYPE_PTR32: {
+                case VTYPE_PTR32:
+                #if N_FLOAT
+                case VTYPE_PTRF32:
+                #endif
+                {
                     // pointer to word-size memory
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
@@ -1218,25 +1699,28 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
                         "can't load from '%q'", vtype_to_qstr(vtype_base));
             }
         }
+        #if N_FLOAT
+        if (vtype_base == VTYPE_PTRF32) {
+            emit_native_float_from_f32(emit, REG_RET);
+            emit_post_push_reg(emit, VTYPE_FLOAT, REG_RET);
+            return;
+        }
+        #endif
         emit_post_push_reg(emit, VTYPE_INT, REG_RET);
     }
 }
 
 STATIC void emit_native_store_fast(emit_t *emit, qstr qst, mp_uint_t local_num) {
     vtype_kind_t vtype;
-    if (local_num == 0) {
-        emit_pre_pop_reg(emit, &vtype, REG_LOCAL_1);
-    } else if (local_num == 1) {
-        emit_pre_pop_reg(emit, &vtype, REG_LOCAL_2);
-    } else if (local_num == 2) {
-        emit_pre_pop_reg(emit, &vtype, REG_LOCAL_3);
+    emit_native_local_access(emit, local_num);
+    int reg_local = emit_native_local_reg(emit, local_num);
+    if (reg_local >= 0) {
+        // the register may be shared with another local still on the stack
+        need_reg_single(emit, reg_local, 1);
+        emit_pre_pop_reg(emit, &vtype, reg_local);
     } else {
         emit_pre_pop_reg(emit, &vtype, REG_TEMP0);
-        if (emit->do_viper_types) {
-            ASM_MOV_REG_TO_LOCAL(emit->as, REG_TEMP0, local_num - REG_LOCAL_NUM);
-        } else {
-            ASM_MOV_REG_TO_LOCAL(emit->as, REG_TEMP0, STATE_START + emit->n_state - 1 - local_num);
-        }
+        ASM_MOV_REG_TO_LOCAL(emit->as, REG_TEMP0, emit_native_local_slot(emit, local_num));
     }
     emit_post(emit);
 
@@ -1338,6 +1822,15 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
             #else
             emit_pre_pop_reg_flexible(emit, &vtype_value, &reg_value, reg_base, reg_index);
             #endif
+            #if N_FLOAT
+            if (vtype_base == VTYPE_PTRF32) {
+                if (vtype_value != VTYPE_FLOAT) {
+                    EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+                        "can't store '%q'", vtype_to_qstr(vtype_value));
+                }
+                reg_value = emit_native_float_to_f32(emit, reg_value);
+            } else
+            #endif
             if (vtype_value != VTYPE_BOOL && vtype_value != VTYPE_INT && vtype_value != VTYPE_UINT) {
                 EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
                     "can't store '%q'", vtype_to_qstr(vtype_value));
@@ -1386,7 +1879,11 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
                     ASM_STORE16_REG_REG(emit->as, reg_value, reg_base); // store value to (base+2*index)
                     break;
                 }
-                case VTYPE_PTR32: {
+                case VTYPE_PTR32:
+                #if N_FLOAT
+                case VTYPE_PTRF32:
+                #endif
+                {
                     // pointer to 32-bit memory
                     if (index_value != 0) {
                         // index is a non-zero immediate
@@ -1428,6 +1925,15 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
             #else
             emit_pre_pop_reg_flexible(emit, &vtype_value, &reg_value, REG_ARG_1, reg_index);
             #endif
+            #if N_FLOAT
+            if (vtype_base == VTYPE_PTRF32) {
+                if (vtype_value != VTYPE_FLOAT) {
+                    EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+                        "can't store '%q'", vtype_to_qstr(vtype_value));
+                }
+                reg_value = emit_native_float_to_f32(emit, reg_value);
+            } else
+            #endif
             if (vtype_value != VTYPE_BOOL && vtype_value != VTYPE_INT && vtype_value != VTYPE_UINT) {
                 EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
                     "can't store '%q'", vtype_to_qstr(vtype_value));
@@ -1455,7 +1961,11 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
                     ASM_STORE16_REG_REG(emit->as, reg_value, REG_ARG_1); // store value to (base+2*index)
                     break;
                 }
-                case VTYPE_PTR32: {
+                case VTYPE_PTR32:
+                #if N_FLOAT
+                case VTYPE_PTRF32:
+                #endif
+                {
                     // pointer to 32-bit memory
                     #if N_ARM
                     asm_arm_str_reg_reg_reg(emit->as, reg_value, REG_ARG_1, reg_index);
@@ -1556,6 +2066,7 @@ STATIC void emit_native_rot_three(emit_t *emit) {
 
 STATIC void emit_native_jump(emit_t *emit, mp_uint_t label) {
     DEBUG_printf("jump(label=" UINT_FMT ")\n", label);
+    emit_native_local_jump(emit, label);
     emit_native_pre(emit);
     // need to commit stack because we are jumping elsewhere
     need_stack_settled(emit);
@@ -1592,6 +2103,7 @@ STATIC void emit_native_jump_helper(emit_t *emit, bool pop) {
 
 STATIC void emit_native_pop_jump_if(emit_t *emit, bool cond, mp_uint_t label) {
     DEBUG_printf("pop_jump_if(cond=%u, label=" UINT_FMT ")\n", cond, label);
+    emit_native_local_jump(emit, label);
     emit_native_jump_helper(emit, true);
     if (cond) {
         ASM_JUMP_IF_REG_NONZERO(emit->as, REG_RET, label);
@@ -1603,6 +2115,7 @@ STATIC void emit_native_pop_jump_if(emit_t *emit, bool cond, mp_uint_t label) {
 
 STATIC void emit_native_jump_if_or_pop(emit_t *emit, bool cond, mp_uint_t label) {
     DEBUG_printf("jump_if_or_pop(cond=%u, label=" UINT_FMT ")\n", cond, label);
+    emit_native_local_jump(emit, label);
     emit_native_jump_helper(emit, false);
     if (cond) {
         ASM_JUMP_IF_REG_NONZERO(emit->as, REG_RET, label);
@@ -1623,6 +2136,19 @@ STATIC void emit_native_continue_loop(emit_t *emit, mp_uint_t label, mp_uint_t e
     emit_native_jump(emit, label); // TODO properly
 }
 
+// record an nlr_buf_t about to be pushed on the stack, with its handler
+// label, so that it can be unlinked and relinked around a yield and
+// unlinked on return
+STATIC void emit_native_push_exc_handler(emit_t *emit, mp_uint_t label) {
+    if (emit->exc_stack_size >= emit->exc_stack_alloc) {
+        emit->exc_stack = m_renew(exc_stack_entry_t, emit->exc_stack, emit->exc_stack_alloc, emit->exc_stack_alloc + 4);
+        emit->exc_stack_alloc += 4;
+    }
+    exc_stack_entry_t *e = &emit->exc_stack[emit->exc_stack_size++];
+    e->label = label;
+    e->nlr_pos = emit->stack_start + emit->stack_size;
+}
+
 STATIC void emit_native_setup_with(emit_t *emit, mp_uint_t label) {
     // the context manager is on the top of the stack
     // stack: (..., ctx_mgr)
@@ -1656,6 +2182,7 @@ STATIC void emit_native_setup_with(emit_t *emit, mp_uint_t label) {
 
     // need to commit stack because we may jump elsewhere
     need_stack_settled(emit);
+    emit_native_push_exc_handler(emit, label);
     emit_get_stack_pointer_to_reg_for_push(emit, REG_ARG_1, sizeof(nlr_buf_t) / sizeof(mp_uint_t)); // arg1 = pointer to nlr buf
     emit_call(emit, MP_F_NLR_PUSH);
     ASM_JUMP_IF_REG_NONZERO(emit->as, REG_RET, label);
@@ -1670,6 +2197,7 @@ STATIC void emit_native_with_cleanup(emit_t *emit, mp_uint_t label) {
 
     // stack: (..., __exit__, self, as_value, nlr_buf)
     emit_native_pre(emit);
+    emit->exc_stack_size -= 1;
     emit_call(emit, MP_F_NLR_POP);
     adjust_stack(emit, -(mp_int_t)(sizeof(nlr_buf_t) / sizeof(mp_uint_t)) - 1);
     // stack: (..., __exit__, self)
@@ -1738,6 +2266,7 @@ STATIC void emit_native_setup_except(emit_t *emit, mp_uint_t label) {
     emit_native_pre(emit);
     // need to commit stack because we may jump elsewhere
     need_stack_settled(emit);
+    emit_native_push_exc_handler(emit, label);
     emit_get_stack_pointer_to_reg_for_push(emit, REG_ARG_1, sizeof(nlr_buf_t) / sizeof(mp_uint_t)); // arg1 = pointer to nlr buf
     emit_call(emit, MP_F_NLR_PUSH);
     ASM_JUMP_IF_REG_NONZERO(emit->as, REG_RET, label);
@@ -1798,6 +2327,7 @@ STATIC void emit_native_for_iter_end(emit_t *emit) {
 
 STATIC void emit_native_pop_block(emit_t *emit) {
     emit_native_pre(emit);
+    emit->exc_stack_size -= 1;
     emit_call(emit, MP_F_NLR_POP);
     adjust_stack(emit, -(mp_int_t)(sizeof(nlr_buf_t) / sizeof(mp_uint_t)) + 1);
     emit_post(emit);
@@ -1813,6 +2343,16 @@ STATIC void emit_native_unary_op(emit_t *emit, mp_unary_op_t op) {
     if (vtype == VTYPE_PYOBJ) {
         emit_call_with_imm_arg(emit, MP_F_UNARY_OP, op, REG_ARG_1);
         emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
+    #if N_FLOAT
+    } else if (vtype == VTYPE_FLOAT && (op == MP_UNARY_OP_POSITIVE || op == MP_UNARY_OP_NEGATIVE)) {
+        if (op == MP_UNARY_OP_NEGATIVE) {
+            // flip the sign bit
+            need_reg_single(emit, REG_ARG_3, 0);
+            ASM_MOV_IMM_TO_REG(emit->as, (mp_uint_t)1 << (sizeof(mp_float_t) * 8 - 1), REG_ARG_3);
+            ASM_XOR_REG_REG(emit->as, REG_ARG_2, REG_ARG_3);
+        }
+        emit_post_push_reg(emit, VTYPE_FLOAT, REG_ARG_2);
+    #endif
     } else {
         adjust_stack(emit, 1);
         EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
@@ -1974,6 +2514,11 @@ STATIC void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
             EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
                 "binary op %q not implemented", mp_binary_op_method_name[op]);
         }
+    #if N_FLOAT
+    } else if ((vtype_lhs == VTYPE_FLOAT && (vtype_rhs == VTYPE_FLOAT || vtype_rhs == VTYPE_INT))
+        || (vtype_lhs == VTYPE_INT && vtype_rhs == VTYPE_FLOAT)) {
+        emit_native_float_binary_op(emit, op);
+    #endif
     } else if (vtype_lhs == VTYPE_PYOBJ && vtype_rhs == VTYPE_PYOBJ) {
         emit_pre_pop_reg_reg(emit, &vtype_rhs, REG_ARG_3, &vtype_lhs, REG_ARG_2);
         bool invert = false;
@@ -2161,14 +2706,42 @@ STATIC void emit_native_call_function(emit_t *emit, mp_uint_t n_positional, mp_u
                 emit_post_push_reg(emit, vtype_cast, REG_RET);
                 break;
             }
+            #if N_FLOAT
+            case VTYPE_FLOAT:
+                // float to int conversion truncates, like int() in Python
+                if (vtype_cast == VTYPE_INT || vtype_cast == VTYPE_UINT) {
+                    emit_native_float_convert(emit, 0, false);
+                } else if (vtype_cast != VTYPE_FLOAT) {
+                    EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+                        "can't cast 'float' to '%q'", vtype_to_qstr(vtype_cast));
+                }
+                emit_fold_stack_top(emit, REG_ARG_1);
+                emit_post_top_set_vtype(emit, vtype_cast);
+                break;
+            #endif
             case VTYPE_BOOL:
             case VTYPE_INT:
             case VTYPE_UINT:
+                #if N_FLOAT
+                if (vtype_cast == VTYPE_FLOAT) {
+                    emit_native_float_convert(emit, 0, true);
+                }
+                #endif
+                emit_fold_stack_top(emit, REG_ARG_1);
+                emit_post_top_set_vtype(emit, vtype_cast);
+                break;
             case VTYPE_PTR:
             case VTYPE_PTR8:
             case VTYPE_PTR16:
             case VTYPE_PTR32:
             case VTYPE_PTR_NONE:
+            #if N_FLOAT
+            case VTYPE_PTRF32:
+                if (vtype_cast == VTYPE_FLOAT) {
+                    EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+                        "can't cast '%q' to 'float'", vtype_to_qstr(peek_vtype(emit, 0)));
+                }
+            #endif
                 emit_fold_stack_top(emit, REG_ARG_1);
                 emit_post_top_set_vtype(emit, vtype_cast);
                 break;
@@ -2208,6 +2781,14 @@ STATIC void emit_native_call_method(emit_t *emit, mp_uint_t n_positional, mp_uin
 
 STATIC void emit_native_return_value(emit_t *emit) {
     DEBUG_printf("return_value\n");
+    if (emit->exc_stack_size > 0) {
+        // unlink the nlr_buf_t's of any enclosing try/with blocks, since
+        // they live in this function's frame
+        need_reg_all(emit);
+        for (mp_uint_t i = 0; i < emit->exc_stack_size; i++) {
+            ASM_CALL_IND(emit->as, mp_fun_table[MP_F_NLR_POP], MP_F_NLR_POP);
+        }
+    }
     if (emit->do_viper_types) {
         if (peek_vtype(emit, 0) == VTYPE_PTR_NONE) {
             emit_pre_pop_discard(emit);
@@ -2225,6 +2806,17 @@ STATIC void emit_native_return_value(emit_t *emit) {
                     vtype_to_qstr(emit->return_vtype), vtype_to_qstr(vtype));
             }
         }
+    } else if (emit->scope->scope_flags & MP_SCOPE_FLAG_GENERATOR) {
+        // store the return value in code_state->state[0] and point sp to it
+        vtype_kind_t vtype;
+        emit_pre_pop_reg(emit, &vtype, REG_ARG_2);
+        assert(vtype == VTYPE_PYOBJ);
+        ASM_MOV_LOCAL_TO_REG(emit->as, GEN_LOCAL_CODE_STATE, REG_ARG_1);
+        ASM_STORE_REG_REG_OFFSET(emit->as, REG_ARG_2, REG_ARG_1, STATE_START);
+        ASM_MOV_IMM_TO_REG(emit->as, STATE_START * sizeof(uintptr_t), REG_ARG_2);
+        ASM_ADD_REG_REG(emit->as, REG_ARG_2, REG_ARG_1);
+        ASM_STORE_REG_REG_OFFSET(emit->as, REG_ARG_2, REG_ARG_1, offsetof(mp_code_state_t, sp) / sizeof(uintptr_t));
+        ASM_MOV_IMM_TO_REG(emit->as, MP_VM_RETURN_NORMAL, REG_RET);
     } else {
         vtype_kind_t vtype;
         emit_pre_pop_reg(emit, &vtype, REG_RET);
@@ -2245,15 +2837,109 @@ STATIC void emit_native_raise_varargs(emit_t *emit, mp_uint_t n_args) {
     emit_call(emit, MP_F_NATIVE_RAISE);
 }
 
+// copy the state between the frame and the generator's code_state
+STATIC void emit_native_gen_copy_state(emit_t *emit, bool to_heap) {
+    int reg_frame = to_heap ? REG_ARG_2 : REG_ARG_1;
+    int reg_heap = to_heap ? REG_ARG_1 : REG_ARG_2;
+    ASM_MOV_LOCAL_TO_REG(emit->as, GEN_LOCAL_CODE_STATE, reg_heap);
+    ASM_MOV_IMM_TO_REG(emit->as, STATE_START * sizeof(uintptr_t), REG_ARG_3);
+    ASM_ADD_REG_REG(emit->as, reg_heap, REG_ARG_3);
+    ASM_MOV_LOCAL_ADDR_TO_REG(emit->as, STATE_START, reg_frame);
+    ASM_MOV_IMM_TO_REG(emit->as, emit->n_state * sizeof(uintptr_t), REG_ARG_3);
+    ASM_CALL_IND(emit->as, mp_fun_table[MP_F_MEMCPY], MP_F_MEMCPY);
+}
+
+// Suspend the generator, yielding the value at local slot sp_local, and
+// assign the label where execution continues when it is resumed.  The stack
+// must be settled.  On resumption the sent value is in slot sp_local.
+STATIC void emit_native_gen_yield(emit_t *emit, mp_uint_t sp_local) {
+    mp_uint_t resume_label = emit_native_new_label(emit);
+    if (emit->gen_resume_num >= emit->gen_resume_alloc) {
+        emit->gen_resume_label = m_renew(uint16_t, emit->gen_resume_label, emit->gen_resume_alloc, emit->gen_resume_alloc + 8);
+        emit->gen_resume_alloc += 8;
+    }
+    emit->gen_resume_label[emit->gen_resume_num++] = resume_label;
+
+    // write back locals cached in registers
+    for (mp_uint_t i = 0; i < REG_LOCAL_NUM && i < emit->scope->num_locals; i++) {
+        ASM_MOV_REG_TO_LOCAL(emit->as, reg_local_table[i], emit_native_local_slot(emit, i));
+    }
+
+    // unlink active nlr_buf_t's, they are relinked on resumption
+    for (mp_uint_t i = 0; i < emit->exc_stack_size; i++) {
+        ASM_CALL_IND(emit->as, mp_fun_table[MP_F_NLR_POP], MP_F_NLR_POP);
+    }
+
+    emit_native_gen_copy_state(emit, true);
+
+    // set code_state->ip to the resume point and code_state->sp to the value
+    ASM_MOV_LOCAL_TO_REG(emit->as, GEN_LOCAL_CODE_STATE, REG_ARG_1);
+    ASM_MOV_IMM_TO_REG(emit->as, GEN_RESUME_START + emit->gen_resume_num, REG_ARG_2);
+    ASM_STORE_REG_REG_OFFSET(emit->as, REG_ARG_2, REG_ARG_1, offsetof(mp_code_state_t, ip) / sizeof(uintptr_t));
+    ASM_MOV_IMM_TO_REG(emit->as, sp_local * sizeof(uintptr_t), REG_ARG_2);
+    ASM_ADD_REG_REG(emit->as, REG_ARG_2, REG_ARG_1);
+    ASM_STORE_REG_REG_OFFSET(emit->as, REG_ARG_2, REG_ARG_1, offsetof(mp_code_state_t, sp) / sizeof(uintptr_t));
+
+    ASM_MOV_IMM_TO_REG(emit->as, MP_VM_RETURN_YIELD, REG_RET);
+    ASM_EXIT(emit->as);
+
+    // resumption: the state and cached locals were restored on entry, so
+    // just relink the nlr_buf_t's, outermost first
+    mp_asm_base_label_assign(&emit->as->base, resume_label);
+    for (mp_uint_t i = 0; i < emit->exc_stack_size; i++) {
+        ASM_MOV_LOCAL_ADDR_TO_REG(emit->as, emit->exc_stack[i].nlr_pos, REG_ARG_1);
+        ASM_CALL_IND(emit->as, mp_fun_table[MP_F_NLR_PUSH], MP_F_NLR_PUSH);
+        ASM_JUMP_IF_REG_NONZERO(emit->as, REG_RET, emit->exc_stack[i].label);
+    }
+}
+
 STATIC void emit_native_yield_value(emit_t *emit) {
-    // not supported (for now)
-    (void)emit;
-    mp_raise_NotImplementedError("native yield");
+    DEBUG_printf("yield_value\n");
+    if (emit->do_viper_types) {
+        // not supported (for now)
+        mp_raise_NotImplementedError("native yield");
+    }
+    emit_native_pre(emit);
+    need_stack_settled(emit);
+    emit_native_gen_yield(emit, emit->stack_start + emit->stack_size - 1);
+
+    // raise any exception thrown into the generator
+    ASM_MOV_LOCAL_TO_REG(emit->as, GEN_LOCAL_THROW_VALUE, REG_ARG_1);
+    ASM_CALL_IND(emit->as, mp_fun_table[MP_F_NATIVE_RAISE], MP_F_NATIVE_RAISE);
+
+    // the sent value replaces the yielded one on the stack
+    emit_post(emit);
 }
+
 STATIC void emit_native_yield_from(emit_t *emit) {
-    // not supported (for now)
-    (void)emit;
-    mp_raise_NotImplementedError("native yield from");
+    DEBUG_printf("yield_from\n");
+    if (emit->do_viper_types) {
+        // not supported (for now)
+        mp_raise_NotImplementedError("native yield from");
+    }
+    // stack: (..., iter, send_value)
+    emit_native_pre(emit);
+    need_stack_settled(emit);
+    mp_uint_t iter_local = emit->stack_start + emit->stack_size - 2;
+    mp_uint_t loop_label = emit_native_new_label(emit);
+    mp_uint_t done_label = emit_native_new_label(emit);
+
+    // resume the iterator, nothing to throw into it the first time around
+    ASM_MOV_IMM_TO_REG(emit->as, (mp_uint_t)MP_OBJ_NULL, REG_ARG_2);
+    mp_asm_base_label_assign(&emit->as->base, loop_label);
+    ASM_MOV_LOCAL_ADDR_TO_REG(emit->as, iter_local, REG_ARG_1);
+    ASM_CALL_IND(emit->as, mp_fun_table[MP_F_NATIVE_YIELD_FROM], MP_F_NATIVE_YIELD_FROM);
+    ASM_JUMP_IF_REG_ZERO(emit->as, REG_RET, done_label);
+
+    // pass on the value it yielded, and any value thrown into us on resumption
+    emit_native_gen_yield(emit, iter_local + 1);
+    ASM_MOV_LOCAL_TO_REG(emit->as, GEN_LOCAL_THROW_VALUE, REG_ARG_2);
+    ASM_JUMP(emit->as, loop_label);
+
+    // the iterator finished and its return value replaced it on the stack
+    mp_asm_base_label_assign(&emit->as->base, done_label);
+    adjust_stack(emit, -1);
+    emit_post(emit);
 }
 
 STATIC void emit_native_start_except_handler(emit_t *emit) {
@@ -30,6 +30,9 @@
 
 #include "py/gc.h"
 #include "py/runtime.h"
+#include "py/binary.h"
+#include "py/objlist.h"
+#include "py/objarray.h"
 
 #if MICROPY_ENABLE_GC
 
@@ -92,7 +95,35 @@
 #define FTB_CLEAR(block) do { MP_STATE_MEM(gc_finaliser_table_start)[(block) / BLOCKS_PER_FTB] &= (~(1 << ((block) & 7))); } while (0)
 #endif
 
-#if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+#if MICROPY_GC_SLAB_CELLS
+// Allocations up to this many blocks can reuse a cell from the slab free lists
+#define GC_SLAB_MAX_BLOCKS (2)
+#endif
+
+#if MICROPY_GC_THREAD_ALLOC
+// Allocations up to this many blocks are taken from the thread's allocation buffer
+#define GC_THREAD_ALLOC_MAX_BLOCKS (MICROPY_GC_THREAD_ALLOC_BLOCKS / 4)
+
+// Threads modify the allocation table when they allocate from their buffer,
+// so taking the GC mutex must also stop that, and wait for any thread that
+// is in the middle of it (which only takes a few instructions, but the thread
+// may have been preempted there, so give up the CPU while waiting).
+STATIC void gc_enter(void) {
+    mp_thread_mutex_lock(&MP_STATE_MEM(gc_mutex), 1);
+    __atomic_store_n(&MP_STATE_MEM(gc_thread_alloc_blocked), 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&MP_STATE_MEM(gc_thread_alloc_active), __ATOMIC_SEQ_CST) != 0) {
+        MICROPY_THREAD_YIELD();
+    }
+}
+
+STATIC void gc_exit(void) {
+    __atomic_store_n(&MP_STATE_MEM(gc_thread_alloc_blocked), 0, __ATOMIC_RELEASE);
+    mp_thread_mutex_unlock(&MP_STATE_MEM(gc_mutex));
+}
+
+#define GC_ENTER() gc_enter()
+#define GC_EXIT() gc_exit()
+#elif MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
 #define GC_ENTER() mp_thread_mutex_lock(&MP_STATE_MEM(gc_mutex), 1)
 #define GC_EXIT() mp_thread_mutex_unlock(&MP_STATE_MEM(gc_mutex))
 #else
@@ -149,6 +180,15 @@ void gc_init(void *start, void *end) {
 
     // allow auto collection
     MP_STATE_MEM(gc_auto_collect_enabled) = 1;
+    #if MICROPY_GC_COMPACT
+    MP_STATE_MEM(gc_compacting) = false;
+    #endif
+    #if MICROPY_GC_SLAB_CELLS
+    for (size_t i = 0; i < GC_SLAB_MAX_BLOCKS; i++) {
+        MP_STATE_MEM(gc_slab_free)[i] = NULL;
+        MP_STATE_MEM(gc_slab_len)[i] = 0;
+    }
+    #endif
 
     #if MICROPY_GC_ALLOC_THRESHOLD
     // by default, maxuint for gc threshold, effectively turning gc-by-threshold off
@@ -245,10 +285,87 @@ STATIC void gc_deal_with_stack_overflow(void) {
     }
 }
 
+#if MICROPY_GC_SLAB_CELLS
+
+// The maximum length of each free list; on small heaps it's limited to 1/64th
+// of the blocks so the cached cells don't fragment the heap too much.
+STATIC size_t gc_slab_max_cells(void) {
+    return MIN(MICROPY_GC_SLAB_CELLS, MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB / 64);
+}
+
+// Called by the sweep for an unmarked head block, to keep the object's cell on
+// a slab free list instead of freeing it.  Returns false if the cell is too
+// big or the free list is already full.  The cells are unreachable so the
+// next collection sweeps them again, which rebuilds the lists from scratch.
+STATIC bool gc_slab_recycle(size_t block) {
+    size_t end_block = MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB;
+    size_t n_blocks = 1;
+    while (block + n_blocks < end_block && ATB_GET_KIND(block + n_blocks) == AT_TAIL) {
+        if (++n_blocks > GC_SLAB_MAX_BLOCKS) {
+            return false;
+        }
+    }
+    if (MP_STATE_MEM(gc_slab_len)[n_blocks - 1] >= gc_slab_max_cells()) {
+        return false;
+    }
+    void **cell = (void**)PTR_FROM_BLOCK(block);
+    *cell = MP_STATE_MEM(gc_slab_free)[n_blocks - 1];
+    MP_STATE_MEM(gc_slab_free)[n_blocks - 1] = cell;
+    MP_STATE_MEM(gc_slab_len)[n_blocks - 1] += 1;
+    return true;
+}
+
+// Take a cell of n_blocks from its free list, or return NULL if there is none
+// or if a collection is due.  Must be called with the GC mutex held.
+STATIC void *gc_slab_alloc(size_t n_blocks) {
+    void **cell = MP_STATE_MEM(gc_slab_free)[n_blocks - 1];
+    if (cell == NULL) {
+        return NULL;
+    }
+    #if MICROPY_GC_ALLOC_THRESHOLD
+    if (MP_STATE_MEM(gc_alloc_amount) >= MP_STATE_MEM(gc_alloc_threshold)) {
+        return NULL;
+    }
+    MP_STATE_MEM(gc_alloc_amount) += n_blocks;
+    #endif
+    MP_STATE_MEM(gc_slab_free)[n_blocks - 1] = *cell;
+    MP_STATE_MEM(gc_slab_len)[n_blocks - 1] -= 1;
+    return cell;
+}
+
+// Give all cached cells back to the heap, returning false if there were none.
+// Must be called with the GC mutex held.
+STATIC bool gc_slab_flush(void) {
+    bool flushed = false;
+    for (size_t i = 0; i < GC_SLAB_MAX_BLOCKS; i++) {
+        for (void **cell = MP_STATE_MEM(gc_slab_free)[i]; cell != NULL; cell = *cell) {
+            size_t block = BLOCK_FROM_PTR(cell);
+            if (block / BLOCKS_PER_ATB < MP_STATE_MEM(gc_last_free_atb_index)) {
+                MP_STATE_MEM(gc_last_free_atb_index) = block / BLOCKS_PER_ATB;
+            }
+            for (size_t bl = block; bl <= block + i; bl++) {
+                ATB_ANY_TO_FREE(bl);
+            }
+            flushed = true;
+        }
+        MP_STATE_MEM(gc_slab_free)[i] = NULL;
+        MP_STATE_MEM(gc_slab_len)[i] = 0;
+    }
+    return flushed;
+}
+
+#endif // MICROPY_GC_SLAB_CELLS
+
 STATIC void gc_sweep(void) {
     #if MICROPY_PY_GC_COLLECT_RETVAL
     MP_STATE_MEM(gc_collected) = 0;
     #endif
+    #if MICROPY_GC_SLAB_CELLS
+    for (size_t i = 0; i < GC_SLAB_MAX_BLOCKS; i++) {
+        MP_STATE_MEM(gc_slab_free)[i] = NULL;
+        MP_STATE_MEM(gc_slab_len)[i] = 0;
+    }
+    #endif
     // free unmarked heads and their tails
     int free_tail = 0;
     for (size_t block = 0; block < MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB; block++) {
@@ -281,6 +398,13 @@ STATIC void gc_sweep(void) {
                 #if MICROPY_PY_GC_COLLECT_RETVAL
                 MP_STATE_MEM(gc_collected)++;
                 #endif
+                #if MICROPY_GC_SLAB_CELLS
+                if (gc_slab_recycle(block)) {
+                    // keep the head and its tails allocated
+                    free_tail = 0;
+                    break;
+                }
+                #endif
                 // fall through to free the head
 
             case AT_TAIL:
@@ -297,12 +421,212 @@ STATIC void gc_sweep(void) {
     }
 }
 
+#if MICROPY_GC_COMPACT
+
+// Compaction moves the storage of some kinds of objects (the items of lists,
+// bytearrays and arrays, and the tables of dicts) into holes lower in the heap
+// and updates the owning object.  This is only safe if the owner holds the only
+// pointer to the storage, so compaction runs a special collection which counts
+// the pointers to the storage from the roots (including C stacks, which pins
+// storage in use by C code) and from everything allocated on the heap, and
+// moves the storage with a single pointer.  While counting, storage that may
+// be moved is marked AT_MARK, and its FTB bit records that a pointer was found.
+// A second pointer turns it back into AT_HEAD, so it stays where it is.
+
+STATIC size_t gc_n_blocks(size_t block) {
+    size_t n_blocks = 0;
+    do {
+        n_blocks += 1;
+    } while (ATB_GET_KIND(block + n_blocks) == AT_TAIL);
+    return n_blocks;
+}
+
+// If the object in the given chain of blocks owns movable storage, return a
+// pointer to the owner's pointer to it, and the size of the storage in bytes.
+STATIC void **gc_compact_owned(size_t block, size_t *n_bytes) {
+    const mp_obj_base_t *o = (mp_obj_base_t*)PTR_FROM_BLOCK(block);
+    size_t obj_bytes = gc_n_blocks(block) * BYTES_PER_BLOCK;
+    if (o->type == &mp_type_list && obj_bytes >= sizeof(mp_obj_list_t)) {
+        mp_obj_list_t *l = (mp_obj_list_t*)o;
+        *n_bytes = l->alloc * sizeof(mp_obj_t);
+        return (void**)&l->items;
+    }
+    if ((o->type == &mp_type_bytearray
+        #if MICROPY_PY_ARRAY
+        || o->type == &mp_type_array
+        #endif
+        ) && obj_bytes >= sizeof(mp_obj_array_t)) {
+        mp_obj_array_t *a = (mp_obj_array_t*)o;
+        // don't raise an exception for a bad typecode
+        if (a->typecode != BYTEARRAY_TYPECODE && (a->typecode == 0 || strchr("bBhHiIlLqQfd", a->typecode) == NULL)) {
+            return NULL;
+        }
+        *n_bytes = (a->len + a->free) * mp_binary_get_size('@', a->typecode, NULL);
+        return &a->items;
+    }
+    if ((o->type == &mp_type_dict
+        #if MICROPY_PY_COLLECTIONS_ORDEREDDICT
+        || o->type == &mp_type_ordereddict
+        #endif
+        ) && obj_bytes >= sizeof(mp_obj_dict_t)) {
+        mp_obj_dict_t *d = (mp_obj_dict_t*)o;
+        *n_bytes = d->map.alloc * sizeof(mp_map_elem_t);
+        return (void**)&d->map.table;
+    }
+    return NULL;
+}
+
+// Return the block of the storage owned by the object in the given chain of
+// blocks which is marked with the given kind, or 0 (which is never storage).
+STATIC size_t gc_compact_storage(size_t block, int kind, void ***owner_ptr) {
+    size_t n_bytes;
+    void **ptr = gc_compact_owned(block, &n_bytes);
+    if (ptr == NULL || n_bytes == 0 || !VERIFY_PTR(*ptr)) {
+        return 0;
+    }
+    size_t storage = BLOCK_FROM_PTR(*ptr);
+    if (storage == block || ATB_GET_KIND(storage) != kind
+        || gc_n_blocks(storage) != (n_bytes + BYTES_PER_BLOCK - 1) / BYTES_PER_BLOCK) {
+        return 0;
+    }
+    *owner_ptr = ptr;
+    return storage;
+}
+
+STATIC void gc_compact_count(void *ptr) {
+    if (ptr < (void*)MP_STATE_MEM(gc_pool_start) || ptr >= (void*)MP_STATE_MEM(gc_pool_end)) {
+        return;
+    }
+    // pointers into the middle of the storage count as well
+    size_t block = BLOCK_FROM_PTR(ptr);
+    while (ATB_GET_KIND(block) == AT_TAIL) {
+        block--;
+    }
+    if (ATB_GET_KIND(block) == AT_MARK) {
+        if (FTB_GET(block)) {
+            ATB_MARK_TO_HEAD(block);
+            FTB_CLEAR(block);
+        } else {
+            FTB_SET(block);
+        }
+    }
+}
+
+STATIC void gc_compact_start(void) {
+    size_t total_blocks = MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB;
+
+    // find storage that may be moved, with no finaliser
+    for (size_t block = 0; block < total_blocks; block++) {
+        int kind = ATB_GET_KIND(block);
+        if (kind == AT_HEAD || kind == AT_MARK) {
+            void **owner_ptr;
+            size_t storage = gc_compact_storage(block, AT_HEAD, &owner_ptr);
+            if (storage != 0 && !FTB_GET(storage)) {
+                ATB_HEAD_TO_MARK(storage);
+            }
+        }
+    }
+
+    // count the pointers from everything on the heap, including the owners
+    for (size_t block = 0; block < total_blocks; block++) {
+        if (ATB_GET_KIND(block) != AT_FREE) {
+            void **ptrs = (void**)PTR_FROM_BLOCK(block);
+            for (size_t i = 0; i < WORDS_PER_BLOCK; i++) {
+                gc_compact_count(ptrs[i]);
+            }
+        }
+    }
+}
+
+STATIC void gc_compact_end(void) {
+    size_t total_blocks = MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB;
+    size_t first_free = 0;
+
+    // go down from the top of the heap, so free memory collects at the top
+    for (size_t block = total_blocks; block-- > 0;) {
+        int kind = ATB_GET_KIND(block);
+        if (kind != AT_HEAD && kind != AT_MARK) {
+            continue;
+        }
+        void **owner_ptr;
+        size_t storage = gc_compact_storage(block, AT_MARK, &owner_ptr);
+        if (storage == 0 || !FTB_GET(storage)) {
+            continue;
+        }
+
+        // the owner has the only pointer to the storage, so look for the
+        // lowest free chunk which is big enough and below the storage
+        size_t n_blocks = gc_n_blocks(storage);
+        while (first_free < storage && ATB_GET_KIND(first_free) != AT_FREE) {
+            first_free++;
+        }
+        size_t dest = first_free;
+        size_t n_free = 0;
+        while (n_free < n_blocks && dest + n_free < storage) {
+            if (ATB_GET_KIND(dest + n_free) == AT_FREE) {
+                n_free++;
+            } else {
+                dest += n_free + 1;
+                n_free = 0;
+            }
+        }
+        if (n_free < n_blocks) {
+            continue;
+        }
+
+        // move the storage and free the old blocks
+        ATB_FREE_TO_HEAD(dest);
+        for (size_t bl = dest + 1; bl < dest + n_blocks; bl++) {
+            ATB_FREE_TO_TAIL(bl);
+        }
+        memcpy((void*)PTR_FROM_BLOCK(dest), (void*)PTR_FROM_BLOCK(storage), n_blocks * BYTES_PER_BLOCK);
+        *owner_ptr = (void*)PTR_FROM_BLOCK(dest);
+        for (size_t bl = storage; bl < storage + n_blocks; bl++) {
+            ATB_ANY_TO_FREE(bl);
+        }
+        FTB_CLEAR(storage);
+    }
+
+    // put back the storage that wasn't moved
+    for (size_t block = 0; block < total_blocks; block++) {
+        if (ATB_GET_KIND(block) == AT_MARK) {
+            ATB_MARK_TO_HEAD(block);
+            FTB_CLEAR(block);
+        }
+    }
+}
+
+size_t gc_compact(void) {
+    gc_info_t info;
+    gc_collect();
+    gc_info(&info);
+    size_t max_free = info.max_free;
+
+    // this collection counts pointers instead of marking, and frees nothing
+    MP_STATE_MEM(gc_compacting) = true;
+    gc_collect();
+    MP_STATE_MEM(gc_compacting) = false;
+
+    gc_info(&info);
+    if (info.max_free <= max_free) {
+        return 0;
+    }
+    return (info.max_free - max_free) * BYTES_PER_BLOCK;
+}
+
+#endif // MICROPY_GC_COMPACT
+
 void gc_collect_start(void) {
     GC_ENTER();
     MP_STATE_MEM(gc_lock_depth)++;
     #if MICROPY_GC_ALLOC_THRESHOLD
     MP_STATE_MEM(gc_alloc_amount) = 0;
     #endif
+    #if MICROPY_GC_COMPACT
+    if (MP_STATE_MEM(gc_compacting)) {
+        gc_compact_start();
+    }
+    #endif
     MP_STATE_MEM(gc_stack_overflow) = 0;
     MP_STATE_MEM(gc_sp) = MP_STATE_MEM(gc_stack);
     // Trace root pointers.  This relies on the root pointers being organised
@@ -310,9 +634,25 @@ void gc_collect_start(void) {
     // dict_globals, then the root pointer section of mp_state_vm.
     void **ptrs = (void**)(void*)&mp_state_ctx;
     gc_collect_root(ptrs, offsetof(mp_state_ctx_t, vm.qstr_last_chunk) / sizeof(void*));
+
+    #if MICROPY_ENABLE_PYSTACK
+    // Trace the used part of the pystack of the current thread.  Ports with
+    // threads must trace the pystacks of other threads when they scan their
+    // stacks, because those threads may be modifying them concurrently.
+    ptrs = (void**)(void*)MP_STATE_THREAD(pystack_start);
+    gc_collect_root(ptrs, (MP_STATE_THREAD(pystack_cur) - MP_STATE_THREAD(pystack_start)) / sizeof(void*));
+    #endif
 }
 
 void gc_collect_root(void **ptrs, size_t len) {
+    #if MICROPY_GC_COMPACT
+    if (MP_STATE_MEM(gc_compacting)) {
+        for (size_t i = 0; i < len; i++) {
+            gc_compact_count(ptrs[i]);
+        }
+        return;
+    }
+    #endif
     for (size_t i = 0; i < len; i++) {
         void *ptr = ptrs[i];
         VERIFY_MARK_AND_PUSH(ptr);
@@ -320,10 +660,196 @@ void gc_collect_root(void **ptrs, size_t len) {
     }
 }
 
+#if MICROPY_GC_PARALLEL_MARK
+
+typedef struct _gc_mark_deque_t gc_mark_deque_t;
+
+// Roots are handed out to the marking threads in chunks of this many pointers
+#define GC_MARK_CHUNK_LEN (256)
+
+// Marks an unmarked head block, returning false if another thread got there
+// first.  Other threads may be marking blocks in the same allocation table
+// byte, so atomically set just the bit that turns a HEAD into a MARK.
+STATIC bool gc_mark_claim(size_t block) {
+    byte *atb = &MP_STATE_MEM(gc_alloc_table_start)[block / BLOCKS_PER_ATB];
+    byte old = __atomic_fetch_or(atb, (byte)(AT_TAIL << BLOCK_SHIFT(block)), __ATOMIC_RELAXED);
+    return ((old >> BLOCK_SHIFT(block)) & 3) == AT_HEAD;
+}
+
+// The mark stacks are Chase-Lev work-stealing deques with a fixed size: on
+// overflow the block stays marked and gc_deal_with_stack_overflow traces it.
+STATIC void gc_mark_push(gc_mark_deque_t *dq, size_t block) {
+    ptrdiff_t b = dq->bottom;
+    ptrdiff_t t = __atomic_load_n(&dq->top, __ATOMIC_ACQUIRE);
+    if (b - t >= MICROPY_ALLOC_GC_STACK_SIZE) {
+        __atomic_store_n(&MP_STATE_MEM(gc_stack_overflow), 1, __ATOMIC_RELAXED);
+        return;
+    }
+    dq->blocks[b % MICROPY_ALLOC_GC_STACK_SIZE] = block;
+    __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELEASE);
+}
+
+STATIC bool gc_mark_pop(gc_mark_deque_t *dq, size_t *block) {
+    ptrdiff_t b = dq->bottom - 1;
+    __atomic_store_n(&dq->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    ptrdiff_t t = __atomic_load_n(&dq->top, __ATOMIC_RELAXED);
+    if (t > b) {
+        // empty
+        __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    *block = dq->blocks[b % MICROPY_ALLOC_GC_STACK_SIZE];
+    if (t < b) {
+        return true;
+    }
+    // this is the last block, so a thief may be taking it at the same time
+    bool won = __atomic_compare_exchange_n(&dq->top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+    __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELAXED);
+    return won;
+}
+
+STATIC bool gc_mark_steal(gc_mark_deque_t *dq, size_t *block) {
+    ptrdiff_t t = __atomic_load_n(&dq->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    ptrdiff_t b = __atomic_load_n(&dq->bottom, __ATOMIC_ACQUIRE);
+    if (t >= b) {
+        return false;
+    }
+    *block = dq->blocks[t % MICROPY_ALLOC_GC_STACK_SIZE];
+    return __atomic_compare_exchange_n(&dq->top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+STATIC void gc_mark_parallel_ptr(gc_mark_deque_t *dq, void *ptr) {
+    if (VERIFY_PTR(ptr)) {
+        size_t block = BLOCK_FROM_PTR(ptr);
+        // the kind must be checked first because only a HEAD may become a MARK
+        if (ATB_GET_KIND(block) == AT_HEAD && gc_mark_claim(block)) {
+            gc_mark_push(dq, block);
+        }
+    }
+}
+
+// Traces the children of the given block, then of everything on the mark stack
+STATIC void gc_mark_parallel_drain(gc_mark_deque_t *dq, size_t block) {
+    do {
+        size_t n_blocks = 0;
+        do {
+            n_blocks += 1;
+        } while (ATB_GET_KIND(block + n_blocks) == AT_TAIL);
+
+        void **ptrs = (void**)PTR_FROM_BLOCK(block);
+        for (size_t i = n_blocks * BYTES_PER_BLOCK / sizeof(void*); i > 0; i--, ptrs++) {
+            gc_mark_parallel_ptr(dq, *ptrs);
+        }
+    } while (gc_mark_pop(dq, &block));
+}
+
+// Marks the next chunk of roots, returning false if there are none left
+STATIC bool gc_mark_parallel_roots(gc_mark_deque_t *dq) {
+    size_t chunk = __atomic_fetch_add(&MP_STATE_MEM(gc_mark_next_chunk), 1, __ATOMIC_RELAXED);
+    if (chunk >= MP_STATE_MEM(gc_mark_n_chunks)) {
+        return false;
+    }
+    gc_root_range_t *root = MP_STATE_MEM(gc_mark_roots);
+    for (size_t n; chunk >= (n = (root->len + GC_MARK_CHUNK_LEN - 1) / GC_MARK_CHUNK_LEN); root++) {
+        chunk -= n;
+    }
+    size_t end = MIN((chunk + 1) * GC_MARK_CHUNK_LEN, root->len);
+    for (size_t i = chunk * GC_MARK_CHUNK_LEN; i < end; i++) {
+        size_t block;
+        gc_mark_parallel_ptr(dq, root->ptrs[i]);
+        if (gc_mark_pop(dq, &block)) {
+            gc_mark_parallel_drain(dq, block);
+        }
+    }
+    return true;
+}
+
+STATIC bool gc_mark_parallel_steal(size_t worker, size_t *block) {
+    size_t n_workers = MP_STATE_MEM(gc_mark_n_workers);
+    for (size_t i = 1; i < n_workers; i++) {
+        if (gc_mark_steal(&MP_STATE_MEM(gc_mark_deques)[(worker + i) % n_workers], block)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+STATIC bool gc_mark_parallel_has_work(void) {
+    for (size_t i = 0; i < MP_STATE_MEM(gc_mark_n_workers); i++) {
+        gc_mark_deque_t *dq = &MP_STATE_MEM(gc_mark_deques)[i];
+        if (__atomic_load_n(&dq->top, __ATOMIC_ACQUIRE) < __atomic_load_n(&dq->bottom, __ATOMIC_ACQUIRE)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void gc_mark_parallel_start(gc_root_range_t *roots, size_t n_roots, size_t n_workers) {
+    assert(n_workers >= 1 && n_workers <= MICROPY_GC_PARALLEL_MARK_WORKERS);
+    size_t n_chunks = 0;
+    for (size_t i = 0; i < n_roots; i++) {
+        n_chunks += (roots[i].len + GC_MARK_CHUNK_LEN - 1) / GC_MARK_CHUNK_LEN;
+    }
+    for (size_t i = 0; i < n_workers; i++) {
+        MP_STATE_MEM(gc_mark_deques)[i].top = 0;
+        MP_STATE_MEM(gc_mark_deques)[i].bottom = 0;
+    }
+    MP_STATE_MEM(gc_mark_roots) = roots;
+    MP_STATE_MEM(gc_mark_n_workers) = n_workers;
+    MP_STATE_MEM(gc_mark_n_chunks) = n_chunks;
+    MP_STATE_MEM(gc_mark_next_chunk) = 0;
+    MP_STATE_MEM(gc_mark_active) = n_workers;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void gc_mark_parallel(size_t worker) {
+    gc_mark_deque_t *dq = &MP_STATE_MEM(gc_mark_deques)[worker];
+    for (;;) {
+        size_t block;
+        if (gc_mark_parallel_roots(dq)) {
+            continue;
+        }
+        // the roots are all taken, so help the threads still tracing them
+        if (gc_mark_parallel_steal(worker, &block)) {
+            gc_mark_parallel_drain(dq, block);
+            continue;
+        }
+        // No work was found, so go idle until another thread has some to steal
+        // or all are idle, which means marking is done: threads only go idle
+        // with an empty mark stack, and idle threads don't push any blocks.
+        __atomic_sub_fetch(&MP_STATE_MEM(gc_mark_active), 1, __ATOMIC_SEQ_CST);
+        for (;;) {
+            if (__atomic_load_n(&MP_STATE_MEM(gc_mark_active), __ATOMIC_SEQ_CST) == 0) {
+                return;
+            }
+            if (gc_mark_parallel_has_work()) {
+                __atomic_add_fetch(&MP_STATE_MEM(gc_mark_active), 1, __ATOMIC_SEQ_CST);
+                break;
+            }
+            // Workers may be marking from a signal handler (as on unix), where
+            // giving up the CPU isn't async-signal-safe, so just spin.
+        }
+    }
+}
+
+#endif // MICROPY_GC_PARALLEL_MARK
+
 void gc_collect_end(void) {
-    gc_deal_with_stack_overflow();
-    gc_sweep();
+    #if MICROPY_GC_COMPACT
+    if (MP_STATE_MEM(gc_compacting)) {
+        gc_compact_end();
+    } else
+    #endif
+    {
+        gc_deal_with_stack_overflow();
+        gc_sweep();
+    }
     MP_STATE_MEM(gc_last_free_atb_index) = 0;
+    #if MICROPY_GC_THREAD_ALLOC
+    MP_STATE_MEM(gc_thread_alloc_atb_index) = 0;
+    #endif
     MP_STATE_MEM(gc_lock_depth)--;
     GC_EXIT();
 }
@@ -387,11 +913,109 @@ void gc_info(gc_info_t *info) {
         }
     }
 
+    #if MICROPY_GC_SLAB_CELLS
+    // cells on the slab free lists are free memory which is kept for reuse
+    for (size_t i = 0; i < GC_SLAB_MAX_BLOCKS; i++) {
+        size_t n_blocks = MP_STATE_MEM(gc_slab_len)[i] * (i + 1);
+        info->used -= n_blocks;
+        info->free += n_blocks;
+    }
+    #endif
+
     info->used *= BYTES_PER_BLOCK;
     info->free *= BYTES_PER_BLOCK;
     GC_EXIT();
 }
 
+#if MICROPY_GC_THREAD_ALLOC
+
+// Take n_blocks from the allocation buffer of the current thread, without
+// taking the GC mutex.  The unused part of the buffer is kept allocated as a
+// single chunk (so nothing else can use it), which is zeroed, and carving a
+// new allocation off its front only needs the chunk's head moving along.
+// The buffer's blocks fill whole allocation table bytes, so threads never
+// write to the same byte.  Returns NULL if the slow path must be used.
+STATIC void *gc_thread_alloc(size_t n_blocks) {
+    mp_state_thread_t *ts = mp_thread_get_state();
+    if (n_blocks > ts->gc_alloc_buf_n_blocks) {
+        return NULL;
+    }
+    void *ret_ptr = NULL;
+    __atomic_add_fetch(&MP_STATE_MEM(gc_thread_alloc_active), 1, __ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&MP_STATE_MEM(gc_thread_alloc_blocked), __ATOMIC_SEQ_CST)
+        && MP_STATE_MEM(gc_lock_depth) == 0) {
+        ret_ptr = ts->gc_alloc_buf;
+        ts->gc_alloc_buf_n_blocks -= n_blocks;
+        if (ts->gc_alloc_buf_n_blocks == 0) {
+            ts->gc_alloc_buf = NULL;
+        } else {
+            size_t block = BLOCK_FROM_PTR(ret_ptr) + n_blocks;
+            ATB_ANY_TO_FREE(block);
+            ATB_FREE_TO_HEAD(block);
+            ts->gc_alloc_buf = (byte*)PTR_FROM_BLOCK(block);
+        }
+    }
+    __atomic_sub_fetch(&MP_STATE_MEM(gc_thread_alloc_active), 1, __ATOMIC_SEQ_CST);
+    return ret_ptr;
+}
+
+// Give a new allocation buffer to the current thread, with the first n_blocks
+// of it allocated to the caller.  Must be called with the GC mutex held.
+STATIC void *gc_thread_alloc_refill(size_t n_blocks) {
+    // look for a run of free allocation table bytes
+    const size_t n_atb = MICROPY_GC_THREAD_ALLOC_BLOCKS / BLOCKS_PER_ATB;
+    size_t n_free = 0;
+    size_t i = MP_STATE_MEM(gc_thread_alloc_atb_index);
+    if (i < MP_STATE_MEM(gc_last_free_atb_index)) {
+        i = MP_STATE_MEM(gc_last_free_atb_index);
+    }
+    for (; i < MP_STATE_MEM(gc_alloc_table_byte_len); i++) {
+        if (MP_STATE_MEM(gc_alloc_table_start)[i] != 0) {
+            n_free = 0;
+        } else if (++n_free == n_atb) {
+            break;
+        }
+    }
+    if (n_free < n_atb) {
+        MP_STATE_MEM(gc_thread_alloc_atb_index) = MP_STATE_MEM(gc_alloc_table_byte_len);
+        return NULL;
+    }
+    MP_STATE_MEM(gc_thread_alloc_atb_index) = i + 1;
+
+    // return the rest of the old buffer to the heap
+    mp_state_thread_t *ts = mp_thread_get_state();
+    if (ts->gc_alloc_buf != NULL) {
+        size_t block = BLOCK_FROM_PTR(ts->gc_alloc_buf);
+        for (size_t bl = block; bl < block + ts->gc_alloc_buf_n_blocks; bl++) {
+            ATB_ANY_TO_FREE(bl);
+        }
+        if (block / BLOCKS_PER_ATB < MP_STATE_MEM(gc_last_free_atb_index)) {
+            MP_STATE_MEM(gc_last_free_atb_index) = block / BLOCKS_PER_ATB;
+        }
+    }
+
+    // mark the allocation and the rest of the buffer as two chunks
+    size_t start_block = (i + 1 - n_atb) * BLOCKS_PER_ATB;
+    size_t end_block = start_block + MICROPY_GC_THREAD_ALLOC_BLOCKS;
+    for (size_t bl = start_block; bl < end_block; bl++) {
+        if (bl == start_block || bl == start_block + n_blocks) {
+            ATB_FREE_TO_HEAD(bl);
+        } else {
+            ATB_FREE_TO_TAIL(bl);
+        }
+    }
+    ts->gc_alloc_buf = (byte*)PTR_FROM_BLOCK(start_block + n_blocks);
+    ts->gc_alloc_buf_n_blocks = MICROPY_GC_THREAD_ALLOC_BLOCKS - n_blocks;
+
+    #if MICROPY_GC_ALLOC_THRESHOLD
+    MP_STATE_MEM(gc_alloc_amount) += MICROPY_GC_THREAD_ALLOC_BLOCKS;
+    #endif
+
+    return (void*)PTR_FROM_BLOCK(start_block);
+}
+
+#endif // MICROPY_GC_THREAD_ALLOC
+
 void *gc_alloc(size_t n_bytes, bool has_finaliser) {
     size_t n_blocks = ((n_bytes + BYTES_PER_BLOCK - 1) & (~(BYTES_PER_BLOCK - 1))) / BYTES_PER_BLOCK;
     DEBUG_printf("gc_alloc(" UINT_FMT " bytes -> " UINT_FMT " blocks)\n", n_bytes, n_blocks);
@@ -401,6 +1025,17 @@ void *gc_alloc(size_t n_bytes, bool has_finaliser) {
         return NULL;
     }
 
+    #if MICROPY_GC_THREAD_ALLOC
+    // fast path for small allocations, the memory is already zeroed
+    bool use_thread_buf = !has_finaliser && n_blocks <= GC_THREAD_ALLOC_MAX_BLOCKS;
+    if (use_thread_buf) {
+        void *ret_ptr = gc_thread_alloc(n_blocks);
+        if (ret_ptr != NULL) {
+            return ret_ptr;
+        }
+    }
+    #endif
+
     GC_ENTER();
 
     // check if GC is locked
@@ -409,6 +1044,31 @@ void *gc_alloc(size_t n_bytes, bool has_finaliser) {
         return NULL;
     }
 
+    #if MICROPY_GC_SLAB_CELLS
+    // reuse a recycled cell, without searching the allocation table
+    if (!has_finaliser && n_blocks <= GC_SLAB_MAX_BLOCKS) {
+        void *ret_ptr = gc_slab_alloc(n_blocks);
+        if (ret_ptr != NULL) {
+            GC_EXIT();
+            memset(ret_ptr, 0, n_blocks * BYTES_PER_BLOCK);
+            return ret_ptr;
+        }
+    }
+    #endif
+
+    #if MICROPY_GC_THREAD_ALLOC
+    if (use_thread_buf) {
+        void *ret_ptr = gc_thread_alloc_refill(n_blocks);
+        if (ret_ptr != NULL) {
+            GC_EXIT();
+            // zero the allocation and the new buffer
+            memset(ret_ptr, 0, MICROPY_GC_THREAD_ALLOC_BLOCKS * BYTES_PER_BLOCK);
+            return ret_ptr;
+        }
+        // no room for a new buffer, allocate normally
+    }
+    #endif
+
     size_t i;
     size_t end_block;
     size_t start_block;
@@ -434,6 +1094,14 @@ void *gc_alloc(size_t n_bytes, bool has_finaliser) {
             if (ATB_3_IS_FREE(a)) { if (++n_free >= n_blocks) { i = i * BLOCKS_PER_ATB + 3; goto found; } } else { n_free = 0; }
         }
 
+        #if MICROPY_GC_SLAB_CELLS
+        // give the cached cells back to the heap and look again
+        if (gc_slab_flush()) {
+            n_free = 0;
+            continue;
+        }
+        #endif
+
         GC_EXIT();
         // nothing found!
         if (collected) {
@@ -765,6 +1433,11 @@ void gc_dump_info(void) {
         (uint)info.total, (uint)info.used, (uint)info.free);
     mp_printf(&mp_plat_print, " No. of 1-blocks: %u, 2-blocks: %u, max blk sz: %u, max free sz: %u\n",
            (uint)info.num_1block, (uint)info.num_2block, (uint)info.max_block, (uint)info.max_free);
+    #if MICROPY_GC_SLAB_CELLS
+    mp_printf(&mp_plat_print, " Slab cells: 1-blocks: %u/%u, 2-blocks: %u/%u\n",
+        (uint)MP_STATE_MEM(gc_slab_len)[0], (uint)gc_slab_max_cells(),
+        (uint)MP_STATE_MEM(gc_slab_len)[1], (uint)gc_slab_max_cells());
+    #endif
 }
 
 void gc_dump_alloc_table(void) {
@@ -45,6 +45,23 @@ void gc_collect_start(void);
 void gc_collect_root(void **ptrs, size_t len);
 void gc_collect_end(void);
 
+#if MICROPY_GC_PARALLEL_MARK
+typedef struct _gc_root_range_t {
+    void **ptrs;
+    size_t len;
+} gc_root_range_t;
+
+// Marks the given roots using up to MICROPY_GC_PARALLEL_MARK_WORKERS threads.
+// Between gc_collect_start and gc_collect_end the collecting thread calls
+// gc_mark_parallel_start, then it calls gc_mark_parallel(0) while each of the
+// other n_workers - 1 threads calls gc_mark_parallel with its own worker
+// number.  Every call returns once all the roots and everything they reach
+// are marked.  gc_mark_parallel only uses atomic operations and may be called
+// from a signal handler.
+void gc_mark_parallel_start(gc_root_range_t *roots, size_t n_roots, size_t n_workers);
+void gc_mark_parallel(size_t worker);
+#endif
+
 void *gc_alloc(size_t n_bytes, bool has_finaliser);
 void gc_free(void *ptr); // does not call finaliser
 size_t gc_nbytes(const void *ptr);
@@ -61,6 +78,10 @@ typedef struct _gc_info_t {
 } gc_info_t;
 
 void gc_info(gc_info_t *info);
+
+// Move movable storage to fill holes in the heap, returns the number of
+// bytes by which the largest free chunk grew.
+size_t gc_compact(void);
 void gc_dump_info(void);
 void gc_dump_alloc_table(void);
 
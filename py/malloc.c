@@ -79,6 +79,7 @@ void *m_malloc(size_t num_bytes) {
 #if MICROPY_MEM_STATS
     MP_STATE_MEM(total_bytes_allocated) += num_bytes;
     MP_STATE_MEM(current_bytes_allocated) += num_bytes;
+    MP_STATE_MEM(total_allocs) += 1;
     UPDATE_PEAK();
 #endif
     DEBUG_printf("malloc %d : %p\n", num_bytes, ptr);
@@ -90,6 +91,7 @@ void *m_malloc_maybe(size_t num_bytes) {
 #if MICROPY_MEM_STATS
     MP_STATE_MEM(total_bytes_allocated) += num_bytes;
     MP_STATE_MEM(current_bytes_allocated) += num_bytes;
+    MP_STATE_MEM(total_allocs) += 1;
     UPDATE_PEAK();
 #endif
     DEBUG_printf("malloc %d : %p\n", num_bytes, ptr);
@@ -105,6 +107,7 @@ void *m_malloc_with_finaliser(size_t num_bytes) {
 #if MICROPY_MEM_STATS
     MP_STATE_MEM(total_bytes_allocated) += num_bytes;
     MP_STATE_MEM(current_bytes_allocated) += num_bytes;
+    MP_STATE_MEM(total_allocs) += 1;
     UPDATE_PEAK();
 #endif
     DEBUG_printf("malloc %d : %p\n", num_bytes, ptr);
@@ -196,4 +199,8 @@ size_t m_get_current_bytes_allocated(void) {
 size_t m_get_peak_bytes_allocated(void) {
     return MP_STATE_MEM(peak_bytes_allocated);
 }
+
+size_t m_get_total_allocs(void) {
+    return MP_STATE_MEM(total_allocs);
+}
 #endif
@@ -69,6 +69,26 @@ STATIC size_t get_hash_alloc_greater_or_equal_to(size_t x) {
 /******************************************************************************/
 /* map                                                                        */
 
+#if MICROPY_OPT_CACHE_GLOBAL_LOOKUP
+// Version tags come from a single counter so a tag identifies the layout of
+// one map, even if that map is freed and another one is put in its place.
+// A new tag is published only once the change to the map is complete, so a
+// reader that sees it also sees the change.  Without a GIL threads can take
+// tags at the same time, so the counter must be incremented atomically.
+#if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+#define MAP_NEW_VERSION(map) __atomic_store_n(&(map)->version, \
+    __atomic_add_fetch(&MP_STATE_VM(map_version_counter), 1, __ATOMIC_RELAXED), __ATOMIC_RELEASE)
+#else
+#define MAP_NEW_VERSION(map) ((map)->version = ++MP_STATE_VM(map_version_counter))
+#endif
+
+void mp_map_new_version(mp_map_t *map) {
+    MAP_NEW_VERSION(map);
+}
+#else
+#define MAP_NEW_VERSION(map) (void)(map)
+#endif
+
 void mp_map_init(mp_map_t *map, size_t n) {
     if (n == 0) {
         map->alloc = 0;
@@ -81,6 +101,7 @@ void mp_map_init(mp_map_t *map, size_t n) {
     map->all_keys_are_qstrs = 1;
     map->is_fixed = 0;
     map->is_ordered = 0;
+    MAP_NEW_VERSION(map);
 }
 
 void mp_map_init_fixed_table(mp_map_t *map, size_t n, const mp_obj_t *table) {
@@ -90,6 +111,7 @@ void mp_map_init_fixed_table(mp_map_t *map, size_t n, const mp_obj_t *table) {
     map->is_fixed = 1;
     map->is_ordered = 1;
     map->table = (mp_map_elem_t*)table;
+    MAP_NEW_VERSION(map);
 }
 
 // Differentiate from mp_map_clear() - semantics is different
@@ -109,6 +131,7 @@ void mp_map_clear(mp_map_t *map) {
     map->all_keys_are_qstrs = 1;
     map->is_fixed = 0;
     map->table = NULL;
+    MAP_NEW_VERSION(map);
 }
 
 STATIC void mp_map_rehash(mp_map_t *map) {
@@ -135,7 +158,7 @@ STATIC void mp_map_rehash(mp_map_t *map) {
 //  - returns slot, with key non-null and value=MP_OBJ_NULL if it was added
 // MP_MAP_LOOKUP_REMOVE_IF_FOUND behaviour:
 //  - returns NULL if not found, else the slot if was found in with key null and value non-null
-mp_map_elem_t *mp_map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t lookup_kind) {
+STATIC mp_map_elem_t *map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t lookup_kind) {
     // If the map is a fixed array then we must only be called for a lookup
     assert(!map->is_fixed || lookup_kind == MP_MAP_LOOKUP);
 
@@ -281,6 +304,18 @@ mp_map_elem_t *mp_map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t
     }
 }
 
+mp_map_elem_t *mp_map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t lookup_kind) {
+    mp_map_elem_t *elem = map_lookup(map, index, lookup_kind);
+    #if MICROPY_OPT_CACHE_GLOBAL_LOOKUP
+    // An add or remove may have changed the layout of the table.  The value in
+    // a slot isn't covered by the version, since callers store it afterwards.
+    if (lookup_kind != MP_MAP_LOOKUP && !map->is_fixed) {
+        MAP_NEW_VERSION(map);
+    }
+    #endif
+    return elem;
+}
+
 /******************************************************************************/
 /* set                                                                        */
 
@@ -39,8 +39,19 @@ STATIC NORETURN void math_error(void) {
     mp_raise_ValueError("math domain error");
 }
 
+// Get the value of an argument as a float, checking for the common case of a
+// float before the generic conversion of any number
+static inline mp_float_t math_get_float(mp_obj_t x_obj) {
+    #if MICROPY_OPT_FAST_FLOAT
+    if (mp_obj_is_float(x_obj)) {
+        return mp_obj_float_get(x_obj);
+    }
+    #endif
+    return mp_obj_get_float(x_obj);
+}
+
 STATIC mp_obj_t math_generic_1(mp_obj_t x_obj, mp_float_t (*f)(mp_float_t)) {
-    mp_float_t x = mp_obj_get_float(x_obj);
+    mp_float_t x = math_get_float(x_obj);
     mp_float_t ans = f(x);
     if ((isnan(ans) && !isnan(x)) || (isinf(ans) && !isinf(x))) {
         math_error();
@@ -49,8 +60,8 @@ STATIC mp_obj_t math_generic_1(mp_obj_t x_obj, mp_float_t (*f)(mp_float_t)) {
 }
 
 STATIC mp_obj_t math_generic_2(mp_obj_t x_obj, mp_obj_t y_obj, mp_float_t (*f)(mp_float_t, mp_float_t)) {
-    mp_float_t x = mp_obj_get_float(x_obj);
-    mp_float_t y = mp_obj_get_float(y_obj);
+    mp_float_t x = math_get_float(x_obj);
+    mp_float_t y = math_get_float(y_obj);
     mp_float_t ans = f(x, y);
     if ((isnan(ans) && !isnan(x) && !isnan(y)) || (isinf(ans) && !isinf(x))) {
         math_error();
@@ -65,11 +76,11 @@ STATIC mp_obj_t math_generic_2(mp_obj_t x_obj, mp_obj_t y_obj, mp_float_t (*f)(m
     STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp_math_## py_name ## _obj, mp_math_ ## py_name);
 
 #define MATH_FUN_1_TO_BOOL(py_name, c_name) \
-    STATIC mp_obj_t mp_math_ ## py_name(mp_obj_t x_obj) { return mp_obj_new_bool(c_name(mp_obj_get_float(x_obj))); } \
+    STATIC mp_obj_t mp_math_ ## py_name(mp_obj_t x_obj) { return mp_obj_new_bool(c_name(math_get_float(x_obj))); } \
     STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp_math_## py_name ## _obj, mp_math_ ## py_name);
 
 #define MATH_FUN_1_TO_INT(py_name, c_name) \
-    STATIC mp_obj_t mp_math_ ## py_name(mp_obj_t x_obj) { return mp_obj_new_int_from_float(MICROPY_FLOAT_C_FUN(c_name)(mp_obj_get_float(x_obj))); } \
+    STATIC mp_obj_t mp_math_ ## py_name(mp_obj_t x_obj) { return mp_obj_new_int_from_float(MICROPY_FLOAT_C_FUN(c_name)(math_get_float(x_obj))); } \
     STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp_math_## py_name ## _obj, mp_math_ ## py_name);
 
 #define MATH_FUN_2(py_name, c_name) \
@@ -80,7 +91,7 @@ STATIC mp_obj_t math_generic_2(mp_obj_t x_obj, mp_obj_t y_obj, mp_float_t (*f)(m
 
 #define MATH_FUN_2_FLT_INT(py_name, c_name) \
     STATIC mp_obj_t mp_math_ ## py_name(mp_obj_t x_obj, mp_obj_t y_obj) { \
-        return mp_obj_new_float(MICROPY_FLOAT_C_FUN(c_name)(mp_obj_get_float(x_obj), mp_obj_get_int(y_obj))); \
+        return mp_obj_new_float(MICROPY_FLOAT_C_FUN(c_name)(math_get_float(x_obj), mp_obj_get_int(y_obj))); \
     } \
     STATIC MP_DEFINE_CONST_FUN_OBJ_2(mp_math_## py_name ## _obj, mp_math_ ## py_name);
 
@@ -175,7 +186,7 @@ MATH_FUN_1(lgamma, lgamma)
 
 // log(x[, base])
 STATIC mp_obj_t mp_math_log(size_t n_args, const mp_obj_t *args) {
-    mp_float_t x = mp_obj_get_float(args[0]);
+    mp_float_t x = math_get_float(args[0]);
     if (x <= (mp_float_t)0.0) {
         math_error();
     }
@@ -183,7 +194,7 @@ STATIC mp_obj_t mp_math_log(size_t n_args, const mp_obj_t *args) {
     if (n_args == 1) {
         return mp_obj_new_float(l);
     } else {
-        mp_float_t base = mp_obj_get_float(args[1]);
+        mp_float_t base = math_get_float(args[1]);
         if (base <= (mp_float_t)0.0) {
             math_error();
         } else if (base == (mp_float_t)1.0) {
@@ -199,7 +210,7 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_math_log_obj, 1, 2, mp_math_log);
 // frexp(x): converts a floating-point number to fractional and integral components
 STATIC mp_obj_t mp_math_frexp(mp_obj_t x_obj) {
     int int_exponent = 0;
-    mp_float_t significand = MICROPY_FLOAT_C_FUN(frexp)(mp_obj_get_float(x_obj), &int_exponent);
+    mp_float_t significand = MICROPY_FLOAT_C_FUN(frexp)(math_get_float(x_obj), &int_exponent);
     mp_obj_t tuple[2];
     tuple[0] = mp_obj_new_float(significand);
     tuple[1] = mp_obj_new_int(int_exponent);
@@ -210,7 +221,7 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp_math_frexp_obj, mp_math_frexp);
 // modf(x)
 STATIC mp_obj_t mp_math_modf(mp_obj_t x_obj) {
     mp_float_t int_part = 0.0;
-    mp_float_t fractional_part = MICROPY_FLOAT_C_FUN(modf)(mp_obj_get_float(x_obj), &int_part);
+    mp_float_t fractional_part = MICROPY_FLOAT_C_FUN(modf)(math_get_float(x_obj), &int_part);
     mp_obj_t tuple[2];
     tuple[0] = mp_obj_new_float(fractional_part);
     tuple[1] = mp_obj_new_float(int_part);
@@ -222,13 +233,13 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp_math_modf_obj, mp_math_modf);
 
 // radians(x)
 STATIC mp_obj_t mp_math_radians(mp_obj_t x_obj) {
-    return mp_obj_new_float(mp_obj_get_float(x_obj) * (MP_PI / MICROPY_FLOAT_CONST(180.0)));
+    return mp_obj_new_float(math_get_float(x_obj) * (MP_PI / MICROPY_FLOAT_CONST(180.0)));
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp_math_radians_obj, mp_math_radians);
 
 // degrees(x)
 STATIC mp_obj_t mp_math_degrees(mp_obj_t x_obj) {
-    return mp_obj_new_float(mp_obj_get_float(x_obj) * (MICROPY_FLOAT_CONST(180.0) / MP_PI));
+    return mp_obj_new_float(math_get_float(x_obj) * (MICROPY_FLOAT_CONST(180.0) / MP_PI));
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp_math_degrees_obj, mp_math_degrees);
 
@@ -31,6 +31,7 @@
 #include "py/runtime.h"
 #include "py/builtin.h"
 #include "py/objtuple.h"
+#include "py/objlist.h"
 #include "py/binary.h"
 #include "py/parsenum.h"
 
@@ -248,6 +249,263 @@ STATIC mp_obj_t struct_pack_into(size_t n_args, const mp_obj_t *args) {
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_pack_into_obj, 3, MP_OBJ_FUN_ARGS_MAX, struct_pack_into);
 
+#if MICROPY_PY_STRUCT_COMPILED
+
+// ustruct.Struct parses the format string once, into a list of fields with
+// precomputed offsets, so packing and unpacking just walk that list.
+
+typedef struct _struct_field_t {
+    size_t offset;
+    size_t len; // number of bytes for an 's' field, 0 otherwise
+    char type;
+} struct_field_t;
+
+typedef struct _mp_obj_struct_t {
+    mp_obj_base_t base;
+    mp_obj_t format;
+    size_t size;
+    size_t num_items;
+    char fmt_type;
+    struct_field_t fields[];
+} mp_obj_struct_t;
+
+typedef struct _mp_obj_struct_iter_t {
+    mp_obj_base_t base;
+    mp_obj_struct_t *st;
+    mp_obj_t buf;
+    mp_obj_t out;
+    size_t pos;
+} mp_obj_struct_iter_t;
+
+STATIC const mp_obj_type_t mp_type_struct;
+STATIC const mp_obj_type_t mp_type_struct_iter;
+
+STATIC mp_obj_t struct_obj_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 1, 1, false);
+    const char *fmt = mp_obj_str_get_str(args[0]);
+    size_t total_sz;
+    size_t num_items = calc_size_items(fmt, &total_sz);
+
+    mp_obj_struct_t *o = m_new_obj_var(mp_obj_struct_t, struct_field_t, num_items);
+    o->base.type = type;
+    o->format = args[0];
+    o->size = total_sz;
+    o->num_items = num_items;
+    o->fmt_type = get_fmt_type(&fmt);
+
+    // lay out the fields the same way calc_size_items computes the size
+    struct_field_t *f = o->fields;
+    size_t size = 0;
+    for (; *fmt; fmt++) {
+        mp_uint_t cnt = 1;
+        if (unichar_isdigit(*fmt)) {
+            cnt = get_fmt_num(&fmt);
+        }
+        if (*fmt == 's') {
+            f->offset = size;
+            f->len = cnt;
+            f->type = 's';
+            f++;
+            size += cnt;
+        } else {
+            mp_uint_t align;
+            size_t sz = mp_binary_get_size(o->fmt_type, *fmt, &align);
+            while (cnt--) {
+                size = (size + align - 1) & ~(align - 1);
+                f->offset = size;
+                f->len = 0;
+                f->type = *fmt;
+                f++;
+                size += sz;
+            }
+        }
+    }
+
+    return MP_OBJ_FROM_PTR(o);
+}
+
+// Get a pointer to offset in buf, checking that there are at least size bytes there
+STATIC byte *struct_obj_get_ptr(mp_obj_t buf, mp_obj_t offset_in, size_t size, int flags) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf, &bufinfo, flags);
+    mp_int_t offset = 0;
+    if (offset_in != MP_OBJ_NULL) {
+        offset = mp_obj_get_int(offset_in);
+        if (offset < 0) {
+            // negative offsets are relative to the end of the buffer
+            offset += bufinfo.len;
+        }
+    }
+    if (offset < 0 || (size_t)offset > bufinfo.len || bufinfo.len - offset < size) {
+        mp_raise_ValueError("buffer too small");
+    }
+    return (byte*)bufinfo.buf + offset;
+}
+
+STATIC void struct_obj_unpack_items(mp_obj_struct_t *self, const byte *buf, mp_obj_t *items) {
+    const struct_field_t *f = self->fields;
+    for (size_t i = 0; i < self->num_items; i++, f++) {
+        byte *p = (byte*)buf + f->offset;
+        if (f->type == 's') {
+            items[i] = mp_obj_new_bytes(p, f->len);
+        } else {
+            items[i] = mp_binary_get_val(self->fmt_type, f->type, &p);
+        }
+    }
+}
+
+// Unpack into out if it's a list (resizing it as needed), else into a new tuple
+STATIC mp_obj_t struct_obj_unpack_out(mp_obj_struct_t *self, const byte *buf, mp_obj_t out) {
+    if (out == MP_OBJ_NULL || out == mp_const_none) {
+        mp_obj_tuple_t *res = MP_OBJ_TO_PTR(mp_obj_new_tuple(self->num_items, NULL));
+        struct_obj_unpack_items(self, buf, res->items);
+        return MP_OBJ_FROM_PTR(res);
+    }
+    if (!MP_OBJ_IS_TYPE(out, &mp_type_list)) {
+        mp_raise_TypeError(NULL);
+    }
+    mp_obj_list_t *list = MP_OBJ_TO_PTR(out);
+    while (list->len < self->num_items) {
+        mp_obj_list_append(out, mp_const_none);
+    }
+    mp_obj_list_set_len(out, self->num_items);
+    struct_obj_unpack_items(self, buf, list->items);
+    return out;
+}
+
+// Assumes there is room for self->size bytes at p
+STATIC void struct_obj_pack_items(mp_obj_struct_t *self, byte *p, size_t n_args, const mp_obj_t *args) {
+    // as with pack, it's fine to give fewer arguments than the format needs
+    // and extra arguments are ignored; CPython raises struct.error for both
+    if (n_args > self->num_items) {
+        n_args = self->num_items;
+    }
+    const struct_field_t *f = self->fields;
+    for (size_t i = 0; i < n_args; i++, f++) {
+        byte *p_field = p + f->offset;
+        if (f->type == 's') {
+            mp_buffer_info_t bufinfo;
+            mp_get_buffer_raise(args[i], &bufinfo, MP_BUFFER_READ);
+            size_t to_copy = MIN(bufinfo.len, f->len);
+            memcpy(p_field, bufinfo.buf, to_copy);
+            memset(p_field + to_copy, 0, f->len - to_copy);
+        } else {
+            mp_binary_set_val(self->fmt_type, f->type, args[i], &p_field);
+        }
+    }
+}
+
+STATIC mp_obj_t struct_obj_pack(size_t n_args, const mp_obj_t *args) {
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(args[0]);
+    vstr_t vstr;
+    vstr_init_len(&vstr, self->size);
+    memset(vstr.buf, 0, self->size);
+    struct_obj_pack_items(self, (byte*)vstr.buf, n_args - 1, &args[1]);
+    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_obj_pack_obj, 1, MP_OBJ_FUN_ARGS_MAX, struct_obj_pack);
+
+STATIC mp_obj_t struct_obj_pack_into(size_t n_args, const mp_obj_t *args) {
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(args[0]);
+    byte *p = struct_obj_get_ptr(args[1], args[2], self->size, MP_BUFFER_WRITE);
+    struct_obj_pack_items(self, p, n_args - 3, &args[3]);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_obj_pack_into_obj, 3, MP_OBJ_FUN_ARGS_MAX, struct_obj_pack_into);
+
+// unpack_from(buffer, offset=0, out=None)
+// If out is given it must be a list, which is filled in and returned instead
+// of allocating a new tuple (a MicroPython extension).
+STATIC mp_obj_t struct_obj_unpack_from(size_t n_args, const mp_obj_t *args) {
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(args[0]);
+    const byte *p = struct_obj_get_ptr(args[1], n_args > 2 ? args[2] : MP_OBJ_NULL, self->size, MP_BUFFER_READ);
+    return struct_obj_unpack_out(self, p, n_args > 3 ? args[3] : MP_OBJ_NULL);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_obj_unpack_from_obj, 2, 4, struct_obj_unpack_from);
+
+// iter_unpack(buffer, out=None)
+// Returns an iterator over consecutive records in buffer, whose length must be
+// a multiple of the record size.  If out is given each record is unpacked into
+// that list, which is what the iterator yields each time.
+STATIC mp_obj_t struct_obj_iter_unpack(size_t n_args, const mp_obj_t *args) {
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_READ);
+    if (self->size == 0 || bufinfo.len % self->size != 0) {
+        mp_raise_ValueError("buffer size must be a multiple of struct size");
+    }
+    mp_obj_t out = n_args > 2 ? args[2] : mp_const_none;
+    if (out != mp_const_none && !MP_OBJ_IS_TYPE(out, &mp_type_list)) {
+        mp_raise_TypeError(NULL);
+    }
+    mp_obj_struct_iter_t *o = m_new_obj(mp_obj_struct_iter_t);
+    o->base.type = &mp_type_struct_iter;
+    o->st = self;
+    o->buf = args[1];
+    o->out = out;
+    o->pos = 0;
+    return MP_OBJ_FROM_PTR(o);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_obj_iter_unpack_obj, 2, 3, struct_obj_iter_unpack);
+
+STATIC mp_obj_t struct_iter_iternext(mp_obj_t self_in) {
+    mp_obj_struct_iter_t *self = MP_OBJ_TO_PTR(self_in);
+    // get the buffer each time in case it was resized
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(self->buf, &bufinfo, MP_BUFFER_READ);
+    if (bufinfo.len < self->st->size || self->pos > bufinfo.len - self->st->size) {
+        return MP_OBJ_STOP_ITERATION;
+    }
+    const byte *p = (const byte*)bufinfo.buf + self->pos;
+    self->pos += self->st->size;
+    return struct_obj_unpack_out(self->st, p, self->out);
+}
+
+STATIC const mp_obj_type_t mp_type_struct_iter = {
+    { &mp_type_type },
+    .name = MP_QSTR_iterator,
+    .getiter = mp_identity_getiter,
+    .iternext = struct_iter_iternext,
+};
+
+STATIC const mp_rom_map_elem_t struct_obj_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_pack), MP_ROM_PTR(&struct_obj_pack_obj) },
+    { MP_ROM_QSTR(MP_QSTR_pack_into), MP_ROM_PTR(&struct_obj_pack_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_unpack), MP_ROM_PTR(&struct_obj_unpack_from_obj) },
+    { MP_ROM_QSTR(MP_QSTR_unpack_from), MP_ROM_PTR(&struct_obj_unpack_from_obj) },
+    { MP_ROM_QSTR(MP_QSTR_iter_unpack), MP_ROM_PTR(&struct_obj_iter_unpack_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(struct_obj_locals_dict, struct_obj_locals_dict_table);
+
+STATIC void struct_obj_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
+    if (dest[0] != MP_OBJ_NULL) {
+        // not load attribute
+        return;
+    }
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(self_in);
+    if (attr == MP_QSTR_size) {
+        dest[0] = MP_OBJ_NEW_SMALL_INT(self->size);
+    } else if (attr == MP_QSTR_format) {
+        dest[0] = self->format;
+    } else {
+        mp_map_elem_t *elem = mp_map_lookup((mp_map_t*)&struct_obj_locals_dict.map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
+        if (elem != NULL) {
+            mp_convert_member_lookup(self_in, &mp_type_struct, elem->value, dest);
+        }
+    }
+}
+
+STATIC const mp_obj_type_t mp_type_struct = {
+    { &mp_type_type },
+    .name = MP_QSTR_Struct,
+    .make_new = struct_obj_make_new,
+    .attr = struct_obj_attr,
+    .locals_dict = (mp_obj_dict_t*)&struct_obj_locals_dict,
+};
+
+#endif // MICROPY_PY_STRUCT_COMPILED
+
 STATIC const mp_rom_map_elem_t mp_module_struct_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_ustruct) },
     { MP_ROM_QSTR(MP_QSTR_calcsize), MP_ROM_PTR(&struct_calcsize_obj) },
@@ -255,6 +513,9 @@ STATIC const mp_rom_map_elem_t mp_module_struct_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_pack_into), MP_ROM_PTR(&struct_pack_into_obj) },
     { MP_ROM_QSTR(MP_QSTR_unpack), MP_ROM_PTR(&struct_unpack_from_obj) },
     { MP_ROM_QSTR(MP_QSTR_unpack_from), MP_ROM_PTR(&struct_unpack_from_obj) },
+    #if MICROPY_PY_STRUCT_COMPILED
+    { MP_ROM_QSTR(MP_QSTR_Struct), MP_ROM_PTR(&mp_type_struct) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_struct_globals, mp_module_struct_globals_table);
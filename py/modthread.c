@@ -162,6 +162,20 @@ STATIC void *thread_entry(void *args_in) {
     mp_state_thread_t ts;
     mp_thread_set_state(&ts);
 
+    #if MICROPY_ENABLE_PYSTACK
+    // the pystack is allocated below, once the thread is set up and running
+    mp_pystack_init(NULL, NULL);
+    #endif
+
+    #if MICROPY_GC_THREAD_ALLOC
+    ts.gc_alloc_buf = NULL;
+    ts.gc_alloc_buf_n_blocks = 0;
+    #endif
+
+    #if MICROPY_OPT_CACHE_GLOBAL_LOOKUP
+    memset(ts.global_cache, 0, sizeof(ts.global_cache));
+    #endif
+
     mp_stack_set_top(&ts + 1); // need to include ts in root-pointer scan
     mp_stack_set_limit(args->stack_size);
 
@@ -182,9 +196,18 @@ STATIC void *thread_entry(void *args_in) {
 
     nlr_buf_t nlr;
     if (nlr_push(&nlr) == 0) {
+        #if MICROPY_ENABLE_PYSTACK
+        // the pystack is on the heap and referenced from ts, so it's traced
+        byte *pystack = m_new(byte, MICROPY_PYSTACK_THREAD_SIZE);
+        mp_pystack_init(pystack, pystack + MICROPY_PYSTACK_THREAD_SIZE);
+        #endif
         mp_call_function_n_kw(args->fun, args->n_args, args->n_kw, args->args);
         nlr_pop();
     } else {
+        #if MICROPY_ENABLE_PYSTACK
+        // nlr_push saved the pystack state from before it was allocated
+        ts.pystack_cur = ts.pystack_start;
+        #endif
         // uncaught exception
         // check for SystemExit
         mp_obj_base_t *exc = (mp_obj_base_t*)nlr.ret_val;
@@ -201,6 +224,12 @@ STATIC void *thread_entry(void *args_in) {
 
     DEBUG_printf("[thread] finish ts=%p\n", &ts);
 
+    #if MICROPY_ENABLE_PYSTACK
+    if (ts.pystack_start != NULL) {
+        m_del(byte, ts.pystack_start, MICROPY_PYSTACK_THREAD_SIZE);
+    }
+    #endif
+
     // signal that we are finished
     mp_thread_finish();
 
@@ -122,6 +122,33 @@
 #define MICROPY_GC_ALLOC_THRESHOLD (1)
 #endif
 
+// Number of GC blocks in each thread's allocation buffer (0 to disable).
+// With threads and no GIL, a thread takes small allocations from its own
+// run of reserved heap blocks without taking the GC mutex (see
+// MICROPY_GC_THREAD_ALLOC below).  Must be a multiple of 4 (the number of
+// blocks per allocation table byte).
+#ifndef MICROPY_GC_THREAD_ALLOC_BLOCKS
+#define MICROPY_GC_THREAD_ALLOC_BLOCKS (0)
+#endif
+
+// Maximum number of threads, including the collecting one, that mark the
+// roots of stopped threads in parallel (0 to disable).  With threads and no
+// GIL, a port that stops the other threads during a collection may have them
+// help to mark, each with its own mark stack (see MICROPY_GC_PARALLEL_MARK
+// below and gc_mark_parallel in py/gc.h).
+#ifndef MICROPY_GC_PARALLEL_MARK_WORKERS
+#define MICROPY_GC_PARALLEL_MARK_WORKERS (0)
+#endif
+
+// Maximum number of recycled cells to cache for each of the 1- and 2-block
+// allocation sizes (0 to disable).  Small objects like floats, bound methods,
+// closures, small tuples, iterators and exceptions die young; rather than
+// freeing them, the sweep keeps their cells on free lists from which gc_alloc
+// takes new objects of the same size without searching the allocation table.
+#ifndef MICROPY_GC_SLAB_CELLS
+#define MICROPY_GC_SLAB_CELLS (0)
+#endif
+
 // Number of bytes to allocate initially when creating new chunks to store
 // interned string data.  Smaller numbers lead to more chunks being needed
 // and more wastage at the end of the chunk.  Larger numbers lead to wasted
@@ -223,6 +250,26 @@
 #define MICROPY_STACKLESS_STRICT (0)
 #endif
 
+// Whether to use a dedicated, fixed-size Python stack (the "pystack") for
+// the state of bytecode function calls and their temporary argument arrays,
+// instead of the C stack and the heap.  Calls then never allocate on the
+// heap, and the pystack size bounds the recursion depth of Python code.
+// Each thread must set up its pystack with mp_pystack_init().
+#ifndef MICROPY_ENABLE_PYSTACK
+#define MICROPY_ENABLE_PYSTACK (0)
+#endif
+
+// Alignment (in bytes) of blocks allocated on the pystack
+#ifndef MICROPY_PYSTACK_ALIGN
+#define MICROPY_PYSTACK_ALIGN (8)
+#endif
+
+// Size (in bytes) of the pystack given to each new thread; it is allocated
+// on the heap when the thread starts running
+#ifndef MICROPY_PYSTACK_THREAD_SIZE
+#define MICROPY_PYSTACK_THREAD_SIZE (1024)
+#endif
+
 // Don't use alloca calls. As alloca() is not part of ANSI C, this
 // workaround option is provided for compilers lacking this de-facto
 // standard function. The way it works is allocating from heap, and
@@ -267,6 +314,12 @@
 #define MICROPY_EMIT_THUMB (0)
 #endif
 
+// Whether the thumb native emitter uses VFP instructions for viper floats
+// (requires an FPU and single-precision floats)
+#ifndef MICROPY_EMIT_THUMB_FLOAT
+#define MICROPY_EMIT_THUMB_FLOAT (0)
+#endif
+
 // Whether to enable the thumb inline assembler
 #ifndef MICROPY_EMIT_INLINE_THUMB
 #define MICROPY_EMIT_INLINE_THUMB (0)
@@ -358,6 +411,15 @@
 #define MICROPY_COMP_RETURN_IF_EXPR (0)
 #endif
 
+// Whether to include the bytecode optimisations enabled at runtime by
+// micropython.opt_level(1) and above (or mpy-cross -O1): jump threading,
+// removal of unreachable code, fused instructions for common pairs, and
+// folding of integer comparisons, powers and constant subscripts.  The VM
+// can run the resulting bytecode whether or not this is enabled.
+#ifndef MICROPY_COMP_OPTIMISE
+#define MICROPY_COMP_OPTIMISE (0)
+#endif
+
 /*****************************************************************************/
 /* Internal debugging stuff                                                  */
 
@@ -396,12 +458,70 @@
 #define MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE (0)
 #endif
 
+// Whether to tag each map with a version that changes whenever a key is added
+// to or removed from the map, and use these tags to cache the slot found by
+// global and builtin lookups in a small table.  Costs 1 word of RAM per map,
+// plus the table.
+#ifndef MICROPY_OPT_CACHE_GLOBAL_LOOKUP
+#define MICROPY_OPT_CACHE_GLOBAL_LOOKUP (0)
+#endif
+
+// Number of entries in each thread's global lookup cache; must be a power of 2
+#ifndef MICROPY_OPT_CACHE_GLOBAL_LOOKUP_SIZE
+#define MICROPY_OPT_CACHE_GLOBAL_LOOKUP_SIZE (32)
+#endif
+
+// Whether the VM handles binary ops on two small ints inline (comparisons,
+// add, subtract, and the other ops of MP_BC_LOAD_FAST_INT_OP) instead of
+// calling mp_binary_op.  Adds about 2.5KiB of code on x86-64.
+#ifndef MICROPY_OPT_VM_SMALL_INT
+#define MICROPY_OPT_VM_SMALL_INT (0)
+#endif
+
+// Whether mp_binary_op and the math module have fast paths for floats:
+// arithmetic and ordering on a float and a float or small int skip the
+// dispatch through the float type, and math functions decode a float
+// argument directly.  It gains the most with object representation C, which
+// stores floats in the object itself, so is enabled for that by default.
+#ifndef MICROPY_OPT_FAST_FLOAT
+#define MICROPY_OPT_FAST_FLOAT (MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_C)
+#endif
+
 // Whether to use fast versions of bitwise operations (and, or, xor) when the
 // arguments are both positive.  Increases Thumb2 code size by about 250 bytes.
 #ifndef MICROPY_OPT_MPZ_BITWISE
 #define MICROPY_OPT_MPZ_BITWISE (0)
 #endif
 
+// Whether to use large lookup tables for CRC calculations (uzlib, ubinascii):
+// slice-by-8 tables for CRC-32 and byte-wise tables for CRC-32C and CRC-16,
+// about 9.5KiB of ROM in total, instead of 16-entry nibble tables.  Roughly
+// 4-8x faster per byte.
+#ifndef MICROPY_OPT_CRC_LARGE_TABLES
+#define MICROPY_OPT_CRC_LARGE_TABLES (0)
+#endif
+
+// Number of bits uzlib decodes at once with a lookup table per Huffman tree.
+// Each DecompIO/decompress state holds two tables of 2 << N bytes, so the
+// default of 6 costs 256 bytes of heap; 9 (2KiB) decodes most symbols in a
+// single lookup.
+#ifndef MICROPY_OPT_UZLIB_FAST_BITS
+#define MICROPY_OPT_UZLIB_FAST_BITS (6)
+#endif
+
+// Whether to use PCLMULQDQ for CRC-32 and the SSE4.2 crc32 instruction for
+// CRC-32C when built for x86-64 with gcc/clang and the CPU supports them
+// (detected at runtime).
+#ifndef MICROPY_OPT_CRC_X86_SIMD
+#define MICROPY_OPT_CRC_X86_SIMD (0)
+#endif
+
+// Whether to use SSE2 for ubinascii hex and base64 encoding and decoding when
+// built for a target that has it (always the case on x86-64).
+#ifndef MICROPY_OPT_BINASCII_X86_SIMD
+#define MICROPY_OPT_BINASCII_X86_SIMD (0)
+#endif
+
 /*****************************************************************************/
 /* Python internal features                                                  */
 
@@ -415,6 +535,14 @@
 #define MICROPY_READER_VFS (0)
 #endif
 
+// Size of the buffer used by the POSIX and VFS readers.  Files smaller than
+// this are read in one go, larger ones in chunks of this size.  A multiple of
+// the filesystem block size lets the filesystem read directly into the buffer.
+// Must be less than 64k.
+#ifndef MICROPY_READER_BUF_SIZE
+#define MICROPY_READER_BUF_SIZE (512)
+#endif
+
 // Hook for the VM at the start of the opcode loop (can contain variable
 // definitions usable by the other hook functions)
 #ifndef MICROPY_VM_HOOK_INIT
@@ -441,6 +569,14 @@
 #define MICROPY_ENABLE_FINALISER (0)
 #endif
 
+// Whether to support compacting the heap with gc.compact(), which moves the
+// storage of lists, bytearrays, arrays and dicts into holes lower in the heap.
+// It needs MICROPY_ENABLE_FINALISER, and is not available if threads can run
+// at the same time (see MICROPY_GC_COMPACT below).
+#ifndef MICROPY_ENABLE_GC_COMPACT
+#define MICROPY_ENABLE_GC_COMPACT (0)
+#endif
+
 // Whether to check C stack usage. C stack used for calling Python functions,
 // etc. Not checking means segfault on overflow.
 #ifndef MICROPY_STACK_CHECK
@@ -951,6 +1087,12 @@ typedef double mp_float_t;
 #define MICROPY_PY_STRUCT (1)
 #endif
 
+// Whether to provide ustruct.Struct, which parses the format once and
+// provides pack, pack_into, unpack, unpack_from and iter_unpack
+#ifndef MICROPY_PY_STRUCT_COMPILED
+#define MICROPY_PY_STRUCT_COMPILED (0)
+#endif
+
 // Whether to provide "sys" module
 #ifndef MICROPY_PY_SYS
 #define MICROPY_PY_SYS (1)
@@ -1035,6 +1177,20 @@ typedef double mp_float_t;
 #define MICROPY_PY_THREAD_GIL (MICROPY_PY_THREAD)
 #endif
 
+// Hook for a thread to give up the CPU while it busy-waits on another thread
+#ifndef MICROPY_THREAD_YIELD
+#define MICROPY_THREAD_YIELD()
+#endif
+
+// Whether heap compaction is available; other threads must not run during it
+#define MICROPY_GC_COMPACT (MICROPY_ENABLE_GC_COMPACT && MICROPY_ENABLE_FINALISER && !(MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL))
+
+// Whether threads use allocation buffers; they're only needed without a GIL
+#define MICROPY_GC_THREAD_ALLOC (MICROPY_GC_THREAD_ALLOC_BLOCKS && MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL)
+
+// Whether threads mark in parallel; with a GIL only one thread runs at a time
+#define MICROPY_GC_PARALLEL_MARK (MICROPY_GC_PARALLEL_MARK_WORKERS > 1 && MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL)
+
 // Number of VM jump-loops to do before releasing the GIL.
 // Set this to 0 to disable the divisor.
 #ifndef MICROPY_PY_THREAD_GIL_VM_DIVISOR
@@ -1081,6 +1237,17 @@ typedef double mp_float_t;
 #define MICROPY_PY_UBINASCII_CRC32 (0)
 #endif
 
+// Whether to provide ubinascii.crc32c (CRC-32C) and ubinascii.crc_hqx (CRC-16/CCITT)
+#ifndef MICROPY_PY_UBINASCII_CRC_EXTRA
+#define MICROPY_PY_UBINASCII_CRC_EXTRA (0)
+#endif
+
+// Whether to provide ubinascii.hexlify_into, b2a_base64_into and the
+// Base64Encoder stream, which encode without allocating the whole output
+#ifndef MICROPY_PY_UBINASCII_INTO
+#define MICROPY_PY_UBINASCII_INTO (0)
+#endif
+
 #ifndef MICROPY_PY_URANDOM
 #define MICROPY_PY_URANDOM (0)
 #endif
@@ -1121,10 +1288,23 @@ typedef double mp_float_t;
 #define MICROPY_PY_FRAMEBUF (0)
 #endif
 
+// Whether FrameBuffer can track which tiles have been drawn to, so display
+// drivers can send only the changed regions (track_dirty, dirty, clear_dirty)
+#ifndef MICROPY_PY_FRAMEBUF_DIRTY
+#define MICROPY_PY_FRAMEBUF_DIRTY (0)
+#endif
+
 #ifndef MICROPY_PY_BTREE
 #define MICROPY_PY_BTREE (0)
 #endif
 
+// Whether to include a page cache that btree databases can put between
+// their own cache and the stream (see extmod/btree_pagecache.h); needs
+// MICROPY_STREAMS_POSIX_API
+#ifndef MICROPY_PY_BTREE_PAGECACHE
+#define MICROPY_PY_BTREE_PAGECACHE (0)
+#endif
+
 /*****************************************************************************/
 /* Hooks for a port to add builtins                                          */
 
@@ -60,12 +60,26 @@ typedef struct _mp_sched_item_t {
     mp_obj_t arg;
 } mp_sched_item_t;
 
+#if MICROPY_OPT_CACHE_GLOBAL_LOOKUP
+// The slot found by looking up a name in globals then builtins, valid while
+// the globals dict and the version tags of it and the builtins override map
+// are unchanged.  The cache is per thread so it needs no locking without a GIL.
+typedef struct _mp_global_cache_entry_t {
+    qstr qst;
+    mp_obj_dict_t *globals;
+    size_t globals_version;
+    size_t builtins_version;
+    mp_map_elem_t *elem;
+} mp_global_cache_entry_t;
+#endif
+
 // This structure hold information about the memory allocation system.
 typedef struct _mp_state_mem_t {
     #if MICROPY_MEM_STATS
     size_t total_bytes_allocated;
     size_t current_bytes_allocated;
     size_t peak_bytes_allocated;
+    size_t total_allocs;
     #endif
 
     byte *gc_alloc_table_start;
@@ -93,6 +107,18 @@ typedef struct _mp_state_mem_t {
 
     size_t gc_last_free_atb_index;
 
+    #if MICROPY_GC_SLAB_CELLS
+    // Free lists of recycled 1- and 2-block cells, linked through their first
+    // word, and the number of cells on each list
+    void *gc_slab_free[2];
+    uint16_t gc_slab_len[2];
+    #endif
+
+    #if MICROPY_GC_COMPACT
+    // Set while a collection is counting pointers for gc_compact
+    bool gc_compacting;
+    #endif
+
     #if MICROPY_PY_GC_COLLECT_RETVAL
     size_t gc_collected;
     #endif
@@ -101,6 +127,32 @@ typedef struct _mp_state_mem_t {
     // This is a global mutex used to make the GC thread-safe.
     mp_thread_mutex_t gc_mutex;
     #endif
+
+    #if MICROPY_GC_THREAD_ALLOC
+    // Number of threads allocating from their allocation buffer, and whether
+    // that's currently blocked because the GC mutex is held.
+    volatile int gc_thread_alloc_active;
+    volatile int gc_thread_alloc_blocked;
+    // Where to start looking for free memory for a new buffer
+    size_t gc_thread_alloc_atb_index;
+    #endif
+
+    #if MICROPY_GC_PARALLEL_MARK
+    // A mark stack for each thread marking in parallel.  Its owner pushes and
+    // pops blocks at the bottom, and idle threads steal them from the top.
+    struct _gc_mark_deque_t {
+        volatile ptrdiff_t top;
+        volatile ptrdiff_t bottom;
+        size_t blocks[MICROPY_ALLOC_GC_STACK_SIZE];
+    } gc_mark_deques[MICROPY_GC_PARALLEL_MARK_WORKERS];
+    // The roots being marked, handed out to the threads in chunks, and the
+    // number of threads that are still looking for work
+    struct _gc_root_range_t *gc_mark_roots;
+    size_t gc_mark_n_workers;
+    size_t gc_mark_n_chunks;
+    volatile size_t gc_mark_next_chunk;
+    volatile size_t gc_mark_active;
+    #endif
 } mp_state_mem_t;
 
 // This structure hold runtime and VM information.  It includes a section
@@ -198,6 +250,10 @@ typedef struct _mp_state_vm_t {
 
     mp_uint_t mp_optimise_value;
 
+    #if MICROPY_OPT_CACHE_GLOBAL_LOOKUP
+    size_t map_version_counter;
+    #endif
+
     // size of the emergency exception buf, if it's dynamically allocated
     #if MICROPY_ENABLE_EMERGENCY_EXCEPTION_BUF && MICROPY_EMERGENCY_EXCEPTION_BUF_SIZE == 0
     mp_int_t mp_emergency_exception_buf_size;
@@ -224,6 +280,23 @@ typedef struct _mp_state_thread_t {
     #if MICROPY_STACK_CHECK
     size_t stack_limit;
     #endif
+
+    #if MICROPY_ENABLE_PYSTACK
+    byte *pystack_start;
+    byte *pystack_end;
+    byte *pystack_cur;
+    #endif
+
+    #if MICROPY_GC_THREAD_ALLOC
+    // The unused part of this thread's allocation buffer: it's kept allocated
+    // as a single chunk of heap blocks, which this pointer keeps alive.
+    byte *gc_alloc_buf;
+    size_t gc_alloc_buf_n_blocks;
+    #endif
+
+    #if MICROPY_OPT_CACHE_GLOBAL_LOOKUP
+    mp_global_cache_entry_t global_cache[MICROPY_OPT_CACHE_GLOBAL_LOOKUP_SIZE];
+    #endif
 } mp_state_thread_t;
 
 // This structure combines the above 3 structures.
@@ -39,6 +39,27 @@
 #define DEBUG_printf(...) (void)0
 #endif
 
+#if MICROPY_PY_BUILTINS_FLOAT && (MICROPY_EMIT_NATIVE || MICROPY_EMIT_INLINE_ASM)
+
+// viper floats are held unboxed as the bits of an mp_float_t in a machine word
+typedef union _mp_native_float_t {
+    mp_float_t f;
+    mp_uint_t u;
+} mp_native_float_t;
+
+STATIC inline mp_uint_t mp_native_float_to_bits(mp_float_t f) {
+    mp_native_float_t x = {.u = 0};
+    x.f = f;
+    return x.u;
+}
+
+STATIC inline mp_float_t mp_native_float_from_bits(mp_uint_t u) {
+    mp_native_float_t x = {.u = u};
+    return x.f;
+}
+
+#endif
+
 #if MICROPY_EMIT_NATIVE
 
 // convert a MicroPython object to a valid native value based on type
@@ -49,6 +70,9 @@ mp_uint_t mp_convert_obj_to_native(mp_obj_t obj, mp_uint_t type) {
         case MP_NATIVE_TYPE_BOOL:
         case MP_NATIVE_TYPE_INT:
         case MP_NATIVE_TYPE_UINT: return mp_obj_get_int_truncated(obj);
+        #if MICROPY_PY_BUILTINS_FLOAT
+        case MP_NATIVE_TYPE_FLOAT: return mp_native_float_to_bits(mp_obj_get_float(obj));
+        #endif
         default: { // cast obj to a pointer
             mp_buffer_info_t bufinfo;
             if (mp_get_buffer(obj, &bufinfo, MP_BUFFER_RW)) {
@@ -73,6 +97,9 @@ mp_obj_t mp_convert_native_to_obj(mp_uint_t val, mp_uint_t type) {
         case MP_NATIVE_TYPE_BOOL: return mp_obj_new_bool(val);
         case MP_NATIVE_TYPE_INT: return mp_obj_new_int(val);
         case MP_NATIVE_TYPE_UINT: return mp_obj_new_int_from_uint(val);
+        #if MICROPY_PY_BUILTINS_FLOAT
+        case MP_NATIVE_TYPE_FLOAT: return mp_obj_new_float(mp_native_float_from_bits(val));
+        #endif
         default: // a pointer
             // we return just the value of the pointer as an integer
             return mp_obj_new_int_from_uint(val);
@@ -91,8 +118,9 @@ mp_obj_t mp_native_call_function_n_kw(mp_obj_t fun_in, size_t n_args_kw, const m
 
 // wrapper that makes raise obj and raises it
 // END_FINALLY opcode requires that we don't raise if o==None
+// resuming a generator requires that we don't raise if o==MP_OBJ_NULL
 void mp_native_raise(mp_obj_t o) {
-    if (o != mp_const_none) {
+    if (o != MP_OBJ_NULL && o != mp_const_none) {
         nlr_raise(mp_make_raise_obj(o));
     }
 }
@@ -123,6 +151,82 @@ STATIC mp_obj_t mp_native_iternext(mp_obj_iter_buf_t *iter) {
     return mp_iternext(obj);
 }
 
+// wrapper that implements YIELD_FROM for native generators
+// sp[0] is the iterator and sp[1] the value to send to it; if the iterator
+// yields then the yielded value is stored in sp[1] and true is returned,
+// otherwise its return value is stored in sp[0] and false is returned
+STATIC bool mp_native_yield_from(mp_obj_t *sp, mp_obj_t throw_value) {
+    mp_vm_return_kind_t ret_kind;
+    mp_obj_t ret_value;
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        if (throw_value != MP_OBJ_NULL) {
+            ret_kind = mp_resume(sp[0], MP_OBJ_NULL, throw_value, &ret_value);
+        } else {
+            ret_kind = mp_resume(sp[0], sp[1], MP_OBJ_NULL, &ret_value);
+        }
+        nlr_pop();
+    } else {
+        // a StopIteration raised by the iterator gives the result of the
+        // yield from, anything else is re-raised below
+        ret_kind = MP_VM_RETURN_EXCEPTION;
+        ret_value = MP_OBJ_FROM_PTR(nlr.ret_val);
+    }
+
+    if (ret_kind == MP_VM_RETURN_YIELD) {
+        sp[1] = ret_value;
+        return true;
+    } else if (ret_kind == MP_VM_RETURN_NORMAL) {
+        if (ret_value == MP_OBJ_NULL || ret_value == MP_OBJ_STOP_ITERATION) {
+            ret_value = mp_const_none;
+        }
+    } else {
+        assert(ret_kind == MP_VM_RETURN_EXCEPTION);
+        if (!mp_obj_exception_match(ret_value, MP_OBJ_FROM_PTR(&mp_type_StopIteration))) {
+            nlr_raise(ret_value);
+        }
+        ret_value = mp_obj_exception_get_value(ret_value);
+    }
+    sp[0] = ret_value;
+
+    // If we injected GeneratorExit downstream, then even
+    // if it was swallowed, we re-raise GeneratorExit
+    if (throw_value != MP_OBJ_NULL && mp_obj_exception_match(throw_value, MP_OBJ_FROM_PTR(&mp_type_GeneratorExit))) {
+        nlr_raise(mp_make_raise_obj(throw_value));
+    }
+    return false;
+}
+
+#if MICROPY_PY_BUILTINS_FLOAT
+
+// viper float arithmetic for archs that don't do it inline; none of these allocate
+STATIC mp_uint_t mp_native_float_binary_op(mp_uint_t op, mp_uint_t lhs_in, mp_uint_t rhs_in) {
+    mp_float_t lhs = mp_native_float_from_bits(lhs_in);
+    mp_float_t rhs = mp_native_float_from_bits(rhs_in);
+    switch (op) {
+        case MP_BINARY_OP_ADD: return mp_native_float_to_bits(lhs + rhs);
+        case MP_BINARY_OP_SUBTRACT: return mp_native_float_to_bits(lhs - rhs);
+        case MP_BINARY_OP_MULTIPLY: return mp_native_float_to_bits(lhs * rhs);
+        case MP_BINARY_OP_TRUE_DIVIDE: return mp_native_float_to_bits(lhs / rhs);
+        case MP_BINARY_OP_LESS: return lhs < rhs;
+        case MP_BINARY_OP_MORE: return lhs > rhs;
+        case MP_BINARY_OP_EQUAL: return lhs == rhs;
+        case MP_BINARY_OP_LESS_EQUAL: return lhs <= rhs;
+        case MP_BINARY_OP_MORE_EQUAL: return lhs >= rhs;
+        default: assert(op == MP_BINARY_OP_NOT_EQUAL); return lhs != rhs;
+    }
+}
+
+STATIC mp_uint_t mp_native_float_from_int(mp_int_t val) {
+    return mp_native_float_to_bits((mp_float_t)val);
+}
+
+STATIC mp_int_t mp_native_float_to_int(mp_uint_t val) {
+    return (mp_int_t)mp_native_float_from_bits(val);
+}
+
+#endif
+
 // these must correspond to the respective enum in runtime0.h
 void *const mp_fun_table[MP_F_NUMBER_OF] = {
     mp_convert_obj_to_native,
@@ -173,6 +277,13 @@ void *const mp_fun_table[MP_F_NUMBER_OF] = {
     mp_setup_code_state,
     mp_small_int_floor_divide,
     mp_small_int_modulo,
+    mp_native_yield_from,
+    memcpy,
+#if MICROPY_PY_BUILTINS_FLOAT
+    mp_native_float_binary_op,
+    mp_native_float_from_int,
+    mp_native_float_to_int,
+#endif
 };
 
 /*
@@ -91,6 +91,7 @@ unsigned int nlr_push(nlr_buf_t *nlr) {
 __attribute__((used)) unsigned int nlr_push_tail(nlr_buf_t *nlr) {
     nlr_buf_t **top = &MP_STATE_THREAD(nlr_top);
     nlr->prev = *top;
+    MP_NLR_SAVE_PYSTACK(nlr);
     *top = nlr;
     return 0; // normal return
 }
@@ -108,6 +109,7 @@ NORETURN void nlr_jump(void *val) {
     }
 
     top->ret_val = val;
+    MP_NLR_RESTORE_PYSTACK(top);
     *top_ptr = top->prev;
 
     __asm volatile (
@@ -130,7 +132,7 @@ NORETURN void nlr_jump(void *val) {
     "ret                        \n" // return
     :                               // output operands
     : "r"(top)                      // input operands
-    :                               // clobbered registers
+    : "memory"                      // clobbered registers
     );
 
     for (;;); // needed to silence compiler warning
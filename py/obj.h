@@ -360,6 +360,9 @@ typedef struct _mp_map_t {
     size_t used : (8 * sizeof(size_t) - 3);
     size_t alloc;
     mp_map_elem_t *table;
+    #if MICROPY_OPT_CACHE_GLOBAL_LOOKUP
+    size_t version; // changes when a key is added or removed, unique across all maps
+    #endif
 } mp_map_t;
 
 // mp_set_lookup requires these constants to have the values they do
@@ -381,6 +384,11 @@ void mp_map_deinit(mp_map_t *map);
 void mp_map_free(mp_map_t *map);
 mp_map_elem_t *mp_map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t lookup_kind);
 void mp_map_clear(mp_map_t *map);
+#if MICROPY_OPT_CACHE_GLOBAL_LOOKUP
+void mp_map_new_version(mp_map_t *map);
+#else
+#define mp_map_new_version(map) (void)(map)
+#endif
 void mp_map_dump(mp_map_t *map);
 
 // Underlying set implementation (not set object)
@@ -569,6 +577,7 @@ extern const mp_obj_type_t mp_type_fun_builtin_2;
 extern const mp_obj_type_t mp_type_fun_builtin_3;
 extern const mp_obj_type_t mp_type_fun_builtin_var;
 extern const mp_obj_type_t mp_type_fun_bc;
+extern const mp_obj_type_t mp_type_fun_native;
 extern const mp_obj_type_t mp_type_module;
 extern const mp_obj_type_t mp_type_staticmethod;
 extern const mp_obj_type_t mp_type_classmethod;
@@ -335,6 +335,7 @@ STATIC mp_obj_t dict_popitem(mp_obj_t self_in) {
     mp_obj_t items[] = {next->key, next->value};
     next->key = MP_OBJ_SENTINEL; // must mark key as sentinel to indicate that it was deleted
     next->value = MP_OBJ_NULL;
+    mp_map_new_version(&self->map);
     mp_obj_t tuple = mp_obj_new_tuple(2, items);
 
     return tuple;
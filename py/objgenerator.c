@@ -47,14 +47,31 @@ typedef struct _mp_obj_gen_instance_t {
     mp_code_state_t code_state;
 } mp_obj_gen_instance_t;
 
+#if MICROPY_EMIT_NATIVE
+// native generators take the generator's code_state and the value to throw
+// into it, and return MP_VM_RETURN_NORMAL or MP_VM_RETURN_YIELD
+typedef mp_vm_return_kind_t (*mp_native_gen_fun_t)(mp_code_state_t *code_state, mp_obj_t throw_value);
+
+// the code of a native generator is preceded by the offset of its prelude
+#define GEN_IS_NATIVE(fun) ((fun)->base.type == &mp_type_fun_native)
+#define GEN_PRELUDE(fun) (GEN_IS_NATIVE(fun) ? (fun)->bytecode + *(const uintptr_t*)(fun)->bytecode : (fun)->bytecode)
+#else
+#define GEN_PRELUDE(fun) ((fun)->bytecode)
+#endif
+
 STATIC mp_obj_t gen_wrap_call(mp_obj_t self_in, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     mp_obj_gen_wrap_t *self = MP_OBJ_TO_PTR(self_in);
     mp_obj_fun_bc_t *self_fun = (mp_obj_fun_bc_t*)self->fun;
+    #if MICROPY_EMIT_NATIVE
+    assert(self_fun->base.type == &mp_type_fun_bc || GEN_IS_NATIVE(self_fun));
+    #else
     assert(self_fun->base.type == &mp_type_fun_bc);
+    #endif
 
     // bytecode prelude: get state size and exception stack size
-    size_t n_state = mp_decode_uint_value(self_fun->bytecode);
-    size_t n_exc_stack = mp_decode_uint_value(mp_decode_uint_skip(self_fun->bytecode));
+    const byte *prelude = GEN_PRELUDE(self_fun);
+    size_t n_state = mp_decode_uint_value(prelude);
+    size_t n_exc_stack = mp_decode_uint_value(mp_decode_uint_skip(prelude));
 
     // allocate the generator object, with room for local stack and exception stack
     mp_obj_gen_instance_t *o = m_new_obj_var(mp_obj_gen_instance_t, byte,
@@ -63,8 +80,14 @@ STATIC mp_obj_t gen_wrap_call(mp_obj_t self_in, size_t n_args, size_t n_kw, cons
 
     o->globals = self_fun->globals;
     o->code_state.fun_bc = self_fun;
-    o->code_state.ip = 0;
+    o->code_state.ip = (const byte*)(prelude - self_fun->bytecode);
     mp_setup_code_state(&o->code_state, n_args, n_kw, args);
+    #if MICROPY_EMIT_NATIVE
+    if (GEN_IS_NATIVE(self_fun)) {
+        // native code keeps its own resume point in ip, see emitnative.c
+        o->code_state.ip = (const byte*)1;
+    }
+    #endif
     return MP_OBJ_FROM_PTR(o);
 }
 
@@ -91,6 +114,26 @@ STATIC void gen_instance_print(const mp_print_t *print, mp_obj_t self_in, mp_pri
     mp_printf(print, "<generator object '%q' at %p>", mp_obj_fun_get_name(MP_OBJ_FROM_PTR(self->code_state.fun_bc)), self);
 }
 
+#if MICROPY_EMIT_NATIVE
+// Native code doesn't catch exceptions that escape it, so do it here and store
+// them where the VM would.  This is kept out of mp_obj_gen_resume so that the
+// nlr_buf_t doesn't add to its stack frame, which nested generators (eg with
+// yield from) use once per level whether they're native or not.
+STATIC MP_NOINLINE mp_vm_return_kind_t gen_resume_native(mp_code_state_t *code_state, mp_obj_t throw_value) {
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_native_gen_fun_t fun = MICROPY_MAKE_POINTER_CALLABLE((void*)(code_state->fun_bc->bytecode + sizeof(uintptr_t)));
+        mp_vm_return_kind_t ret_kind = fun(code_state, throw_value);
+        nlr_pop();
+        return ret_kind;
+    } else {
+        size_t n_state = mp_decode_uint_value(GEN_PRELUDE(code_state->fun_bc));
+        code_state->state[n_state - 1] = MP_OBJ_FROM_PTR(nlr.ret_val);
+        return MP_VM_RETURN_EXCEPTION;
+    }
+}
+#endif
+
 mp_vm_return_kind_t mp_obj_gen_resume(mp_obj_t self_in, mp_obj_t send_value, mp_obj_t throw_value, mp_obj_t *ret_val) {
     mp_check_self(MP_OBJ_IS_TYPE(self_in, &mp_type_gen_instance));
     mp_obj_gen_instance_t *self = MP_OBJ_TO_PTR(self_in);
@@ -108,7 +151,15 @@ mp_vm_return_kind_t mp_obj_gen_resume(mp_obj_t self_in, mp_obj_t send_value, mp_
     }
     mp_obj_dict_t *old_globals = mp_globals_get();
     mp_globals_set(self->globals);
-    mp_vm_return_kind_t ret_kind = mp_execute_bytecode(&self->code_state, throw_value);
+    mp_vm_return_kind_t ret_kind;
+    #if MICROPY_EMIT_NATIVE
+    if (GEN_IS_NATIVE(self->code_state.fun_bc)) {
+        ret_kind = gen_resume_native(&self->code_state, throw_value);
+    } else
+    #endif
+    {
+        ret_kind = mp_execute_bytecode(&self->code_state, throw_value);
+    }
     mp_globals_set(old_globals);
 
     switch (ret_kind) {
@@ -131,7 +182,7 @@ mp_vm_return_kind_t mp_obj_gen_resume(mp_obj_t self_in, mp_obj_t send_value, mp_
             break;
 
         case MP_VM_RETURN_EXCEPTION: {
-            size_t n_state = mp_decode_uint_value(self->code_state.fun_bc->bytecode);
+            size_t n_state = mp_decode_uint_value(GEN_PRELUDE(self->code_state.fun_bc));
             self->code_state.ip = 0;
             *ret_val = self->code_state.state[n_state - 1];
             break;
@@ -283,11 +283,11 @@ mp_obj_t mp_obj_instance_make_new(const mp_obj_type_t *self, size_t n_args, size
             mp_obj_t args2[1] = {MP_OBJ_FROM_PTR(self)};
             new_ret = mp_call_function_n_kw(init_fn[0], 1, 0, args2);
         } else {
-            mp_obj_t *args2 = m_new(mp_obj_t, 1 + n_args + 2 * n_kw);
+            mp_obj_t *args2 = mp_nonlocal_alloc((1 + n_args + 2 * n_kw) * sizeof(mp_obj_t));
             args2[0] = MP_OBJ_FROM_PTR(self);
             memcpy(args2 + 1, args, (n_args + 2 * n_kw) * sizeof(mp_obj_t));
             new_ret = mp_call_function_n_kw(init_fn[0], n_args + 1, n_kw, args2);
-            m_del(mp_obj_t, args2, 1 + n_args + 2 * n_kw);
+            mp_nonlocal_free(args2, (1 + n_args + 2 * n_kw) * sizeof(mp_obj_t));
         }
 
     }
@@ -311,12 +311,12 @@ mp_obj_t mp_obj_instance_make_new(const mp_obj_type_t *self, size_t n_args, size
         if (n_args == 0 && n_kw == 0) {
             init_ret = mp_call_method_n_kw(0, 0, init_fn);
         } else {
-            mp_obj_t *args2 = m_new(mp_obj_t, 2 + n_args + 2 * n_kw);
+            mp_obj_t *args2 = mp_nonlocal_alloc((2 + n_args + 2 * n_kw) * sizeof(mp_obj_t));
             args2[0] = init_fn[0];
             args2[1] = init_fn[1];
             memcpy(args2 + 2, args, (n_args + 2 * n_kw) * sizeof(mp_obj_t));
             init_ret = mp_call_method_n_kw(n_args, n_kw, args2);
-            m_del(mp_obj_t, args2, 2 + n_args + 2 * n_kw);
+            mp_nonlocal_free(args2, (2 + n_args + 2 * n_kw) * sizeof(mp_obj_t));
         }
         if (init_ret != mp_const_none) {
             if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
@@ -36,6 +36,7 @@
 #include "py/parsenum.h"
 #include "py/runtime.h"
 #include "py/objint.h"
+#include "py/smallint.h"
 #include "py/objstr.h"
 #include "py/builtin.h"
 
@@ -595,6 +596,61 @@ STATIC bool fold_constants(parser_t *parser, const rule_t *rule, size_t num_args
         }
         arg0 = mp_unary_op(op, arg0);
 
+    #if MICROPY_COMP_OPTIMISE
+    } else if (rule->rule_id == RULE_power && MP_STATE_VM(mp_optimise_value) >= 1) {
+        // folding for **, only when the result stays a small int
+        mp_obj_t arg1;
+        if (!mp_parse_node_get_int_maybe(peek_result(parser, 1), &arg0)
+            || !mp_parse_node_get_int_maybe(peek_result(parser, 0), &arg1)
+            || !MP_OBJ_IS_SMALL_INT(arg0) || !MP_OBJ_IS_SMALL_INT(arg1)) {
+            return false;
+        }
+        mp_int_t base = MP_OBJ_SMALL_INT_VALUE(arg0);
+        mp_int_t exp = MP_OBJ_SMALL_INT_VALUE(arg1);
+        if (exp < 0) {
+            // result is a float
+            return false;
+        }
+        mp_int_t result = 1;
+        if (base >= -1 && base <= 1) {
+            // 0, 1 or -1 raised to a (possibly large) power
+            result = (exp == 0 || (base == -1 && (exp & 1) == 0)) ? 1 : base;
+        } else {
+            while (exp-- > 0) {
+                if (mp_small_int_mul_overflow(result, base)) {
+                    return false;
+                }
+                result *= base;
+                if (!MP_SMALL_INT_FITS(result)) {
+                    return false;
+                }
+            }
+        }
+        arg0 = MP_OBJ_NEW_SMALL_INT(result);
+
+    } else if (rule->rule_id == RULE_comparison && num_args == 3 && MP_STATE_VM(mp_optimise_value) >= 1) {
+        // folding for a single comparison of two ints: < > == <= >= !=
+        mp_parse_node_t pn_op = peek_result(parser, 1);
+        mp_obj_t arg1;
+        if (!MP_PARSE_NODE_IS_TOKEN(pn_op)
+            || !mp_parse_node_get_int_maybe(peek_result(parser, 2), &arg0)
+            || !mp_parse_node_get_int_maybe(peek_result(parser, 0), &arg1)) {
+            return false;
+        }
+        mp_binary_op_t op;
+        switch (MP_PARSE_NODE_LEAF_ARG(pn_op)) {
+            case MP_TOKEN_OP_LESS: op = MP_BINARY_OP_LESS; break;
+            case MP_TOKEN_OP_MORE: op = MP_BINARY_OP_MORE; break;
+            case MP_TOKEN_OP_DBL_EQUAL: op = MP_BINARY_OP_EQUAL; break;
+            case MP_TOKEN_OP_LESS_EQUAL: op = MP_BINARY_OP_LESS_EQUAL; break;
+            case MP_TOKEN_OP_MORE_EQUAL: op = MP_BINARY_OP_MORE_EQUAL; break;
+            case MP_TOKEN_OP_NOT_EQUAL: op = MP_BINARY_OP_NOT_EQUAL; break;
+            default: return false; // "in"
+        }
+        arg0 = mp_binary_op(op, arg0, arg1);
+
+    #endif
+
     #if MICROPY_COMP_CONST
     } else if (rule->rule_id == RULE_expr_stmt) {
         mp_parse_node_t pn1 = peek_result(parser, 0);
@@ -687,6 +743,12 @@ STATIC bool fold_constants(parser_t *parser, const rule_t *rule, size_t num_args
     }
     if (MP_OBJ_IS_SMALL_INT(arg0)) {
         push_result_node(parser, mp_parse_node_new_small_int(MP_OBJ_SMALL_INT_VALUE(arg0)));
+    #if MICROPY_COMP_OPTIMISE
+    } else if (arg0 == mp_const_false || arg0 == mp_const_true) {
+        // result of a folded comparison
+        push_result_node(parser, mp_parse_node_new_leaf(MP_PARSE_NODE_TOKEN,
+            arg0 == mp_const_true ? MP_TOKEN_KW_TRUE : MP_TOKEN_KW_FALSE));
+    #endif
     } else {
         // TODO reuse memory for parse node struct?
         push_result_node(parser, make_node_const_object(parser, 0, arg0));
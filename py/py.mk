@@ -145,6 +145,7 @@ PY_O_BASENAME = \
 	scheduler.o \
 	nativeglue.o \
 	stackctrl.o \
+	pystack.o \
 	argcheck.o \
 	warning.o \
 	map.o \
@@ -239,6 +240,7 @@ PY_O_BASENAME = \
 	../extmod/vfs_fat_diskio.o \
 	../extmod/vfs_fat_file.o \
 	../extmod/vfs_fat_misc.o \
+	../extmod/btree_pagecache.o \
 	../extmod/utime_mphal.o \
 	../extmod/uos_dupterm.o \
 	../lib/embed/abort_.o \
@@ -75,9 +75,10 @@ void mp_reader_new_mem(mp_reader_t *reader, const byte *buf, size_t len, size_t
 typedef struct _mp_reader_posix_t {
     bool close_fd;
     int fd;
+    size_t bufsize;
     size_t len;
     size_t pos;
-    byte buf[20];
+    byte buf[];
 } mp_reader_posix_t;
 
 STATIC mp_uint_t mp_reader_posix_readbyte(void *data) {
@@ -86,7 +87,7 @@ STATIC mp_uint_t mp_reader_posix_readbyte(void *data) {
         if (reader->len == 0) {
             return MP_READER_EOF;
         } else {
-            int n = read(reader->fd, reader->buf, sizeof(reader->buf));
+            int n = read(reader->fd, reader->buf, reader->bufsize);
             if (n <= 0) {
                 reader->len = 0;
                 return MP_READER_EOF;
@@ -103,14 +104,30 @@ STATIC void mp_reader_posix_close(void *data) {
     if (reader->close_fd) {
         close(reader->fd);
     }
-    m_del_obj(mp_reader_posix_t, reader);
+    m_del_var(mp_reader_posix_t, byte, reader->bufsize, reader);
 }
 
 void mp_reader_new_file_from_fd(mp_reader_t *reader, int fd, bool close_fd) {
-    mp_reader_posix_t *rp = m_new_obj(mp_reader_posix_t);
+    // Size the buffer to hold the whole file if it's small, otherwise read it
+    // in chunks of MICROPY_READER_BUF_SIZE.  If the heap can't provide that
+    // much then fall back to a small buffer.
+    size_t bufsize = MICROPY_READER_BUF_SIZE;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && (size_t)st.st_size < bufsize) {
+        bufsize = st.st_size + 1;
+        if (bufsize < MP_READER_MIN_BUF_SIZE) {
+            bufsize = MP_READER_MIN_BUF_SIZE;
+        }
+    }
+    mp_reader_posix_t *rp = m_new_obj_var_maybe(mp_reader_posix_t, byte, bufsize);
+    if (rp == NULL) {
+        bufsize = MP_READER_MIN_BUF_SIZE;
+        rp = m_new_obj_var(mp_reader_posix_t, byte, bufsize);
+    }
     rp->close_fd = close_fd;
     rp->fd = fd;
-    int n = read(rp->fd, rp->buf, sizeof(rp->buf));
+    rp->bufsize = bufsize;
+    int n = read(rp->fd, rp->buf, rp->bufsize);
     if (n == -1) {
         if (close_fd) {
             close(fd);
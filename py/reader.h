@@ -33,6 +33,10 @@
 // it can be called again after returning MP_READER_EOF, and in that case must return MP_READER_EOF
 #define MP_READER_EOF ((mp_uint_t)(-1))
 
+// size of the buffer used by the file readers if a MICROPY_READER_BUF_SIZE
+// buffer can't be allocated
+#define MP_READER_MIN_BUF_SIZE (24)
+
 typedef struct _mp_reader_t {
     void *data;
     mp_uint_t (*readbyte)(void *data);
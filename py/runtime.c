@@ -58,6 +58,12 @@ const mp_obj_module_t mp_module___main__ = {
 void mp_init(void) {
     qstr_init();
 
+    #if MICROPY_OPT_CACHE_GLOBAL_LOOKUP
+    // start with no cached globals (the qstr of an entry is never MP_QSTR_NULL)
+    MP_STATE_VM(map_version_counter) = 0;
+    memset(MP_STATE_THREAD(global_cache), 0, sizeof(MP_STATE_THREAD(global_cache)));
+    #endif
+
     // no pending exceptions to start with
     MP_STATE_VM(mp_pending_exception) = MP_OBJ_NULL;
     #if MICROPY_ENABLE_SCHEDULER
@@ -150,21 +156,29 @@ mp_obj_t mp_load_name(qstr qst) {
     return mp_load_global(qst);
 }
 
-mp_obj_t mp_load_global(qstr qst) {
-    // logic: search globals, builtins
-    DEBUG_OP_printf("load global %s\n", qstr_str(qst));
-    mp_map_elem_t *elem = mp_map_lookup(&mp_globals_get()->map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
+#if MICROPY_OPT_CACHE_GLOBAL_LOOKUP
+// Pairs with the release store of a new version in map.c
+#if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+#define MAP_VERSION(map) __atomic_load_n(&(map)->version, __ATOMIC_ACQUIRE)
+#else
+#define MAP_VERSION(map) ((map)->version)
+#endif
+#endif
+
+// Returns the slot that qst resolves to, searching globals then builtins
+STATIC mp_map_elem_t *load_global_elem(mp_obj_dict_t *globals, qstr qst) {
+    mp_map_elem_t *elem = mp_map_lookup(&globals->map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
     if (elem == NULL) {
         #if MICROPY_CAN_OVERRIDE_BUILTINS
         if (MP_STATE_VM(mp_module_builtins_override_dict) != NULL) {
             // lookup in additional dynamic table of builtins first
             elem = mp_map_lookup(&MP_STATE_VM(mp_module_builtins_override_dict)->map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
-            if (elem != NULL) {
-                return elem->value;
-            }
         }
+        if (elem == NULL)
         #endif
-        elem = mp_map_lookup((mp_map_t*)&mp_module_builtins_globals.map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
+        {
+            elem = mp_map_lookup((mp_map_t*)&mp_module_builtins_globals.map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
+        }
         if (elem == NULL) {
             if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
                 mp_raise_msg(&mp_type_NameError, "name not defined");
@@ -174,7 +188,49 @@ mp_obj_t mp_load_global(qstr qst) {
             }
         }
     }
-    return elem->value;
+    return elem;
+}
+
+#if MICROPY_OPT_CACHE_GLOBAL_LOOKUP
+mp_map_elem_t *mp_load_global_elem(qstr qst) {
+    // the slot the name resolves to is fixed by the name and the versions of
+    // the maps searched (the builtins table itself is in ROM so never changes);
+    // the versions are read before the search so a change during it is seen
+    mp_obj_dict_t *globals = mp_globals_get();
+    size_t globals_version = MAP_VERSION(&globals->map);
+    size_t builtins_version = 0;
+    #if MICROPY_CAN_OVERRIDE_BUILTINS
+    if (MP_STATE_VM(mp_module_builtins_override_dict) != NULL) {
+        builtins_version = MAP_VERSION(&MP_STATE_VM(mp_module_builtins_override_dict)->map);
+    }
+    #endif
+    mp_global_cache_entry_t *cache = &MP_STATE_THREAD(global_cache)[qst & (MICROPY_OPT_CACHE_GLOBAL_LOOKUP_SIZE - 1)];
+    if (cache->qst == qst && cache->globals_version == globals_version
+        && cache->globals == globals && cache->builtins_version == builtins_version
+        && cache->elem->value != MP_OBJ_NULL) {
+        // a null value means the slot is being filled in, so search instead
+        return cache->elem;
+    }
+
+    mp_map_elem_t *elem = load_global_elem(globals, qst);
+    cache->qst = qst;
+    cache->globals = globals;
+    cache->globals_version = globals_version;
+    cache->builtins_version = builtins_version;
+    cache->elem = elem;
+    return elem;
+}
+#endif
+
+mp_obj_t mp_load_global(qstr qst) {
+    // logic: search globals, builtins
+    DEBUG_OP_printf("load global %s\n", qstr_str(qst));
+    #if MICROPY_OPT_CACHE_GLOBAL_LOOKUP
+    // the value is read from the slot so stores made since it was cached are seen
+    return mp_load_global_elem(qst)->value;
+    #else
+    return load_global_elem(mp_globals_get(), qst)->value;
+    #endif
 }
 
 mp_obj_t mp_load_build_class(void) {
@@ -333,6 +389,40 @@ mp_obj_t mp_binary_op(mp_binary_op_t op, mp_obj_t lhs, mp_obj_t rhs) {
         goto unsupported_op;
     }
 
+    #if MICROPY_PY_BUILTINS_FLOAT && MICROPY_OPT_FAST_FLOAT
+    // the common arithmetic and ordering operations on a float and a float or
+    // small int are done here; anything else, including division by zero,
+    // goes through the float type
+    if (mp_obj_is_float(lhs) && (mp_obj_is_float(rhs) || MP_OBJ_IS_SMALL_INT(rhs))) {
+        mp_float_t lhs_val = mp_obj_float_get(lhs);
+        mp_float_t rhs_val;
+        if (MP_OBJ_IS_SMALL_INT(rhs)) {
+            rhs_val = MP_OBJ_SMALL_INT_VALUE(rhs);
+        } else {
+            rhs_val = mp_obj_float_get(rhs);
+        }
+        switch (op) {
+            case MP_BINARY_OP_ADD:
+            case MP_BINARY_OP_INPLACE_ADD: return mp_obj_new_float(lhs_val + rhs_val);
+            case MP_BINARY_OP_SUBTRACT:
+            case MP_BINARY_OP_INPLACE_SUBTRACT: return mp_obj_new_float(lhs_val - rhs_val);
+            case MP_BINARY_OP_MULTIPLY:
+            case MP_BINARY_OP_INPLACE_MULTIPLY: return mp_obj_new_float(lhs_val * rhs_val);
+            case MP_BINARY_OP_TRUE_DIVIDE:
+            case MP_BINARY_OP_INPLACE_TRUE_DIVIDE:
+                if (rhs_val != 0) {
+                    return mp_obj_new_float(lhs_val / rhs_val);
+                }
+                break;
+            case MP_BINARY_OP_LESS: return mp_obj_new_bool(lhs_val < rhs_val);
+            case MP_BINARY_OP_MORE: return mp_obj_new_bool(lhs_val > rhs_val);
+            case MP_BINARY_OP_LESS_EQUAL: return mp_obj_new_bool(lhs_val <= rhs_val);
+            case MP_BINARY_OP_MORE_EQUAL: return mp_obj_new_bool(lhs_val >= rhs_val);
+            default: break;
+        }
+    }
+    #endif
+
     if (MP_OBJ_IS_SMALL_INT(lhs)) {
         mp_int_t lhs_val = MP_OBJ_SMALL_INT_VALUE(lhs);
         if (MP_OBJ_IS_SMALL_INT(rhs)) {
@@ -681,7 +771,7 @@ void mp_call_prepare_args_n_kw_var(bool have_self, size_t n_args_n_kw, const mp_
 
         // allocate memory for the new array of args
         args2_alloc = 1 + n_args + 2 * (n_kw + kw_dict_len);
-        args2 = m_new(mp_obj_t, args2_alloc);
+        args2 = mp_nonlocal_alloc(args2_alloc * sizeof(mp_obj_t));
 
         // copy the self
         if (self != MP_OBJ_NULL) {
@@ -702,7 +792,7 @@ void mp_call_prepare_args_n_kw_var(bool have_self, size_t n_args_n_kw, const mp_
 
         // allocate memory for the new array of args
         args2_alloc = 1 + n_args + len + 2 * (n_kw + kw_dict_len);
-        args2 = m_new(mp_obj_t, args2_alloc);
+        args2 = mp_nonlocal_alloc(args2_alloc * sizeof(mp_obj_t));
 
         // copy the self
         if (self != MP_OBJ_NULL) {
@@ -718,7 +808,7 @@ void mp_call_prepare_args_n_kw_var(bool have_self, size_t n_args_n_kw, const mp_
 
         // allocate memory for the new array of args
         args2_alloc = 1 + n_args + 2 * (n_kw + kw_dict_len) + 3;
-        args2 = m_new(mp_obj_t, args2_alloc);
+        args2 = mp_nonlocal_alloc(args2_alloc * sizeof(mp_obj_t));
 
         // copy the self
         if (self != MP_OBJ_NULL) {
@@ -735,7 +825,7 @@ void mp_call_prepare_args_n_kw_var(bool have_self, size_t n_args_n_kw, const mp_
         mp_obj_t item;
         while ((item = mp_iternext(iterable)) != MP_OBJ_STOP_ITERATION) {
             if (args2_len >= args2_alloc) {
-                args2 = m_renew(mp_obj_t, args2, args2_alloc, args2_alloc * 2);
+                args2 = mp_nonlocal_realloc(args2, args2_alloc * sizeof(mp_obj_t), args2_alloc * 2 * sizeof(mp_obj_t));
                 args2_alloc *= 2;
             }
             args2[args2_len++] = item;
@@ -786,7 +876,7 @@ void mp_call_prepare_args_n_kw_var(bool have_self, size_t n_args_n_kw, const mp_
                 if (new_alloc < 4) {
                     new_alloc = 4;
                 }
-                args2 = m_renew(mp_obj_t, args2, args2_alloc, new_alloc);
+                args2 = mp_nonlocal_realloc(args2, args2_alloc * sizeof(mp_obj_t), new_alloc * sizeof(mp_obj_t));
                 args2_alloc = new_alloc;
             }
 
@@ -818,7 +908,7 @@ mp_obj_t mp_call_method_n_kw_var(bool have_self, size_t n_args_n_kw, const mp_ob
     mp_call_prepare_args_n_kw_var(have_self, n_args_n_kw, args, &out_args);
 
     mp_obj_t res = mp_call_function_n_kw(out_args.fun, out_args.n_args, out_args.n_kw, out_args.args);
-    m_del(mp_obj_t, out_args.args, out_args.n_alloc);
+    mp_nonlocal_free(out_args.args, out_args.n_alloc * sizeof(mp_obj_t));
 
     return res;
 }
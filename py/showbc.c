@@ -211,6 +211,19 @@ const byte *mp_bytecode_print_str(const byte *ip) {
             printf("LOAD_FAST_N " UINT_FMT, unum);
             break;
 
+        case MP_BC_LOAD_FAST_PAIR:
+            unum = *ip++;
+            printf("LOAD_FAST_PAIR " UINT_FMT " " UINT_FMT, unum >> 4, unum & 0xf);
+            break;
+
+        case MP_BC_LOAD_FAST_INT_OP: {
+            unum = *ip++;
+            mp_uint_t op = mp_bc_fast_int_op[unum & 0xf];
+            printf("LOAD_FAST_INT_OP " UINT_FMT " %d " UINT_FMT " %s", unum >> 4, (int8_t)*ip++,
+                op, qstr_str(mp_binary_op_method_name[op]));
+            break;
+        }
+
         case MP_BC_LOAD_DEREF:
             DECODE_UINT;
             printf("LOAD_DEREF " UINT_FMT, unum);
@@ -345,6 +358,15 @@ const byte *mp_bytecode_print_str(const byte *ip) {
             printf("POP_JUMP_IF_FALSE " UINT_FMT, (mp_uint_t)(ip + unum - mp_showbc_code_start));
             break;
 
+        case MP_BC_BINARY_OP_POP_JUMP_IF: {
+            DECODE_SLABEL;
+            mp_uint_t op = *ip & 0x7f;
+            printf("BINARY_OP_POP_JUMP_IF_%s " UINT_FMT " " UINT_FMT " %s", (*ip >> 7) ? "TRUE" : "FALSE",
+                (mp_uint_t)(ip + unum - mp_showbc_code_start), op, qstr_str(mp_binary_op_method_name[op]));
+            ip += 1;
+            break;
+        }
+
         case MP_BC_JUMP_IF_TRUE_OR_POP:
             DECODE_SLABEL;
             printf("JUMP_IF_TRUE_OR_POP " UINT_FMT, (mp_uint_t)(ip + unum - mp_showbc_code_start));
@@ -505,6 +527,10 @@ const byte *mp_bytecode_print_str(const byte *ip) {
             printf("RETURN_VALUE");
             break;
 
+        case MP_BC_RETURN_NONE:
+            printf("RETURN_NONE");
+            break;
+
         case MP_BC_RAISE_VARARGS:
             unum = *ip++;
             printf("RAISE_VARARGS " UINT_FMT, unum);
@@ -32,6 +32,7 @@
 #include "py/emitglue.h"
 #include "py/objtype.h"
 #include "py/runtime.h"
+#include "py/smallint.h"
 #include "py/bc0.h"
 #include "py/bc.h"
 
@@ -118,6 +119,105 @@ typedef enum {
     exc_sp--; /* pop back to previous exception handler */ \
     CLEAR_SYS_EXC_INFO() /* just clear sys.exc_info(), not compliant, but it shouldn't be used in 1st place */
 
+#if MICROPY_OPT_VM_SMALL_INT
+
+STATIC inline bool vm_small_int_compare(mp_uint_t op, mp_int_t lhs_val, mp_int_t rhs_val) {
+    switch (op) {
+        case MP_BINARY_OP_LESS: return lhs_val < rhs_val;
+        case MP_BINARY_OP_MORE: return lhs_val > rhs_val;
+        case MP_BINARY_OP_EQUAL: return lhs_val == rhs_val;
+        case MP_BINARY_OP_LESS_EQUAL: return lhs_val <= rhs_val;
+        case MP_BINARY_OP_MORE_EQUAL: return lhs_val >= rhs_val;
+        default: return lhs_val != rhs_val; // MP_BINARY_OP_NOT_EQUAL
+    }
+}
+
+// Inline version of the small-int part of mp_binary_op, for the ops that are
+// common in loops.  Returns MP_OBJ_NULL if the op isn't handled here, or if it
+// would overflow or raise, in which case mp_binary_op must be used.
+STATIC inline mp_obj_t vm_small_int_binary_op(mp_uint_t op, mp_obj_t lhs, mp_obj_t rhs) {
+    mp_int_t lhs_val = MP_OBJ_SMALL_INT_VALUE(lhs);
+    mp_int_t rhs_val = MP_OBJ_SMALL_INT_VALUE(rhs);
+    switch (op) {
+        case MP_BINARY_OP_LESS:
+        case MP_BINARY_OP_MORE:
+        case MP_BINARY_OP_EQUAL:
+        case MP_BINARY_OP_LESS_EQUAL:
+        case MP_BINARY_OP_MORE_EQUAL:
+        case MP_BINARY_OP_NOT_EQUAL:
+            return mp_obj_new_bool(vm_small_int_compare(op, lhs_val, rhs_val));
+        case MP_BINARY_OP_OR:
+        case MP_BINARY_OP_INPLACE_OR:
+            return MP_OBJ_NEW_SMALL_INT(lhs_val | rhs_val);
+        case MP_BINARY_OP_XOR:
+        case MP_BINARY_OP_INPLACE_XOR:
+            return MP_OBJ_NEW_SMALL_INT(lhs_val ^ rhs_val);
+        case MP_BINARY_OP_AND:
+        case MP_BINARY_OP_INPLACE_AND:
+            return MP_OBJ_NEW_SMALL_INT(lhs_val & rhs_val);
+        case MP_BINARY_OP_RSHIFT:
+        case MP_BINARY_OP_INPLACE_RSHIFT:
+            if (rhs_val < 0) {
+                return MP_OBJ_NULL;
+            }
+            if (rhs_val >= (mp_int_t)BITS_PER_WORD) {
+                rhs_val = BITS_PER_WORD - 1;
+            }
+            return MP_OBJ_NEW_SMALL_INT(lhs_val >> rhs_val);
+        case MP_BINARY_OP_ADD:
+        case MP_BINARY_OP_INPLACE_ADD:
+            // can't overflow a machine word because small ints are narrower
+            lhs_val += rhs_val;
+            break;
+        case MP_BINARY_OP_SUBTRACT:
+        case MP_BINARY_OP_INPLACE_SUBTRACT:
+            lhs_val -= rhs_val;
+            break;
+        case MP_BINARY_OP_MULTIPLY:
+        case MP_BINARY_OP_INPLACE_MULTIPLY:
+            if (mp_small_int_mul_overflow(lhs_val, rhs_val)) {
+                return MP_OBJ_NULL;
+            }
+            lhs_val *= rhs_val;
+            break;
+        case MP_BINARY_OP_FLOOR_DIVIDE:
+        case MP_BINARY_OP_INPLACE_FLOOR_DIVIDE:
+            if (rhs_val == 0) {
+                return MP_OBJ_NULL;
+            }
+            lhs_val = mp_small_int_floor_divide(lhs_val, rhs_val);
+            break;
+        case MP_BINARY_OP_MODULO:
+        case MP_BINARY_OP_INPLACE_MODULO:
+            if (rhs_val == 0) {
+                return MP_OBJ_NULL;
+            }
+            return MP_OBJ_NEW_SMALL_INT(mp_small_int_modulo(lhs_val, rhs_val));
+        default:
+            return MP_OBJ_NULL;
+    }
+    if (!MP_SMALL_INT_FITS(lhs_val)) {
+        return MP_OBJ_NULL;
+    }
+    return MP_OBJ_NEW_SMALL_INT(lhs_val);
+}
+
+STATIC inline mp_obj_t vm_binary_op(mp_uint_t op, mp_obj_t lhs, mp_obj_t rhs) {
+    if (MP_OBJ_IS_SMALL_INT(lhs) && MP_OBJ_IS_SMALL_INT(rhs)) {
+        mp_obj_t res = vm_small_int_binary_op(op, lhs, rhs);
+        if (res != MP_OBJ_NULL) {
+            return res;
+        }
+    }
+    return mp_binary_op(op, lhs, rhs);
+}
+
+#else
+
+#define vm_binary_op(op, lhs, rhs) mp_binary_op((op), (lhs), (rhs))
+
+#endif
+
 // fastn has items in reverse order (fastn[0] is local[0], fastn[-1] is local[1], etc)
 // sp points to bottom of stack which grows up
 // returns:
@@ -274,6 +374,29 @@ dispatch_loop:
                     goto load_check;
                 }
 
+                ENTRY(MP_BC_LOAD_FAST_PAIR): {
+                    mp_uint_t pair = *ip++;
+                    mp_obj_t obj = fastn[-(mp_int_t)(pair >> 4)];
+                    if (obj == MP_OBJ_NULL) {
+                        goto local_name_error;
+                    }
+                    PUSH(obj);
+                    obj_shared = fastn[-(mp_int_t)(pair & 0xf)];
+                    goto load_check;
+                }
+
+                ENTRY(MP_BC_LOAD_FAST_INT_OP): {
+                    MARK_EXC_IP_SELECTIVE();
+                    mp_uint_t arg = *ip++;
+                    mp_obj_t lhs = fastn[-(mp_int_t)(arg >> 4)];
+                    mp_obj_t rhs = MP_OBJ_NEW_SMALL_INT((int8_t)*ip++);
+                    if (lhs == MP_OBJ_NULL) {
+                        goto local_name_error;
+                    }
+                    PUSH(vm_binary_op(mp_bc_fast_int_op[arg & 0xf], lhs, rhs));
+                    DISPATCH();
+                }
+
                 #if !MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE
                 ENTRY(MP_BC_LOAD_NAME): {
                     MARK_EXC_IP_SELECTIVE();
@@ -319,6 +442,16 @@ dispatch_loop:
                     if (x < mp_globals_get()->map.alloc && mp_globals_get()->map.table[x].key == key) {
                         PUSH(mp_globals_get()->map.table[x].value);
                     } else {
+                        #if MICROPY_OPT_CACHE_GLOBAL_LOOKUP
+                        // builtins, and globals after a rehash, hit the
+                        // version-tagged cache; a global refreshes the index
+                        mp_map_elem_t *elem = mp_load_global_elem(qst);
+                        mp_map_t *map = &mp_globals_get()->map;
+                        if (elem >= map->table && elem < map->table + map->alloc) {
+                            *(byte*)ip = (elem - &map->table[0]) & 0xff;
+                        }
+                        PUSH(elem->value);
+                        #else
                         mp_map_elem_t *elem = mp_map_lookup(&mp_globals_get()->map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
                         if (elem != NULL) {
                             *(byte*)ip = (elem - &mp_globals_get()->map.table[0]) & 0xff;
@@ -326,6 +459,7 @@ dispatch_loop:
                         } else {
                             PUSH(mp_load_global(MP_OBJ_QSTR_VALUE(key)));
                         }
+                        #endif
                     }
                     ip++;
                     DISPATCH();
@@ -563,6 +697,30 @@ dispatch_loop:
                     DISPATCH_WITH_PEND_EXC_CHECK();
                 }
 
+                ENTRY(MP_BC_BINARY_OP_POP_JUMP_IF): {
+                    MARK_EXC_IP_SELECTIVE();
+                    DECODE_SLABEL;
+                    mp_uint_t op = *ip & 0x7f;
+                    mp_obj_t rhs = POP();
+                    mp_obj_t lhs = POP();
+                    bool cond;
+                    #if MICROPY_OPT_VM_SMALL_INT
+                    if (op <= MP_BINARY_OP_NOT_EQUAL && MP_OBJ_IS_SMALL_INT(lhs) && MP_OBJ_IS_SMALL_INT(rhs)) {
+                        cond = vm_small_int_compare(op, MP_OBJ_SMALL_INT_VALUE(lhs), MP_OBJ_SMALL_INT_VALUE(rhs));
+                    } else
+                    #endif
+                    {
+                        cond = mp_obj_is_true(vm_binary_op(op, lhs, rhs));
+                    }
+                    // the offset is relative to the byte holding the op
+                    if (cond == (*ip >> 7)) {
+                        ip += slab;
+                    } else {
+                        ip += 1;
+                    }
+                    DISPATCH_WITH_PEND_EXC_CHECK();
+                }
+
                 ENTRY(MP_BC_JUMP_IF_TRUE_OR_POP): {
                     DECODE_SLABEL;
                     if (mp_obj_is_true(TOP())) {
@@ -952,7 +1110,9 @@ unwind_jump:;
                     // We have following stack layout here:
                     // fun arg0 arg1 ... kw0 val0 kw1 val1 ... seq dict <- TOS
                     sp -= (unum & 0xff) + ((unum >> 7) & 0x1fe) + 2;
-                    #if MICROPY_STACKLESS
+                    // With the pystack the args array lies below the new code
+                    // state and can't be freed first, so recurse on the C stack.
+                    #if MICROPY_STACKLESS && !MICROPY_ENABLE_PYSTACK
                     if (mp_obj_get_type(*sp) == &mp_type_fun_bc) {
                         code_state->ip = ip;
                         code_state->sp = sp;
@@ -963,7 +1123,7 @@ unwind_jump:;
 
                         mp_code_state_t *new_state = mp_obj_fun_bc_prepare_codestate(out_args.fun,
                             out_args.n_args, out_args.n_kw, out_args.args);
-                        m_del(mp_obj_t, out_args.args, out_args.n_alloc);
+                        mp_nonlocal_free(out_args.args, out_args.n_alloc * sizeof(mp_obj_t));
                         if (new_state) {
                             new_state->prev = code_state;
                             code_state = new_state;
@@ -1023,7 +1183,8 @@ unwind_jump:;
                     // We have following stack layout here:
                     // fun self arg0 arg1 ... kw0 val0 kw1 val1 ... seq dict <- TOS
                     sp -= (unum & 0xff) + ((unum >> 7) & 0x1fe) + 3;
-                    #if MICROPY_STACKLESS
+                    // See CALL_FUNCTION_VAR_KW for why pystack disables this.
+                    #if MICROPY_STACKLESS && !MICROPY_ENABLE_PYSTACK
                     if (mp_obj_get_type(*sp) == &mp_type_fun_bc) {
                         code_state->ip = ip;
                         code_state->sp = sp;
@@ -1034,7 +1195,7 @@ unwind_jump:;
 
                         mp_code_state_t *new_state = mp_obj_fun_bc_prepare_codestate(out_args.fun,
                             out_args.n_args, out_args.n_kw, out_args.args);
-                        m_del(mp_obj_t, out_args.args, out_args.n_alloc);
+                        mp_nonlocal_free(out_args.args, out_args.n_alloc * sizeof(mp_obj_t));
                         if (new_state) {
                             new_state->prev = code_state;
                             code_state = new_state;
@@ -1052,7 +1213,12 @@ unwind_jump:;
                     DISPATCH();
                 }
 
+                ENTRY(MP_BC_RETURN_NONE):
+                    PUSH(mp_const_none);
+                    goto return_value;
+
                 ENTRY(MP_BC_RETURN_VALUE):
+return_value:
                     MARK_EXC_IP_SELECTIVE();
                     // These next 3 lines pop a try-finally exception handler, if one
                     // is there on the exception stack.  Without this the finally block
@@ -1096,7 +1262,11 @@ unwind_return:
                     if (code_state->prev != NULL) {
                         mp_obj_t res = *sp;
                         mp_globals_set(code_state->old_globals);
-                        code_state = code_state->prev;
+                        mp_code_state_t *new_code_state = code_state->prev;
+                        #if MICROPY_ENABLE_PYSTACK
+                        mp_pystack_free(code_state);
+                        #endif
+                        code_state = new_code_state;
                         *code_state->sp = res;
                         goto run_code_state;
                     }
@@ -1236,7 +1406,7 @@ yield:
                     MARK_EXC_IP_SELECTIVE();
                     mp_obj_t rhs = POP();
                     mp_obj_t lhs = TOP();
-                    SET_TOP(mp_binary_op(ip[-1] - MP_BC_BINARY_OP_MULTI, lhs, rhs));
+                    SET_TOP(vm_binary_op(ip[-1] - MP_BC_BINARY_OP_MULTI, lhs, rhs));
                     DISPATCH();
                 }
 
@@ -1259,7 +1429,7 @@ yield:
                     } else if (ip[-1] < MP_BC_BINARY_OP_MULTI + 36) {
                         mp_obj_t rhs = POP();
                         mp_obj_t lhs = TOP();
-                        SET_TOP(mp_binary_op(ip[-1] - MP_BC_BINARY_OP_MULTI, lhs, rhs));
+                        SET_TOP(vm_binary_op(ip[-1] - MP_BC_BINARY_OP_MULTI, lhs, rhs));
                         DISPATCH();
                     } else
 #endif
@@ -1438,7 +1608,11 @@ unwind_loop:
             #if MICROPY_STACKLESS
             } else if (code_state->prev != NULL) {
                 mp_globals_set(code_state->old_globals);
-                code_state = code_state->prev;
+                mp_code_state_t *new_code_state = code_state->prev;
+                #if MICROPY_ENABLE_PYSTACK
+                mp_pystack_free(code_state);
+                #endif
+                code_state = new_code_state;
                 size_t n_state = mp_decode_uint_value(code_state->fun_bc->bytecode);
                 fastn = &code_state->state[n_state - 1];
                 exc_stack = (mp_exc_stack_t*)(code_state->state + n_state);
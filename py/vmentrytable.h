@@ -57,6 +57,8 @@ static const void *const entry_table[256] = {
     [MP_BC_DELETE_DEREF] = &&entry_MP_BC_DELETE_DEREF,
     [MP_BC_DELETE_NAME] = &&entry_MP_BC_DELETE_NAME,
     [MP_BC_DELETE_GLOBAL] = &&entry_MP_BC_DELETE_GLOBAL,
+    [MP_BC_LOAD_FAST_PAIR] = &&entry_MP_BC_LOAD_FAST_PAIR,
+    [MP_BC_LOAD_FAST_INT_OP] = &&entry_MP_BC_LOAD_FAST_INT_OP,
     [MP_BC_DUP_TOP] = &&entry_MP_BC_DUP_TOP,
     [MP_BC_DUP_TOP_TWO] = &&entry_MP_BC_DUP_TOP_TWO,
     [MP_BC_POP_TOP] = &&entry_MP_BC_POP_TOP,
@@ -75,6 +77,7 @@ static const void *const entry_table[256] = {
     [MP_BC_END_FINALLY] = &&entry_MP_BC_END_FINALLY,
     [MP_BC_GET_ITER] = &&entry_MP_BC_GET_ITER,
     [MP_BC_GET_ITER_STACK] = &&entry_MP_BC_GET_ITER_STACK,
+    [MP_BC_BINARY_OP_POP_JUMP_IF] = &&entry_MP_BC_BINARY_OP_POP_JUMP_IF,
     [MP_BC_FOR_ITER] = &&entry_MP_BC_FOR_ITER,
     [MP_BC_POP_BLOCK] = &&entry_MP_BC_POP_BLOCK,
     [MP_BC_POP_EXCEPT] = &&entry_MP_BC_POP_EXCEPT,
@@ -100,6 +103,7 @@ static const void *const entry_table[256] = {
     [MP_BC_CALL_METHOD] = &&entry_MP_BC_CALL_METHOD,
     [MP_BC_CALL_METHOD_VAR_KW] = &&entry_MP_BC_CALL_METHOD_VAR_KW,
     [MP_BC_RETURN_VALUE] = &&entry_MP_BC_RETURN_VALUE,
+    [MP_BC_RETURN_NONE] = &&entry_MP_BC_RETURN_NONE,
     [MP_BC_RAISE_VARARGS] = &&entry_MP_BC_RAISE_VARARGS,
     [MP_BC_YIELD_VALUE] = &&entry_MP_BC_YIELD_VALUE,
     [MP_BC_YIELD_FROM] = &&entry_MP_BC_YIELD_FROM,
@@ -2,6 +2,12 @@
 
 import builtins
 
+def get_abs():
+    return abs
+
+# look it up once before overriding it
+get_abs()
+
 # override generic builtin
 try:
     builtins.abs = lambda x: x + 1
@@ -10,6 +16,7 @@ except AttributeError:
     raise SystemExit
 
 print(abs(1))
+print(get_abs()(1))
 
 # __build_class__ is handled in a special way
 builtins.__build_class__ = lambda x, y: ('class', y)
@@ -0,0 +1,25 @@
+# test that new objects which reuse the memory of small objects freed by a
+# collection are fully initialised
+
+try:
+    import gc
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+def garbage(n):
+    for i in range(n):
+        x = (i, i * 0.5)
+        y = [i].append
+        z = iter(x)
+
+garbage(500)
+gc.collect()
+objs = [(i, float(i), (i, i, i), [i]) for i in range(500)]
+print(all(o == (i, float(i), (i, i, i), [i]) for i, o in enumerate(objs)))
+
+# big objects can still be allocated
+garbage(500)
+gc.collect()
+b = [bytearray(1000) for i in range(10)]
+print(sum(len(x) for x in b), any(any(x) for x in b))
@@ -0,0 +1,48 @@
+# test that repeated global and builtin lookups see every change to them
+
+def get_len():
+    return len
+
+def get_x():
+    return x
+
+# a global shadowing a builtin, then removed again
+f = get_len()
+print(f is get_len())
+len = lambda x: -1
+print(get_len()([1, 2]))
+del len
+print(get_len()([1, 2]))
+
+# rebinding a global, including through globals()
+x = 1
+print(get_x())
+x = 2
+print(get_x())
+globals()['x'] = 3
+print(get_x())
+globals().update({'x': 4})
+print(get_x())
+del globals()['x']
+try:
+    get_x()
+except NameError:
+    print('NameError')
+globals().setdefault('x', 5)
+print(get_x())
+print(globals().pop('x'))
+try:
+    get_x()
+except NameError:
+    print('NameError')
+
+# adding enough globals to rehash the globals dict
+x = 6
+for i in range(50):
+    globals()['g%d' % i] = i
+print(get_x(), g49)
+
+# the same code with different globals
+code = compile('y + abs(-1)', '<string>', 'eval')
+print(eval(code, {'y': 10}), eval(code, {'y': 20}))
+print(eval(code, {'y': 30, 'abs': lambda v: 0}))
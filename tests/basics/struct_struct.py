@@ -0,0 +1,57 @@
+# test ustruct.Struct
+
+try:
+    import ustruct as struct
+except:
+    try:
+        import struct
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+try:
+    struct.Struct
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+s = struct.Struct('<BHI2s')
+print(s.size, s.format)
+b = s.pack(1, 0x203, 0x4050607, b'xy')
+print(b)
+print(s.unpack(b))
+print(s.unpack_from(b'..' + b, 2))
+print(s.unpack_from(b + b'..', -len(b) - 2))
+
+# pack_into at an offset
+buf = bytearray(12)
+s.pack_into(buf, 2, 0xff, 0xffff, 0xffffffff, b'z')
+print(buf)
+s.pack_into(buf, -s.size, 1, 2, 3, b'abc')
+print(buf)
+
+# native alignment, counts and big-endian
+for fmt in ('bhi', '>2h3sb', '!I', '3B', '0s', 'hhb'):
+    s = struct.Struct(fmt)
+    print(fmt, s.size, s.size == struct.calcsize(fmt))
+    v = struct.unpack(fmt, bytes(range(s.size)))
+    print(s.unpack(bytes(range(s.size))) == v, s.pack(*v) == struct.pack(fmt, *v))
+
+# iter_unpack
+s = struct.Struct('>hB')
+print(list(s.iter_unpack(b'\x00\x01\x02\xff\xfe\x03')))
+print(list(s.iter_unpack(b'')))
+try:
+    s.iter_unpack(b'\x00\x01')
+except Exception:
+    print('Exception')
+
+# buffer too small
+try:
+    s.unpack_from(b'\x00\x01\x02', 1)
+except Exception:
+    print('Exception')
+try:
+    s.pack_into(bytearray(4), 2, 1, 2)
+except Exception:
+    print('Exception')
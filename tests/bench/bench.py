@@ -1,10 +1,31 @@
-import time
+try:
+    import utime as time
+except ImportError:
+    import time
+try:
+    import micropython
+except ImportError:
+    micropython = None
 
 
 ITERS = 20000000
 
 def run(f):
-    t = time.time()
-    f(ITERS)
-    t = time.time() - t
+    if micropython is not None and hasattr(micropython, 'mem_allocs'):
+        mem = (micropython.mem_total(), micropython.mem_allocs())
+    else:
+        mem = None
+    if hasattr(time, 'ticks_us'):
+        t = time.ticks_us()
+        f(ITERS)
+        t = time.ticks_diff(time.ticks_us(), t) / 1000000
+    else:
+        t = time.time()
+        f(ITERS)
+        t = time.time() - t
     print(t)
+    # memory used by the run, if the port keeps statistics: the peak heap use,
+    # and the number of bytes allocated and of allocations
+    if mem is not None:
+        print('mem', micropython.mem_peak(), micropython.mem_total() - mem[0],
+            micropython.mem_allocs() - mem[1])
@@ -0,0 +1,10 @@
+import bench
+import ubinascii
+
+# Base64-encode a 6KiB blob, e.g. a small JPEG for a JSON API
+def test(num):
+    buf = bytes(range(256)) * 24
+    for i in range(num // 4000):
+        ubinascii.b2a_base64(buf)
+
+bench.run(test)
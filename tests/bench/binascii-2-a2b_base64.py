@@ -0,0 +1,10 @@
+import bench
+import ubinascii
+
+# Decode 8KiB of base64 text
+def test(num):
+    text = ubinascii.b2a_base64(bytes(range(256)) * 24)
+    for i in range(num // 4000):
+        ubinascii.a2b_base64(text)
+
+bench.run(test)
@@ -0,0 +1,10 @@
+import bench
+import ubinascii
+
+# Hex-encode and decode a 4KiB buffer
+def test(num):
+    buf = bytes(range(256)) * 16
+    for i in range(num // 4000):
+        ubinascii.unhexlify(ubinascii.hexlify(buf))
+
+bench.run(test)
@@ -0,0 +1,11 @@
+import bench
+import ubinascii
+
+# Base64-encode a 6KiB blob into a preallocated buffer
+def test(num):
+    buf = bytes(range(256)) * 24
+    out = bytearray(8200)
+    for i in range(num // 4000):
+        ubinascii.b2a_base64_into(buf, out)
+
+bench.run(test)
@@ -0,0 +1,11 @@
+import bench
+import ubinascii
+
+# CRC of a 4KiB buffer, e.g. a flash page
+def test(num):
+    buf = bytes(range(256)) * 16
+    crc = 0
+    for i in range(num // 2000):
+        crc = ubinascii.crc32c(buf, crc)
+
+bench.run(test)
@@ -0,0 +1,10 @@
+import bench
+
+def test(num):
+    # every intermediate result is a new heap-allocated float
+    x = 0.5
+    y = 0.0
+    for i in iter(range(num // 20)):
+        y = y * 0.999 + x * 1.5 - 0.25
+
+bench.run(test)
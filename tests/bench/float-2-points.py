@@ -0,0 +1,11 @@
+import bench
+
+def test(num):
+    # small tuples of floats, which die straight away
+    x = 0.0
+    y = 0.0
+    for i in iter(range(num // 40)):
+        p = (x + 1.0, y - 1.0)
+        x, y = p[1] * 0.5, p[0] * 0.5
+
+bench.run(test)
@@ -0,0 +1,19 @@
+import bench
+
+def test(num):
+    # escape-time counts over a grid of points in the complex plane
+    size = int((num // 300) ** 0.5)
+    step = 3.0 / size
+    total = 0
+    for j in range(size):
+        ci = j * step - 1.5
+        for i in range(size):
+            cr = i * step - 2.0
+            zr = zi = 0.0
+            n = 0
+            while n < 20 and zr * zr + zi * zi < 4.0:
+                zr, zi = zr * zr - zi * zi + cr, 2.0 * zr * zi + ci
+                n += 1
+            total += n
+
+bench.run(test)
@@ -0,0 +1,15 @@
+import bench
+
+def test(num):
+    # 16-tap FIR filter over a sampled sine wave
+    taps = [0.5 / (k + 1) for k in range(16)]
+    signal = [((i * 37) % 100) / 50.0 - 1.0 for i in range(256)]
+    out = [0.0] * len(signal)
+    for loop in range(num // 40000):
+        for i in range(len(taps), len(signal)):
+            acc = 0.0
+            for k in range(len(taps)):
+                acc += taps[k] * signal[i - k]
+            out[i] = acc
+
+bench.run(test)
@@ -0,0 +1,23 @@
+import bench
+
+def matmul(a, b, n):
+    c = [[0.0] * n for i in range(n)]
+    for i in range(n):
+        ai = a[i]
+        ci = c[i]
+        for j in range(n):
+            s = 0.0
+            for k in range(n):
+                s += ai[k] * b[k][j]
+            ci[j] = s
+    return c
+
+def test(num):
+    # repeated products of two dense 16x16 matrices
+    n = 16
+    a = [[(i + j) * 0.25 for j in range(n)] for i in range(n)]
+    b = [[(i - j) * 0.5 for j in range(n)] for i in range(n)]
+    for loop in range(num // 60000):
+        matmul(a, b, n)
+
+bench.run(test)
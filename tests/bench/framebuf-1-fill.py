@@ -0,0 +1,13 @@
+import bench
+import framebuf
+
+# Fill rectangles on a 128x64 MONO_VLSB display (e.g. SSD1306), not aligned
+# to 8-pixel pages
+def test(num):
+    buf = bytearray(128 * 64 // 8)
+    fbuf = framebuf.FrameBuffer(buf, 128, 64, framebuf.MONO_VLSB)
+    for i in range(num // 2000):
+        fbuf.fill_rect(3, 5, 120, 50, i & 1)
+        fbuf.fill_rect(0, 0, 128, 64, 0)
+
+bench.run(test)
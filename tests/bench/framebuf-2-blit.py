@@ -0,0 +1,16 @@
+import bench
+import framebuf
+
+# Blit a 64x64 RGB565 sprite onto a 320x240 RGB565 screen, without a key
+# colour, then a 32x32 MONO_HLSB icon with a key colour
+def test(num):
+    screen = framebuf.FrameBuffer(bytearray(320 * 240 * 2), 320, 240, framebuf.RGB565)
+    sprite = framebuf.FrameBuffer(bytearray(64 * 64 * 2), 64, 64, framebuf.RGB565)
+    sprite.fill(0x1234)
+    icon = framebuf.FrameBuffer(bytearray(32 * 32 // 8), 32, 32, framebuf.MONO_HLSB)
+    icon.fill_rect(8, 8, 16, 16, 1)
+    for i in range(num // 2000):
+        screen.blit(sprite, i % 256, 100)
+        screen.blit(icon, 17, i % 200, 0)
+
+bench.run(test)
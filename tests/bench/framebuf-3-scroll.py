@@ -0,0 +1,13 @@
+import bench
+import framebuf
+
+# Scroll a full 320x240 RGB565 screen up by one line, and a 128x64 MONO_HLSB
+# screen left by one pixel
+def test(num):
+    screen = framebuf.FrameBuffer(bytearray(320 * 240 * 2), 320, 240, framebuf.RGB565)
+    mono = framebuf.FrameBuffer(bytearray(128 * 64 // 8), 128, 64, framebuf.MONO_HLSB)
+    for i in range(num // 20000):
+        screen.scroll(0, -1)
+        mono.scroll(-1, 0)
+
+bench.run(test)
@@ -0,0 +1,12 @@
+import bench
+import framebuf
+
+# Draw lines of text on a 128x64 MONO_VLSB display, on and off page boundaries
+def test(num):
+    fbuf = framebuf.FrameBuffer(bytearray(128 * 64 // 8), 128, 64, framebuf.MONO_VLSB)
+    for i in range(num // 2000):
+        fbuf.text('Hello, world! 0123', 0, 8, 1)
+        fbuf.text('Hello, world! 0123', 0, 21, 1)
+        fbuf.text('Hello, world! 0123', 0, 21, 0)
+
+bench.run(test)
@@ -0,0 +1,25 @@
+# Function call overhead test, with the code compiled at opt_level(1) so
+# that the bytecode optimisations apply (LOAD_FAST_PAIR for "x + y",
+# RETURN_NONE for the implicit return, folded constant expressions)
+import bench
+import micropython
+
+micropython.opt_level(1)
+exec("""
+def f(x, y):
+    return x + y
+
+def g(x):
+    x[0] = 2 ** 3
+
+def test(num):
+    f_ = f
+    g_ = g
+    l = [0]
+    for i in iter(range(num // 2)):
+        a = f_(i, 1)
+        g_(l)
+""")
+micropython.opt_level(0)
+
+bench.run(test)
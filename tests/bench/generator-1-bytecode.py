@@ -0,0 +1,11 @@
+import bench
+
+def gen(n):
+    for i in range(n):
+        yield i
+
+def test(num):
+    for i in gen(num):
+        pass
+
+bench.run(test)
@@ -0,0 +1,32 @@
+import bench
+import sys
+import uos
+
+# Import a generated ~40k source module from the filesystem, which goes
+# through the port's file reader (POSIX on unix, VFS on bare-metal ports).
+
+MOD = "bench_import_mod"
+
+def gen():
+    with open(MOD + ".py", "w") as f:
+        for i in range(400):
+            f.write("def f%d(a, b=%d):\n    # pad the source out with a comment\n    return a + b * %d\n\n" % (i, i, i))
+
+def test(num):
+    for i in range(num // 400000):
+        __import__(MOD)
+        del sys.modules[MOD]
+
+# the module is written to the current directory, which isn't on the path
+# when a script is run
+gen()
+sys.path.insert(0, "")
+try:
+    bench.run(test)
+finally:
+    sys.path.pop(0)
+    try:
+        uos.remove(MOD + ".py")
+    except AttributeError:
+        # unix port's uos only has unlink()
+        uos.unlink(MOD + ".py")
@@ -0,0 +1,67 @@
+import bench
+import sys
+try:
+    import uos_vfs as uos
+    open = uos.vfs_open
+except ImportError:
+    import uos
+
+# Import the same generated module as import-1-source from a VfsFat on a RAM
+# block device, which goes through the VFS reader.  Ports whose imports don't
+# go through the VFS (like unix) skip this test.
+
+MOD = "bench_import_mod"
+
+class RAMFS:
+
+    SEC_SIZE = 512
+
+    def __init__(self, blocks):
+        self.data = bytearray(blocks * self.SEC_SIZE)
+
+    def readblocks(self, n, buf):
+        start = n * self.SEC_SIZE
+        buf[:] = self.data[start:start + len(buf)]
+
+    def writeblocks(self, n, buf):
+        start = n * self.SEC_SIZE
+        self.data[start:start + len(buf)] = buf
+
+    def ioctl(self, op, arg):
+        if op == 4:  # BP_IOCTL_SEC_COUNT
+            return len(self.data) // self.SEC_SIZE
+        if op == 5:  # BP_IOCTL_SEC_SIZE
+            return self.SEC_SIZE
+
+def gen():
+    with open("/ramdisk/" + MOD + ".py", "w") as f:
+        for i in range(400):
+            f.write("def f%d(a, b=%d):\n    # pad the source out with a comment\n    return a + b * %d\n\n" % (i, i, i))
+
+def test(num):
+    for i in range(num // 400000):
+        __import__(MOD)
+        del sys.modules[MOD]
+
+try:
+    uos.VfsFat
+    bdev = RAMFS(200)
+except (AttributeError, MemoryError):
+    print("SKIP")
+    raise SystemExit
+
+uos.VfsFat.mkfs(bdev)
+uos.mount(uos.VfsFat(bdev), "/ramdisk")
+sys.path.insert(0, "/ramdisk")
+try:
+    gen()
+    try:
+        __import__(MOD)
+        del sys.modules[MOD]
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+    bench.run(test)
+finally:
+    sys.path.pop(0)
+    uos.umount("/ramdisk")
@@ -0,0 +1,20 @@
+# Counting loop with a branch, compiled at opt_level(1) so that the jump out
+# of the "if" arm is threaded straight to the top of the loop and the pair
+# of local loads in "a + b" is fused
+import bench
+import micropython
+
+micropython.opt_level(1)
+exec("""
+def test(num):
+    a = 0
+    b = 0
+    for i in range(num):
+        if i & 1:
+            a += 1
+        else:
+            b = a + b
+""")
+micropython.opt_level(0)
+
+bench.run(test)
@@ -0,0 +1,15 @@
+# loop_count-3-while_up compiled at opt_level(1): "i < num" and the jump
+# become one instruction, as does "i + 1"
+import bench
+import micropython
+
+micropython.opt_level(1)
+exec("""
+def test(num):
+    i = 0
+    while i < num:
+        i += 1
+""")
+micropython.opt_level(0)
+
+bench.run(test)
@@ -0,0 +1,11 @@
+import bench
+import ustruct
+
+# Decode a buffer of 12-byte records with the module-level function
+def test(num):
+    buf = bytes(range(240)) * 10
+    for i in range(num // 4000):
+        for off in range(0, len(buf), 12):
+            ustruct.unpack_from('<HHIf', buf, off)
+
+bench.run(test)
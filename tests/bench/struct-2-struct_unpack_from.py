@@ -0,0 +1,12 @@
+import bench
+import ustruct
+
+# Decode a buffer of 12-byte records with a precompiled Struct
+def test(num):
+    buf = bytes(range(240)) * 10
+    s = ustruct.Struct('<HHIf')
+    for i in range(num // 4000):
+        for off in range(0, len(buf), 12):
+            s.unpack_from(buf, off)
+
+bench.run(test)
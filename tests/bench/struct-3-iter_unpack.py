@@ -0,0 +1,14 @@
+import bench
+import ustruct
+
+# Decode a buffer of 12-byte records with Struct.iter_unpack, unpacking each
+# record into the same list so that no tuples are allocated
+def test(num):
+    buf = bytes(range(240)) * 10
+    s = ustruct.Struct('<HHIf')
+    out = []
+    for i in range(num // 4000):
+        for r in s.iter_unpack(buf, out):
+            pass
+
+bench.run(test)
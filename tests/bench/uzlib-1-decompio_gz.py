@@ -0,0 +1,79 @@
+import bench
+import ubinascii
+import uio
+import uzlib
+
+# Build a ~2MB gzip stream in memory, as a single fixed-Huffman block made of
+# rounds of 1024 literals followed by 60 back-references to them, then time
+# decompressing it through DecompIO.
+
+def rev(code, n):
+    r = 0
+    for i in range(n):
+        r = r << 1 | code & 1
+        code >>= 1
+    return r
+
+class BitWriter:
+    def __init__(self):
+        self.out = bytearray()
+        self.acc = 0
+        self.n = 0
+
+    def put(self, v, n):
+        self.acc |= v << self.n
+        self.n += n
+        while self.n >= 8:
+            self.out.append(self.acc & 0xff)
+            self.acc >>= 8
+            self.n -= 8
+
+def make_gzip(rounds):
+    lit = [(rev(0x30 + c, 8), 8) if c < 144 else (rev(0x190 + c - 144, 9), 9) for c in range(256)]
+    match = (rev(0xc5, 8), rev(19, 5), 1024 - 769) # length 258, distance 1024
+    text = bytearray(1024)
+    seed = 1
+    for i in range(len(text)):
+        seed = (seed * 1103515245 + 12345) & 0x7fffffff
+        text[i] = seed >> 16 & 0xff if i & 3 == 0 else 97 + (seed >> 16) % 26
+    w = BitWriter()
+    w.out.extend(b'\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff')
+    w.put(0b011, 3) # final block, fixed Huffman codes
+    crc = 0
+    size = 0
+    for r in range(rounds):
+        text[r % len(text)] ^= 0x55
+        for c in text:
+            w.put(lit[c][0], lit[c][1])
+        for i in range(60):
+            w.put(match[0], 8)
+            w.put(match[1], 5)
+            w.put(match[2], 8)
+        # the matches repeat the text periodically
+        out = bytes(text) * 17
+        out = out[:len(text) + 258 * 60]
+        crc = ubinascii.crc32(out, crc)
+        size += len(out)
+    w.put(0, 7) # end of block
+    w.put(0, 7) # flush
+    for v in (crc, size):
+        w.out.extend(bytes((v >> s) & 0xff for s in (0, 8, 16, 24)))
+    return w.out, crc, size
+
+gz, crc, size = make_gzip(128)
+
+def test(num):
+    for i in range(num // 10000000 + 1):
+        d = uzlib.DecompIO(uio.BytesIO(gz), 16 + 10)
+        buf = bytearray(4096)
+        c = 0
+        n = 0
+        while True:
+            m = d.readinto(buf)
+            if not m:
+                break
+            c = ubinascii.crc32(memoryview(buf)[:m], c)
+            n += m
+        assert c == crc and n == size
+
+bench.run(test)
@@ -0,0 +1,9 @@
+import bench
+
+def test(num):
+    for i in iter(range(num // 20)):
+        len; len; len; len; len; len; len; len; len; len
+        isinstance; isinstance; isinstance; isinstance; isinstance
+        range; range; range; range; range
+
+bench.run(test)
@@ -0,0 +1,14 @@
+import bench
+
+@micropython.viper
+def memcpy(dest:ptr8, src:ptr8, n:int):
+    for i in range(n):
+        dest[i] = src[i]
+
+def test(num):
+    src = bytearray(i & 0xff for i in range(4096))
+    dest = bytearray(len(src))
+    for i in range(num // 2000):
+        memcpy(dest, src, len(src))
+
+bench.run(test)
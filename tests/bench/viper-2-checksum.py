@@ -0,0 +1,19 @@
+import bench
+
+@micropython.viper
+def checksum(buf:ptr8, n:int) -> int:
+    a = 1
+    b = 0
+    i = 0
+    while i < n:
+        a = (a + buf[i]) & 0xffff
+        b = (b + a) & 0xffff
+        i += 1
+    return (b << 16) | a
+
+def test(num):
+    buf = bytearray(i & 0xff for i in range(4096))
+    for i in range(num // 2000):
+        checksum(buf, len(buf))
+
+bench.run(test)
@@ -0,0 +1,15 @@
+import bench
+
+@micropython.viper
+def fill(buf:ptr16, w:int, h:int, col:int):
+    for y in range(h):
+        p = y * w
+        for x in range(w):
+            buf[p + x] = col
+
+def test(num):
+    buf = bytearray(2 * 64 * 64)
+    for i in range(num // 2000):
+        fill(buf, 64, 64, 0xf800)
+
+bench.run(test)
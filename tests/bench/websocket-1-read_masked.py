@@ -0,0 +1,23 @@
+import bench
+import uio
+import websocket
+
+# Read a stream of masked 4k binary frames, as received by a server from a
+# client; the payload is unmasked in place in the destination buffer.
+
+data = bytes(range(256)) * 16
+mask = b'\x12\x34\x56\x78'
+frame = b'\x82\xfe\x10\x00' + mask + bytes(data[i] ^ mask[i & 3] for i in range(len(data)))
+frames = frame * 16
+
+def test(num):
+    buf = bytearray(len(data))
+    for i in range(num // 20000):
+        ws = websocket.websocket(uio.BytesIO(frames))
+        for j in range(16):
+            n = 0
+            while n < len(buf):
+                n += ws.readinto(memoryview(buf)[n:])
+    assert buf == data
+
+bench.run(test)
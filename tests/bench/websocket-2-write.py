@@ -0,0 +1,18 @@
+import bench
+import uio
+import websocket
+
+# Write a mix of small and large text frames to an in-memory stream.
+
+small = b'x' * 40
+large = b'y' * 2000
+
+def test(num):
+    for i in range(num // 4000):
+        s = uio.BytesIO()
+        ws = websocket.websocket(s)
+        for j in range(16):
+            ws.write(small)
+            ws.write(large)
+
+bench.run(test)
@@ -0,0 +1,100 @@
+# test btree batches, the write-ahead log, get_into() and cursors
+try:
+    import btree
+    import uio
+    import ustruct
+    import uerrno
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+f = uio.BytesIO()
+wal = uio.BytesIO()
+db = btree.open(f, pagesize=512, wal=wal)
+
+# changes in a batch are only applied at the end of the with block, but
+# lookups inside the block see them
+with db.batch():
+    db[b"key1"] = b"val1"
+    db.put(b"key2", b"val2")
+    db[b"key3"] = b"old3"
+    db[b"key3"] = b"val3"
+    print(db.get(b"key1"), db[b"key2"], db.get(b"key3"), b"key3" in db, db.get(b"key4"))
+    # scans of the database would miss the changes, so they're an error
+    for scan in (lambda: list(db), lambda: list(db.items()), lambda: list(db.cursor())):
+        try:
+            scan()
+        except ValueError:
+            print("ValueError")
+print(db[b"key1"], db[b"key2"], db[b"key3"])
+
+# deletes are batched too, and a missing key is not an error
+with db.batch():
+    del db[b"key2"]
+    del db[b"missing"]
+    print(b"key2" in db, db.get(b"key2"), db.get(b"key1"))
+print(b"key2" in db)
+
+# a batch is discarded if an exception is raised
+try:
+    with db.batch():
+        db[b"key4"] = b"val4"
+        raise ValueError
+except ValueError:
+    pass
+print(b"key4" in db)
+
+# batches can't be nested
+with db.batch():
+    try:
+        db.batch()
+    except ValueError:
+        print("ValueError")
+
+# the log is cleared once a batch has been applied
+print(wal.getvalue()[:4])
+
+# get_into
+buf = bytearray(8)
+print(db.get_into(b"key1", buf), buf[:4])
+print(db.get_into(b"key1", bytearray(2)))
+print(db.get_into(b"missing", buf))
+
+# cursors reuse the buffers they return
+for i in range(5):
+    db[b"pre%d" % i] = b"x" * i
+db[b"prf"] = b"y"
+c = db.cursor(prefix=b"pre")
+items = [(bytes(k), bytes(v)) for k, v in c]
+print(items)
+print([bytes(k) for k, v in db.cursor(b"key", b"pre1", btree.INCL)])
+print([bytes(k) for k, v in db.cursor(None, None, btree.DESC)])
+try:
+    db.cursor(None, None, btree.DESC, prefix=b"pre")
+except ValueError:
+    print("ValueError")
+
+db.close()
+
+# a log holding a complete batch is applied when the database is opened
+def fnv(data):
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xffffffff
+    return h
+
+ops = ustruct.pack("II", 4, 4) + b"key5val5" + ustruct.pack("II", 4, 0xffffffff) + b"key1"
+wal = uio.BytesIO(ustruct.pack("IIII", 0x4c415742, 2, len(ops), fnv(ops)) + ops)
+db = btree.open(f, pagesize=512, wal=wal)
+print(db.get(b"key5"), db.get(b"key1"))
+print(wal.getvalue()[:4])
+db.close()
+
+# a log whose operations don't fill exactly the length in the header is
+# rejected, even if its checksum matches
+for n_ops, ops in ((3, ops), (1, ops), (1, ustruct.pack("II", 4, 1000) + b"key6")):
+    wal = uio.BytesIO(ustruct.pack("IIII", 0x4c415742, n_ops, len(ops), fnv(ops)) + ops)
+    try:
+        btree.open(f, pagesize=512, wal=wal)
+    except OSError as e:
+        print("OSError", e.args[0] == uerrno.EIO)
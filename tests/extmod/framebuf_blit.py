@@ -0,0 +1,54 @@
+# test blit between formats, blit within a framebuffer, and scroll edge cases
+try:
+    import framebuf
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+def printpixels(fbuf, w, h):
+    for y in range(h):
+        print(''.join('%x' % fbuf.pixel(x, y) for x in range(w)))
+
+def pattern(fbuf, w, h, mod):
+    for y in range(h):
+        for x in range(w):
+            fbuf.pixel(x, y, (x * 3 + y * 5) % mod)
+
+FORMATS = (
+    ('MONO_VLSB', framebuf.MONO_VLSB, lambda w, h: w * ((h + 7) // 8), 2),
+    ('MONO_HLSB', framebuf.MONO_HLSB, lambda w, h: (w + 7) // 8 * h, 2),
+    ('MONO_HMSB', framebuf.MONO_HMSB, lambda w, h: (w + 7) // 8 * h, 2),
+    ('GS4_HMSB', framebuf.GS4_HMSB, lambda w, h: (w + 1) // 2 * h, 16),
+    ('RGB565', framebuf.RGB565, lambda w, h: w * h * 2, 16),
+)
+
+w, h = 11, 10
+
+# blit from every format to every other, without and with a key
+src_w, src_h = 5, 9
+for sname, sfmt, ssize, smod in FORMATS:
+    src = framebuf.FrameBuffer(bytearray(ssize(src_w, src_h)), src_w, src_h, sfmt)
+    pattern(src, src_w, src_h, smod)
+    for dname, dfmt, dsize, dmod in FORMATS:
+        print(sname, '->', dname)
+        fbuf = framebuf.FrameBuffer(bytearray(dsize(w, h)), w, h, dfmt)
+        fbuf.blit(src, 1, -3)
+        fbuf.blit(src, 7, 5, 0)
+        printpixels(fbuf, w, h)
+
+# blit within the same framebuffer, where source and destination overlap
+for name, fmt, size, mod in FORMATS:
+    print(name)
+    for x, y in ((3, 2), (-2, -1), (1, 0), (-9, 0), (0, 1), (0, -3)):
+        fbuf = framebuf.FrameBuffer(bytearray(size(w, h)), w, h, fmt)
+        pattern(fbuf, w, h, mod)
+        fbuf.blit(fbuf, x, y)
+        printpixels(fbuf, w, h)
+
+# scrolling by the size of the framebuffer or more does nothing
+fbuf = framebuf.FrameBuffer(bytearray(w * h * 2), w, h, framebuf.RGB565)
+pattern(fbuf, w, h, 16)
+fbuf.scroll(w, 0)
+fbuf.scroll(0, -h - 1)
+fbuf.scroll(100, 100)
+printpixels(fbuf, w, h)
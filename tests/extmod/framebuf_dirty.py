@@ -0,0 +1,53 @@
+# test FrameBuffer dirty-region tracking
+try:
+    import framebuf
+    framebuf.FrameBuffer.track_dirty
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+w, h = 30, 20
+fbuf = framebuf.FrameBuffer(bytearray(w * ((h + 7) // 8)), w, h, framebuf.MONO_VLSB)
+
+# not tracking
+print(list(fbuf.dirty()))
+
+# everything starts dirty, tiles at the edges are clipped
+fbuf.track_dirty(8, 8)
+print(list(fbuf.dirty()))
+fbuf.clear_dirty()
+print(list(fbuf.dirty()))
+
+# each drawing primitive marks the tiles it touches
+def test(name, *args):
+    getattr(fbuf, name)(*args)
+    print(name, list(fbuf.dirty()))
+    fbuf.clear_dirty()
+
+test('pixel', 9, 9, 1)
+test('pixel', 9, 9)
+test('pixel', 40, 9, 1)
+test('hline', 5, 17, 12, 1)
+test('vline', 29, -5, 100, 1)
+test('rect', 6, 6, 4, 4, 1)
+test('fill_rect', -10, -10, 18, 11, 1)
+test('line', 0, 0, 20, 3, 1)
+test('text', 'ab', 12, 12, 1)
+test('text', 'x', -7, -7, 1)
+test('scroll', 24, 0)
+test('fill', 0)
+test('mark_dirty', 25, 17, 1, 1)
+
+src = framebuf.FrameBuffer(bytearray(10 * 2 * 2), 10, 2, framebuf.RGB565)
+test('blit', src, 14, 6)
+test('blit', src, -5, 18, 0)
+
+# non-square tiles, a single tile, and stopping tracking
+fbuf.track_dirty(16, 4)
+fbuf.clear_dirty()
+test('pixel', 20, 11, 1)
+fbuf.track_dirty(100)
+print(list(fbuf.dirty()))
+fbuf.track_dirty(0)
+fbuf.fill(1)
+print(list(fbuf.dirty()))
@@ -0,0 +1,23 @@
+try:
+    import ubinascii as binascii
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+try:
+    binascii.crc32c
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+print(hex(binascii.crc32c(b'123456789')))
+print(hex(binascii.crc32c(b'')))
+print(hex(binascii.crc32c(b'\x00' * 32)))
+print(hex(binascii.crc32c(b'\xff' * 32)))
+print(hex(binascii.crc32c(bytes(range(32)))))
+print(hex(binascii.crc32c(bytes(range(256)) * 3)))
+
+# incremental
+print(hex(binascii.crc32c(b'56789', binascii.crc32c(b'1234'))))
+print(hex(binascii.crc32c(bytes(range(16, 32)), binascii.crc32c(bytes(range(16))))))
+print(hex(binascii.crc32c(bytearray(range(100)), 0xffffffff)))
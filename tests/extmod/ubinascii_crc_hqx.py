@@ -0,0 +1,25 @@
+try:
+    try:
+        import ubinascii as binascii
+    except ImportError:
+        import binascii
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+try:
+    binascii.crc_hqx
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+print(hex(binascii.crc_hqx(b'123456789', 0)))
+print(hex(binascii.crc_hqx(b'123456789', 0xffff)))
+print(hex(binascii.crc_hqx(b'', 0x1234)))
+print(hex(binascii.crc_hqx(b'\x00' * 32, 0)))
+print(hex(binascii.crc_hqx(b'\xff' * 32, 0xffff)))
+print(hex(binascii.crc_hqx(bytes(range(256)) * 3, 0x1d0f)))
+
+# incremental
+print(hex(binascii.crc_hqx(b'56789', binascii.crc_hqx(b'1234', 0xffff))))
+print(hex(binascii.crc_hqx(bytes(range(16, 32)), binascii.crc_hqx(bytes(range(16)), 0))))
@@ -0,0 +1,74 @@
+try:
+    import ubinascii as binascii
+    import uio as io
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+try:
+    binascii.b2a_base64_into
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+data = bytes(range(40))
+
+# encode into a preallocated buffer
+buf = bytearray(80)
+n = binascii.hexlify_into(data[:5], buf)
+print(n, buf[:n])
+n = binascii.hexlify_into(data[:5], buf, ':')
+print(n, buf[:n])
+print(binascii.hexlify_into(b'', buf))
+n = binascii.hexlify_into(data, buf)
+print(n, bytes(buf) == binascii.hexlify(data))
+
+for l in range(5):
+    n = binascii.b2a_base64_into(data[:l], buf)
+    print(n, buf[:n])
+n = binascii.b2a_base64_into(data, buf)
+print(buf[:n] == binascii.b2a_base64(data))
+
+# into part of a larger buffer
+buf = bytearray(b'-' * 12)
+binascii.b2a_base64_into(b'abc', memoryview(buf)[4:])
+print(buf)
+
+# buffer too small
+for f in (binascii.hexlify_into, binascii.b2a_base64_into):
+    try:
+        f(b'abcd', bytearray(7))
+    except ValueError:
+        print('ValueError')
+
+# streaming encoder, with writes of various sizes split across groups
+for sizes in ((40,), (1, 1, 1, 37), (2, 2, 35, 1), (5, 0, 7, 28)):
+    s = io.BytesIO()
+    enc = binascii.Base64Encoder(s)
+    pos = 0
+    for sz in sizes:
+        print(enc.write(data[pos:pos + sz]), end=' ')
+        pos += sz
+    enc.close()
+    enc.close()
+    print(s.getvalue() + b'\n' == binascii.b2a_base64(data))
+
+# output larger than the internal chunk
+big = bytes(range(256)) * 5
+s = io.BytesIO()
+enc = binascii.Base64Encoder(s)
+enc.write(big)
+enc.write(big[:1])
+enc.close()
+print(s.getvalue() + b'\n' == binascii.b2a_base64(big + big[:1]))
+
+# nothing written
+s = io.BytesIO()
+enc = binascii.Base64Encoder(s)
+enc.close()
+print(s.getvalue())
+
+# write after close
+try:
+    enc.write(b'a')
+except OSError:
+    print('OSError')
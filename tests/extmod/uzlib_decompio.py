@@ -31,3 +31,10 @@ try:
     print(inp.read())
 except OSError as e:
     print(repr(e))
+
+# a source stream that can't seek is read a byte at a time, so the data
+# following the compressed data is left in it
+src = zlib.DecompIO(io.BytesIO(b'x\x9c;\xedq\xf6\xe4Iv\x86\x92\xc4\xcc\x1c\x00"\xeb\x05$'))
+inp = zlib.DecompIO(src, -8)
+print(inp.read())
+print(src.read())
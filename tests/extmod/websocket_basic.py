@@ -58,3 +58,35 @@ try:
     ws.ioctl(-1)
 except OSError as e:
     print("ioctl: EINVAL:", e.args[0] == uerrno.EINVAL)
+
+# masked payloads read in chunks of various sizes and alignments
+def mask_data(data, mask):
+    return bytes(data[i] ^ mask[i & 3] for i in range(len(data)))
+data = bytes(range(256)) * 2
+frame = b'\x82\xfe\x02\x00mask' + mask_data(data, b'mask')
+for sz in (1, 3, 8, 13, 100, 512):
+    ws = websocket.websocket(uio.BytesIO(frame))
+    buf = bytearray(600)
+    out = b''
+    while len(out) < len(data):
+        n = ws.readinto(memoryview(buf)[len(out) & 7:(len(out) & 7) + sz])
+        out += buf[len(out) & 7:(len(out) & 7) + n]
+    print(sz, out == data)
+
+# 64-bit payload length
+print(ws_read(b'\x81\x7f\x00\x00\x00\x00\x00\x00\x00\x04ping', 4))
+print(ws_read(b'\x81\xff\x00\x00\x00\x00\x00\x00\x00\x04mask' + mask_data(b'ping', b'mask'), 4))
+try:
+    ws_read(b'\x81\x7f\x00\x00\x00\x01\x00\x00\x00\x04ping', 4)
+except OSError as e:
+    print("OSError")
+
+# writes of payloads around the size where the header is no longer coalesced,
+# and of a payload needing a 64-bit length
+for n in (127, 128, 129, 1000, 70000):
+    s = uio.BytesIO()
+    ws = websocket.websocket(s)
+    print(ws.write(bytes(n)))
+    s.seek(0)
+    out = s.read()
+    print(len(out), out[:10])
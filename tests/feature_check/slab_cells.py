@@ -0,0 +1,8 @@
+# check if the GC keeps slab free lists, which adds a line to mem_info()
+try:
+    import micropython
+    micropython.mem_info
+except (ImportError, AttributeError):
+    print('no')
+    raise SystemExit
+micropython.mem_info()
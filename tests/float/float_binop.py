@@ -0,0 +1,26 @@
+# test binary operations on a float and a float or int, including the
+# in-place forms and the cases that need the generic path
+
+x = 2.5
+for y in (0.5, -4.0, 4, -2, 0.0, 0, True):
+    print(x + y, x - y, x * y, x < y, x > y, x <= y, x >= y, x == y, x != y)
+    try:
+        print(x / y)
+    except ZeroDivisionError:
+        print('ZeroDivisionError')
+    z = x
+    z += y
+    z -= 0.25
+    z *= 2
+    print(z)
+
+# ops that aren't on the fast path
+print(7.5 // 2, 7.5 % 2, 2.0 ** 3, divmod(7.5, 2.0))
+
+# an int on the left
+print(3 + 0.5, 3 - 0.5, 3 * 0.5, 3 / 0.5, 3 < 0.5)
+
+# special values
+inf = float('inf')
+nan = float('nan')
+print(inf + 1, inf - inf, inf > 1e30, nan < 1.0, nan >= 1.0, -inf < 0)
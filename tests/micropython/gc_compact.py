@@ -0,0 +1,98 @@
+# test gc.compact, which moves the storage of lists, bytearrays, arrays and
+# dicts into holes in the heap
+import gc
+
+try:
+    gc.compact
+except AttributeError:
+    print('SKIP')
+    raise SystemExit
+
+try:
+    import array
+except ImportError:
+    array = None
+
+# make holes in the heap, below the storage of the objects that are kept
+garbage = []
+keep = []
+for i in range(50):
+    garbage.append(bytearray(300))
+    keep.append([i] * 20)
+    keep.append(bytearray(range(i, i + 40)))
+    keep.append({j: i for j in range(10)})
+    if array:
+        keep.append(array.array('i', range(i, i + 30)))
+garbage = None
+
+# storage which is also referenced from elsewhere is not moved
+ba = bytearray(b'abc' * 10)
+mv = memoryview(ba)
+
+n = gc.compact()
+print(type(n), n >= 0)
+
+# all objects still have their contents
+ok = True
+for o in keep:
+    if isinstance(o, list):
+        i = o[0]
+        ok = ok and o == [i] * 20
+    elif isinstance(o, bytearray):
+        i = o[0]
+        ok = ok and o == bytearray(range(i, i + 40))
+    elif isinstance(o, dict):
+        i = o[0]
+        ok = ok and o == {j: i for j in range(10)}
+    else:
+        i = o[0]
+        ok = ok and list(o) == list(range(i, i + 30))
+print(ok)
+
+# objects can still grow after being moved
+for o in keep:
+    if isinstance(o, list):
+        o.append(1)
+    elif isinstance(o, dict):
+        o['new'] = 1
+print(sum(len(o) for o in keep if isinstance(o, list)))
+
+ba[0] = ord('x')
+print(mv[0] == ord('x'))
+
+# compacting again is fine
+print(gc.compact() >= 0)
+
+# fill the heap with storage of lists between bytearrays, then free the
+# bytearrays so that the free memory is in holes too small for a big allocation
+# (memory is kept in reserve to run the test after the heap is full)
+keep = ba = mv = None
+gc.collect()
+n = (gc.mem_free() + gc.mem_alloc()) // 512
+lists = [[] for i in range(n)]
+garbage = [None] * n
+reserve = bytearray(16384)
+i = 0
+try:
+    while i < n:
+        garbage[i] = bytearray(300)
+        lists[i].extend(range(i, i + 30))
+        i += 1
+except MemoryError:
+    pass
+reserve = None
+for j in range(i):
+    garbage[j] = None
+gc.collect()
+try:
+    big = bytearray(65536)
+    print('big allocated before compacting')
+except MemoryError:
+    print('MemoryError')
+
+# after compaction the storage of the lists fills the holes, so the big
+# allocation succeeds, and the moved storage still has its contents
+print(gc.compact() >= 65536)
+big = bytearray(65536)
+print(len(big))
+print(all(lists[j] == list(range(j, j + 30)) for j in range(i)))
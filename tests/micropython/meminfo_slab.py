@@ -0,0 +1,13 @@
+# test that mem_info reports the slab free lists, which a collection fills
+# with the cells of unreachable small objects
+
+import gc
+import micropython
+
+# make plenty of unreachable 1- and 2-block objects
+for i in range(1000):
+    x = [i]
+    x = {i: i}
+
+gc.collect()
+micropython.mem_info()
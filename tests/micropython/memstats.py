@@ -9,9 +9,13 @@ else:
     t = micropython.mem_total()
     c = micropython.mem_current()
     p = micropython.mem_peak()
+    a = micropython.mem_allocs()
 
     l = list(range(10000))
+    a2 = micropython.mem_allocs()
+    s = [str(i) for i in range(10)]
 
     print(micropython.mem_total() > t)
     print(micropython.mem_current() > c)
     print(micropython.mem_peak() > p)
+    print(a2 > a, micropython.mem_allocs() - a2 >= 10)
@@ -0,0 +1,102 @@
+# test native emitter can handle generators correctly
+
+# simple generator with a loop
+@micropython.native
+def gen1(x):
+    for i in range(x):
+        yield i
+print(list(gen1(3)))
+
+# locals and stack values are preserved across a yield
+@micropython.native
+def gen2(a, b, c, d):
+    e = a + b
+    x = [(yield a), (yield b), e]
+    print(x, c, d, e)
+    return c + d
+g = gen2(1, 2, 3, 4)
+print(next(g), g.send(5))
+try:
+    g.send(6)
+except StopIteration as er:
+    print('StopIteration', er.args)
+
+# sending a non-None value to a just-started generator
+try:
+    gen2(1, 2, 3, 4).send(1)
+except TypeError:
+    print('TypeError')
+
+# exceptions thrown in and handled across yields
+@micropython.native
+def gen3():
+    try:
+        yield 1
+        try:
+            yield 2
+        except KeyError:
+            print('KeyError')
+            yield 3
+        yield 4
+    except ValueError as er:
+        print('ValueError', er.args)
+        yield 5
+    finally:
+        print('finally')
+g = gen3()
+print(next(g), next(g), g.throw(KeyError), g.throw(ValueError(6)))
+try:
+    next(g)
+except StopIteration:
+    print('StopIteration')
+
+# closing a generator inside a try and a with
+class CtxMgr:
+    def __enter__(self):
+        print('enter')
+        return self
+    def __exit__(self, a, b, c):
+        print('exit', a)
+@micropython.native
+def gen4():
+    with CtxMgr():
+        try:
+            yield 1
+        finally:
+            print('finally')
+g = gen4()
+print(next(g))
+g.close()
+
+# yield from a generator and from other iterables
+@micropython.native
+def gen5():
+    r = yield from gen2(1, 2, 3, 4)
+    print('returned', r)
+    yield from (5, 6)
+g = gen5()
+print(next(g), g.send(7), g.send(8), next(g))
+
+# throw into a generator via yield from
+g = gen5()
+next(g)
+try:
+    g.throw(ValueError)
+except ValueError:
+    print('ValueError')
+
+# an exception escaping a generator
+@micropython.native
+def gen6():
+    yield 1
+    raise IndexError
+try:
+    list(gen6())
+except IndexError:
+    print('IndexError')
+
+# a generator expression in a native function
+@micropython.native
+def f(x):
+    return sum(i * i for i in range(x))
+print(f(4))
@@ -0,0 +1,178 @@
+# test the bytecode optimisations enabled by opt_level(1)
+import micropython as micropython
+
+micropython.opt_level(1)
+
+# dead code after return/raise, and a bare return in a generator
+exec('''
+def f(x):
+    if x:
+        return 1
+        print('dead')
+    else:
+        raise ValueError(x)
+        print('dead')
+    print('dead')
+print(f(1))
+try:
+    f(0)
+except ValueError as er:
+    print('ValueError', er)
+
+def g():
+    return
+    yield 1
+print(list(g()))
+''')
+
+# jump threading through nested loops, break and continue
+exec('''
+def f(n):
+    out = []
+    for i in range(n):
+        while True:
+            if i & 1:
+                break
+            else:
+                out.append(i)
+                break
+        else:
+            out.append(-1)
+        if i > 5:
+            continue
+    return out
+print(f(8))
+''')
+
+# pairs of locals, including an unbound one
+exec('''
+def f(a, b):
+    return a + b, b - a
+print(f(2, 5))
+
+def g(a):
+    if a:
+        b = 1
+    return a + b
+print(g(1))
+try:
+    g(0)
+except NameError:
+    print('NameError')
+''')
+
+# implicit and explicit return None, and discarded constants
+exec('''
+def f():
+    None
+    True
+    123
+def g():
+    return None
+print(f(), g())
+''')
+
+# extended constant folding
+exec('''
+print(2 ** 10, (-3) ** 3, -2 ** 2, 1 ** 1000, (-1) ** 1001, 0 ** 0, 2 ** 100)
+print(1 < 2, 2 < 1, 3 == 3, 3 != 3, 4 >= 5, 4 <= 5, 1 < 2 < 3)
+print('abc'[0], 'abc'[-1], b'xyz'[1], (1, 2, 3)[1], [None, True][-1], ('a', 'b')[0], (4,)[-1])
+print([x for x in (5, 6)][1], (1, 2, 3, 4)[-4])
+try:
+    'abc'[5]
+except IndexError:
+    print('IndexError')
+''')
+
+# constant subscripts used as store, delete and augmented-assignment targets
+# are not folded
+exec('''
+[1, 2][0] = 5
+del [1, 2][0]
+[1, 2][1] += 3
+for [1, 2][0] in range(2):
+    pass
+print('ok')
+for stmt in ("b'123'[1] = 4", "'a'[0] = 1", "(1, 2)[0] = 3", "del 'abc'[0]", "(1, 2)[0] += 1"):
+    try:
+        exec(stmt)
+    except TypeError:
+        print('TypeError')
+''')
+
+# fused local/small-int ops and compare-and-jump, with small ints, at the
+# edges of the small-int range, and with other types
+exec('''
+class A:
+    def __init__(self, x):
+        self.x = x
+    def __iadd__(self, other):
+        self.x += other
+        return self
+    def __lt__(self, other):
+        return self.x < other
+
+def f(a):
+    r = []
+    r.append(a + 1)
+    r.append(a - 16)
+    r.append(a * 47)
+    r.append(a // 3)
+    r.append(a % 3)
+    r.append(a & 6)
+    r.append(a | 1)
+    r.append(a >> 2)
+    r.append(a < 5)
+    r.append(a == 5)
+    r.append(a != 5)
+    r.append(a >= 5)
+    return r
+
+for a in (5, -7, 0x3fffffff, -0x40000000, 0x3fffffffffffffff, 2 ** 100, -2 ** 100):
+    print(f(a))
+
+def fl(a):
+    return a + 1, a - 16, a * 47, a // 3, a % 3, a < 5, a == 2.5
+print(fl(2.5))
+
+def g(a, b):
+    a += 1
+    if a < b:
+        return 'lt'
+    elif a == b:
+        return 'eq'
+    if b is None:
+        return 'none'
+    return 'gt'
+print(g(1, 3), g(2, 3), g(3, 3), g(1, 0), g(1.5, 2.5))
+x = A(1)
+print(g(x, 5), x.x)
+try:
+    g('a', 1)
+except TypeError:
+    print('TypeError')
+
+def h(a):
+    if a:
+        b = 1
+    return b + 1
+try:
+    h(0)
+except NameError:
+    print('NameError')
+
+def z(a):
+    return a // 0
+try:
+    z(1)
+except ZeroDivisionError:
+    print('ZeroDivisionError')
+
+def app(a):
+    a += [1]
+    return a
+l = [0]
+print(app(l) is l, l)
+''')
+
+micropython.opt_level(0)
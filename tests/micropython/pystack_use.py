@@ -0,0 +1,40 @@
+# tests pystack_use function in micropython module, and that the pystack
+# is unwound correctly by returns and exceptions
+import micropython
+
+if not hasattr(micropython, 'pystack_use'):
+    print('SKIP')
+    raise SystemExit
+
+def f(n, *args):
+    if n == 0:
+        raise ValueError(len(args))
+    return f(n - 1, *(args + (n,)))
+
+def g(n):
+    if n == 0:
+        return micropython.pystack_use()
+    return g(n - 1)
+
+base = micropython.pystack_use()
+print(type(base))
+
+# usage grows with the call depth
+print(g(10) > g(1) > base)
+
+# exceptions unwind the pystack
+for i in range(3):
+    try:
+        f(20)
+    except ValueError as er:
+        print(er)
+    print(micropython.pystack_use() == base)
+
+# deep recursion runs out of pystack and recovers
+def h():
+    h()
+try:
+    h()
+except RuntimeError:
+    print('RuntimeError')
+print(micropython.pystack_use() == base)
@@ -0,0 +1,29 @@
+# test MicroPython-specific features of ustruct.Struct
+
+try:
+    import ustruct as struct
+    struct.Struct
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+s = struct.Struct('<HB')
+
+# unpack into an existing list, which is resized as needed
+out = []
+print(s.unpack_from(b'\x01\x02\x03', 0, out), out)
+print(s.unpack_from(b'\x00\x04\x05\x06', 1, out) is out, out)
+out = [0, 0, 0, 0]
+print(s.unpack_from(b'\x01\x02\x03', 0, out))
+try:
+    s.unpack_from(b'\x01\x02\x03', 0, ())
+except TypeError:
+    print('TypeError')
+
+# iter_unpack yielding the same list each time
+out = []
+for r in s.iter_unpack(b'\x01\x00\x02\x03\x00\x04', out):
+    print(r is out, r)
+
+# pack can accept fewer arguments than required
+print(s.pack(0x102))
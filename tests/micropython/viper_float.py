@@ -0,0 +1,89 @@
+# test the viper float type
+try:
+    import array
+    float
+except (ImportError, NameError):
+    print("SKIP")
+    raise SystemExit
+
+# arguments, return values and arithmetic
+@micropython.viper
+def arith(x:float, y:float) -> float:
+    return (x + y) * (x - y) / y
+
+print(arith(3.5, 0.5))
+
+# int operands are promoted
+@micropython.viper
+def promote(x:float, i:int) -> float:
+    return x * 2 + i
+
+print(promote(1.25, 3))
+
+# negation and constants
+@micropython.viper
+def neg(x:float) -> float:
+    return -x + 0.5
+
+print(neg(2.0), neg(-2.0))
+
+# comparisons, including NaN
+@micropython.viper
+def comp(x:float, y:float):
+    return (x < y, x > y, x == y, x <= y, x >= y, x != y)
+
+print(comp(1.0, 2.0))
+print(comp(2.0, 2.0))
+nan = float("nan")
+print(comp(nan, 1.0))
+print(comp(1.0, nan))
+
+# casts between int, float and object
+@micropython.viper
+def cast(i:int, o) -> int:
+    f = float(i) + float(o)
+    return int(f)
+
+print(cast(7, 2.75), cast(-7, -2.75), cast(1, 2))
+
+# boxing into a container
+@micropython.viper
+def box(x:float):
+    return [x, x * x]
+
+print(box(1.5))
+
+# loads and stores through a float32 pointer
+@micropython.viper
+def scale(buf:ptrf32, n:int, k:float):
+    for i in range(n):
+        buf[i] = buf[i] * k
+    buf[0] = buf[1]
+
+a = array.array("f", [1.0, 2.0, 0.5, -4.0])
+scale(a, len(a), 2.0)
+print(a)
+
+@micropython.viper
+def dot(a_in, b_in) -> float:
+    a = ptrf32(a_in)
+    b = ptrf32(b_in)
+    n = int(len(a_in))
+    s = 0.0
+    for i in range(n):
+        s += a[i] * b[i]
+    return s
+
+print(dot(array.array("f", [1, 2, 3]), array.array("f", [4, 5, 6])))
+
+# the range counter must survive loads through a float32 pointer that use it
+@micropython.viper
+def prefix(buf:ptrf32, out:ptrf32, n:int):
+    s = 0.0
+    for i in range(n):
+        s += buf[i]
+        out[i] = s + float(i)
+
+out = array.array("f", [0, 0, 0, 0])
+prefix(array.array("f", [1.0, 2.0, 0.5, -4.0]), out, 4)
+print(out)
@@ -0,0 +1,82 @@
+# test viper functions with more locals than there are registers for them
+
+@micropython.viper
+def many(x:int, y:int) -> int:
+    a = x + 1
+    b = y + 2
+    c = a * b
+    d = c - x
+    e = d + y
+    f = e * 2
+    g = f + a + b + c + d + e
+    return g + x + y
+
+print(many(3, 4))
+
+# locals whose live ranges end can share registers
+@micropython.viper
+def reuse(n:int) -> int:
+    a = n * 2
+    b = a + 1
+    s = 0
+    for i in range(b):
+        s += i
+    t = 0
+    for j in range(a):
+        t += j * j
+    return s + t
+
+print(reuse(5))
+
+# a local defined before a loop and used in it stays live around the loop
+@micropython.viper
+def loop_live(n:int) -> int:
+    k = 3
+    acc = 0
+    i = 0
+    while i < n:
+        acc += k
+        if i == 2:
+            k = 10
+        i += 1
+    return acc
+
+print(loop_live(5))
+
+# pointers and counters in nested loops
+@micropython.viper
+def fill(buf:ptr8, w:int, h:int):
+    for y in range(h):
+        row = y * w
+        for x in range(w):
+            buf[row + x] = y * 16 + x
+
+b = bytearray(12)
+fill(b, 4, 3)
+print(b)
+
+@micropython.viper
+def copy(dest_in, src_in, n:int):
+    dest = ptr8(dest_in)
+    src = ptr8(src_in)
+    i = 0
+    while i < n:
+        dest[i] = src[n - 1 - i]
+        i += 1
+
+b2 = bytearray(12)
+copy(b2, b, 12)
+print(b2)
+
+@micropython.viper
+def sum32(buf:ptr32, n:int) -> int:
+    lo = 0
+    hi = 0
+    for i in range(n):
+        v = buf[i]
+        lo += v & 0xffff
+        hi += v >> 16
+    return (hi << 16) + lo
+
+import array
+print(hex(sum32(array.array('I', [0x10002, 0x30004, 0x50006]), 3)))
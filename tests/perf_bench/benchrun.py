@@ -0,0 +1,33 @@
+# Harness for the benchmarks in this directory.  run-perfbench appends this
+# file and a call to bm_run(N, M) to a benchmark and runs the result, either
+# as a script or through the raw REPL of a board.
+#
+# Each benchmark defines bm_params, a dict mapping (N, M) to the parameters
+# of a workload suited to a target with relative speed N (roughly its CPU
+# clock in MHz) and M KiB of heap, and bm_setup(params), which returns the
+# function to time and a function returning, once it has run, the amount of
+# work done and a result that must match the one from CPython.
+
+def bm_run(N, M):
+    try:
+        from utime import ticks_us, ticks_diff
+    except ImportError:
+        import time
+        ticks_us = lambda: int(time.perf_counter() * 1000000)
+        ticks_diff = lambda a, b: a - b
+
+    # pick the biggest workload that suits the target
+    best = None
+    for nm in bm_params:
+        if nm[0] <= N and nm[1] <= M and (best is None or nm > best):
+            best = nm
+    if best is None:
+        print(-1, -1, 'no matching params')
+        return
+
+    run, result = bm_setup(bm_params[best])
+    t0 = ticks_us()
+    run()
+    t1 = ticks_us()
+    norm, out = result()
+    print(ticks_diff(t1, t0), norm, out)
@@ -0,0 +1,38 @@
+# compiling a large generated module and running it
+
+def make_source(n_func):
+    lines = []
+    for i in range(n_func):
+        lines.append('def f%d(a, b=%d, *args, **kw):' % (i, i))
+        lines.append('    x = [a + b * j for j in range(3)]')
+        lines.append('    if a > %d:' % i)
+        lines.append('        return {"k": x, "n": len(args)}')
+        lines.append('    return sum(x) - %d' % i)
+        lines.append('class C%d:' % i)
+        lines.append('    def m(self, y):')
+        lines.append('        return f%d(y) + 1' % i)
+    lines.append('total = sum(C%d().m(1) for i in range(1))' % (n_func - 1))
+    return '\n'.join(lines) + '\n'
+
+def bm_setup(params):
+    n_func, n_loop = params
+    src = make_source(n_func)
+    state = [None]
+
+    def run():
+        for i in range(n_loop):
+            code = compile(src, 'generated', 'exec')
+        env = {}
+        exec(code, env)
+        state[0] = env['total']
+
+    def result():
+        return n_func * n_loop, (src.count('\n'), state[0])
+
+    return run, result
+
+bm_params = {
+    (50, 10): (3, 2),
+    (100, 10): (5, 5),
+    (1000, 100): (100, 20),
+}
@@ -0,0 +1,56 @@
+# raising and catching exceptions through a few levels of calls
+
+class ParseError(Exception):
+    pass
+
+def parse(s):
+    if not s.isdigit():
+        raise ParseError(s)
+    return int(s)
+
+def parse_all(items):
+    good = bad = 0
+    for s in items:
+        try:
+            good += parse(s)
+        except ParseError as er:
+            bad += len(er.args[0])
+        finally:
+            good += 1
+    return good, bad
+
+def nested(depth):
+    if depth == 0:
+        raise KeyError(depth)
+    try:
+        nested(depth - 1)
+    except ValueError:
+        pass
+
+def bm_setup(params):
+    n_loop = params[0]
+    items = ['12', 'x', '7', 'abc', '100', '']
+    state = [None]
+
+    def run():
+        good = bad = n_key = 0
+        for i in range(n_loop):
+            g, b = parse_all(items)
+            good += g
+            bad += b
+            try:
+                nested(4)
+            except KeyError:
+                n_key += 1
+        state[0] = (good, bad, n_key)
+
+    def result():
+        return n_loop, state[0]
+
+    return run, result
+
+bm_params = {
+    (50, 10): (200,),
+    (100, 10): (1000,),
+    (1000, 10): (20000,),
+}
@@ -0,0 +1,26 @@
+# building report lines with % and str.format
+
+def bm_setup(params):
+    n_line = params[0]
+    state = [None]
+
+    def run():
+        total = 0
+        line = ''
+        for i in range(n_line):
+            name = 'sensor%d' % (i % 10)
+            line = '%-10s %5d %8.2f' % (name, i, i * 0.5)
+            line += ' | {:>8} {:04x} {}'.format(name, i, i % 3 == 0)
+            total += len(line)
+        state[0] = (total, line)
+
+    def result():
+        return n_line, state[0]
+
+    return run, result
+
+bm_params = {
+    (50, 10): (500,),
+    (100, 10): (2000,),
+    (1000, 10): (20000,),
+}
@@ -0,0 +1,39 @@
+# pipelines of generators, including yield from
+
+def numbers(n):
+    for i in range(n):
+        yield i
+
+def evens(it):
+    for x in it:
+        if x % 2 == 0:
+            yield x
+
+def scaled(it, k):
+    yield from (x * k for x in it)
+
+def windows(it, size):
+    win = []
+    for x in it:
+        win.append(x)
+        if len(win) == size:
+            yield sum(win)
+            win.pop(0)
+
+def bm_setup(params):
+    n = params[0]
+    state = [None]
+
+    def run():
+        state[0] = sum(windows(scaled(evens(numbers(n)), 3), 4))
+
+    def result():
+        return n, state[0]
+
+    return run, result
+
+bm_params = {
+    (50, 10): (2000,),
+    (100, 10): (10000,),
+    (1000, 10): (400000,),
+}
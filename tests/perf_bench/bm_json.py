@@ -0,0 +1,34 @@
+# JSON round-trips of a list of small records
+
+try:
+    import ujson as json
+except ImportError:
+    import json
+
+def bm_setup(params):
+    n_record, n_loop = params
+    data = [{
+        'id': i,
+        'name': 'item%d' % i,
+        'price': i * 0.25,
+        'tags': ['a', 'b', str(i % 7)],
+        'ok': i % 2 == 0,
+        'ref': None,
+    } for i in range(n_record)]
+    state = [None]
+
+    def run():
+        for i in range(n_loop):
+            state[0] = json.loads(json.dumps(data))
+
+    def result():
+        out = state[0]
+        return n_record * n_loop, (len(out), out[-1]['name'], sum(r['id'] for r in out))
+
+    return run, result
+
+bm_params = {
+    (50, 10): (10, 20),
+    (100, 10): (10, 100),
+    (1000, 100): (100, 200),
+}
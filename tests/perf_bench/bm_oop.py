@@ -0,0 +1,58 @@
+# objects kept in dicts, with attribute access and method calls
+
+class Account:
+    def __init__(self, name, balance=0):
+        self.name = name
+        self.balance = balance
+        self.history = {}
+
+    def deposit(self, amount, ref):
+        self.balance += amount
+        self.history[ref & 31] = amount
+
+    def withdraw(self, amount, ref):
+        if amount > self.balance:
+            return False
+        self.balance -= amount
+        self.history[ref & 31] = -amount
+        return True
+
+class Bank:
+    def __init__(self):
+        self.accounts = {}
+
+    def open(self, name, balance):
+        self.accounts[name] = Account(name, balance=balance)
+
+    def transfer(self, src, dst, amount, ref):
+        if self.accounts[src].withdraw(amount, ref):
+            self.accounts[dst].deposit(amount, ref)
+            return True
+        return False
+
+def bm_setup(params):
+    n_account, n_transfer = params
+    state = [None]
+
+    def run():
+        bank = Bank()
+        for i in range(n_account):
+            bank.open('acc%d' % i, 100)
+        ok = 0
+        for i in range(n_transfer):
+            src = 'acc%d' % (i % n_account)
+            dst = 'acc%d' % ((i * 7 + 3) % n_account)
+            ok += bank.transfer(src, dst, i % 50, i)
+        state[0] = (ok, sum(a.balance for a in bank.accounts.values()),
+            max(len(a.history) for a in bank.accounts.values()))
+
+    def result():
+        return n_transfer, state[0]
+
+    return run, result
+
+bm_params = {
+    (50, 10): (10, 500),
+    (100, 10): (20, 2000),
+    (1000, 100): (100, 40000),
+}
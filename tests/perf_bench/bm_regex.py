@@ -0,0 +1,54 @@
+# tokenising source lines with regular expressions
+
+try:
+    import ure as re
+except ImportError:
+    import re
+
+TOKEN = re.compile('([0-9]+)|([A-Za-z_][A-Za-z_0-9]*)|( +)|(.)')
+
+LINES = (
+    'total = price * 12 + tax_rate * (price - discount)',
+    'if count > 100 and not done: result = lookup(key, 42)',
+    'for i in range(1000): acc += values[i] << 2',
+    'x1 = y2 / z3 - 77',
+)
+
+def tokenize(line):
+    n_num = n_name = n_op = 0
+    while line:
+        m = TOKEN.match(line)
+        tok = m.group(0)
+        if m.group(1):
+            n_num += 1
+        elif m.group(2):
+            n_name += 1
+        elif m.group(4):
+            n_op += 1
+        line = line[len(tok):]
+    return n_num, n_name, n_op
+
+def bm_setup(params):
+    n_loop = params[0]
+    state = [None]
+
+    def run():
+        counts = [0, 0, 0]
+        for i in range(n_loop):
+            for line in LINES:
+                c = tokenize(line)
+                counts[0] += c[0]
+                counts[1] += c[1]
+                counts[2] += c[2]
+        state[0] = counts
+
+    def result():
+        return n_loop * len(LINES), state[0]
+
+    return run, result
+
+bm_params = {
+    (50, 10): (20,),
+    (100, 10): (100,),
+    (1000, 10): (3000,),
+}
@@ -0,0 +1,36 @@
+# decoding fixed-size binary records with struct
+
+try:
+    import ustruct as struct
+except ImportError:
+    import struct
+
+FMT = '<HIhBB'
+
+def bm_setup(params):
+    n_record, n_loop = params
+    size = struct.calcsize(FMT)
+    buf = bytearray(size * n_record)
+    for i in range(n_record):
+        struct.pack_into(FMT, buf, i * size, i, i * 1000, -i, i & 0xff, 1)
+    state = [None]
+
+    def run():
+        for loop in range(n_loop):
+            total = 0
+            for off in range(0, len(buf), size):
+                rec_id, ts, delta, chan, flag = struct.unpack_from(FMT, buf, off)
+                if flag:
+                    total += ts + delta + chan
+            state[0] = total
+
+    def result():
+        return n_record * n_loop, state[0]
+
+    return run, result
+
+bm_params = {
+    (50, 10): (50, 10),
+    (100, 10): (100, 40),
+    (1000, 100): (1000, 400),
+}
@@ -0,0 +1,38 @@
+# stress test for many threads allocating small objects at the same time,
+# checking that no object is handed out twice or corrupted
+
+import gc
+import _thread
+try:
+    import utime as time
+except ImportError:
+    import time
+
+def thread_entry(n):
+    ok = True
+    for loop in range(20):
+        # objects of a few different sizes, each filled with its own data
+        data = [(n, i, [i] * (i % 5), bytearray(range(i % 3))) for i in range(100)]
+        for i in range(len(data)):
+            if data[i] != (n, i, [i] * (i % 5), bytearray(range(i % 3))):
+                ok = False
+        if loop % 5 == 0:
+            gc.collect()
+    with lock:
+        global n_ok, n_finished
+        n_ok += ok
+        n_finished += 1
+
+lock = _thread.allocate_lock()
+n_thread = 8
+n_ok = 0
+n_finished = 0
+
+for i in range(n_thread):
+    _thread.start_new_thread(thread_entry, (i,))
+
+# busy wait so the main thread also allocates
+while n_finished < n_thread:
+    [str(i) for i in range(10)]
+    time.sleep(0.001)
+print(n_ok == n_thread)
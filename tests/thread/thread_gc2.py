@@ -0,0 +1,45 @@
+# test that the garbage collector traces the stacks of many threads, which
+# are stopped while they are running, sleeping or waiting on a lock
+
+import gc
+import _thread
+try:
+    import utime as time
+except ImportError:
+    import time
+
+def thread_entry(n):
+    # keep some data alive only via the stack of this thread
+    data = [bytearray(range(i, i + 8)) for i in range(20)]
+    while not finish:
+        if n % 3 == 0:
+            time.sleep(0.001)
+        elif n % 3 == 1:
+            with lock:
+                pass
+        else:
+            [i for i in range(10)]
+    ok = all(data[i] == bytearray(range(i, i + 8)) for i in range(20))
+    with lock:
+        global n_ok, n_finished
+        n_ok += ok
+        n_finished += 1
+
+lock = _thread.allocate_lock()
+n_thread = 16
+n_ok = 0
+n_finished = 0
+finish = False
+
+for i in range(n_thread):
+    _thread.start_new_thread(thread_entry, (i,))
+
+# collect many times while the threads are running, creating garbage
+for i in range(50):
+    [bytearray(100) for j in range(10)]
+    gc.collect()
+
+finish = True
+while n_finished < n_thread:
+    time.sleep(0.01)
+print(n_ok == n_thread)
@@ -0,0 +1,40 @@
+# test that the garbage collector marks long chains of objects that are only
+# referenced from the stacks of other threads, which may overflow the mark
+# stacks when threads help to mark in parallel
+
+import gc
+import _thread
+
+def thread_entry(n):
+    # build a chain that's only referenced from this thread's stack
+    head = None
+    for i in range(n):
+        head = [head, i]
+
+    # allocate while the other threads collect, then check the chain
+    for i in range(10):
+        junk = [bytearray(32) for _ in range(20)]
+        gc.collect()
+    k = n
+    while head is not None:
+        k -= 1
+        if head[1] != k:
+            break
+        head = head[0]
+
+    with lock:
+        print(k == 0)
+        global n_finished
+        n_finished += 1
+
+lock = _thread.allocate_lock()
+n_thread = 6
+n_finished = 0
+
+# spawn threads
+for i in range(n_thread):
+    _thread.start_new_thread(thread_entry, (1000,))
+
+# busy wait for threads to finish
+while n_finished < n_thread:
+    pass
@@ -0,0 +1,38 @@
+# test that global lookups from several threads see the latest stores, while
+# other threads add and remove globals and so change the globals dict
+
+import _thread
+
+n_thread = 4
+
+# functions that load each global by name
+getters = [eval('lambda: g%d' % i) for i in range(n_thread)]
+
+def th(n, idx):
+    name = 'g%d' % idx
+    get = getters[idx]
+    for repeat in range(n):
+        globals()[name] = repeat
+        assert get() == repeat
+        assert abs(-repeat) == repeat
+        del globals()[name]
+        try:
+            get()
+            assert False
+        except NameError:
+            pass
+    with lock:
+        global n_finished
+        n_finished += 1
+
+lock = _thread.allocate_lock()
+n_finished = 0
+
+# spawn threads
+for i in range(n_thread):
+    _thread.start_new_thread(th, (200, i))
+
+# busy wait for threads to finish
+while n_finished < n_thread:
+    pass
+print(n_finished)
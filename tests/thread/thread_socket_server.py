@@ -0,0 +1,86 @@
+# test a threaded socket server, where a slow client must not stall the
+# other threads while its handler is blocked in recv()
+
+try:
+    import usocket as socket
+except ImportError:
+    try:
+        import socket
+    except ImportError:
+        print('SKIP')
+        raise SystemExit
+try:
+    import utime as time
+except ImportError:
+    import time
+import _thread
+
+PORT = 8731
+N_CLIENT = 8
+N_REQ = 20
+
+def handler(s):
+    # echo each request back in upper case until the client closes
+    while True:
+        data = s.recv(64)
+        if not data:
+            break
+        s.send(data.upper())
+    s.close()
+    with lock:
+        global n_handled
+        n_handled += 1
+
+def server(s):
+    for i in range(N_CLIENT + 1):
+        cl, addr = s.accept()
+        _thread.start_new_thread(handler, (cl,))
+    s.close()
+
+def client(n):
+    s = socket.socket()
+    s.connect(addr)
+    ok = True
+    for i in range(N_REQ):
+        msg = b'req%d-%d' % (n, i)
+        s.send(msg)
+        if s.recv(64) != msg.upper():
+            ok = False
+    s.close()
+    with lock:
+        global n_ok
+        n_ok += ok
+
+lock = _thread.allocate_lock()
+n_handled = 0
+n_ok = 0
+
+addr = socket.getaddrinfo('127.0.0.1', PORT)[0][-1]
+s = socket.socket()
+s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+s.bind(addr)
+s.listen(N_CLIENT + 1)
+_thread.start_new_thread(server, (s,))
+
+# the slow client connects first and then sends nothing, so its handler
+# blocks in recv() for the whole time the other clients are running
+slow = socket.socket()
+slow.connect(addr)
+
+for i in range(N_CLIENT):
+    _thread.start_new_thread(client, (i,))
+
+while True:
+    with lock:
+        if n_handled == N_CLIENT:
+            break
+    time.sleep(0.01)
+print(n_ok == N_CLIENT)
+
+# now let the slow client finish
+slow.send(b'bye')
+print(slow.recv(64))
+slow.close()
+while n_handled < N_CLIENT + 1:
+    time.sleep(0.01)
+print('done')
@@ -57,7 +57,7 @@ class FreezeError(Exception):
         return 'error while freezing %s: %s' % (self.rawcode.source_file, self.msg)
 
 class Config:
-    MPY_VERSION = 3
+    MPY_VERSION = 5
     MICROPY_LONGINT_IMPL_NONE = 0
     MICROPY_LONGINT_IMPL_LONGLONG = 1
     MICROPY_LONGINT_IMPL_MPZ = 2
@@ -72,6 +72,9 @@ MP_OPCODE_OFFSET = 3
 MP_BC_MAKE_CLOSURE = 0x62
 MP_BC_MAKE_CLOSURE_DEFARGS = 0x63
 MP_BC_RAISE_VARARGS = 0x5c
+MP_BC_LOAD_FAST_PAIR = 0x2c
+MP_BC_LOAD_FAST_INT_OP = 0x2d
+MP_BC_BINARY_OP_POP_JUMP_IF = 0x48
 # extra byte if caching enabled:
 MP_BC_LOAD_NAME = 0x1c
 MP_BC_LOAD_GLOBAL = 0x1d
@@ -99,19 +102,19 @@ def make_opcode_format():
     OC4(B, B, V, V), # 0x20-0x23
     OC4(Q, Q, Q, B), # 0x24-0x27
     OC4(V, V, Q, Q), # 0x28-0x2b
-    OC4(U, U, U, U), # 0x2c-0x2f
+    OC4(B, B, U, U), # 0x2c-0x2f
     OC4(B, B, B, B), # 0x30-0x33
     OC4(B, O, O, O), # 0x34-0x37
     OC4(O, O, U, U), # 0x38-0x3b
     OC4(U, O, B, O), # 0x3c-0x3f
     OC4(O, B, B, O), # 0x40-0x43
     OC4(B, B, O, B), # 0x44-0x47
-    OC4(U, U, U, U), # 0x48-0x4b
+    OC4(O, U, U, U), # 0x48-0x4b
     OC4(U, U, U, U), # 0x4c-0x4f
     OC4(V, V, U, V), # 0x50-0x53
     OC4(B, U, V, V), # 0x54-0x57
     OC4(V, V, V, B), # 0x58-0x5b
-    OC4(B, B, B, U), # 0x5c-0x5f
+    OC4(B, B, B, B), # 0x5c-0x5f
     OC4(V, V, V, V), # 0x60-0x63
     OC4(V, V, V, V), # 0x64-0x67
     OC4(Q, Q, B, U), # 0x68-0x6b
@@ -170,6 +173,8 @@ def mp_opcode_format(bytecode, ip, opcode_format=make_opcode_format()):
     else:
         extra_byte = (
             opcode == MP_BC_RAISE_VARARGS
+            or opcode == MP_BC_LOAD_FAST_PAIR
+            or opcode == MP_BC_BINARY_OP_POP_JUMP_IF
             or opcode == MP_BC_MAKE_CLOSURE
             or opcode == MP_BC_MAKE_CLOSURE_DEFARGS
             or config.MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE and (
@@ -179,6 +184,9 @@ def mp_opcode_format(bytecode, ip, opcode_format=make_opcode_format()):
                 or opcode == MP_BC_STORE_ATTR
             )
         )
+        if opcode == MP_BC_LOAD_FAST_INT_OP:
+            # local num and op, then the small int
+            extra_byte = 2
         ip += 1
         if f == MP_OPCODE_VAR_UINT:
             while bytecode[ip] & 0x80 != 0: